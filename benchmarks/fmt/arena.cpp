@@ -0,0 +1,96 @@
+import std;
+
+import lib2;
+
+// A request's worth of short formatted strings, built and then dropped
+// together, as a request handler would
+constexpr std::size_t strings_per_request {200};
+
+class format_heap final : public lib2::benchmarking::benchmark
+{
+public:
+    format_heap()
+        : lib2::benchmarking::benchmark{"lib2::format"} {}
+
+    void operator()() final
+    {
+        std::vector<std::string> strings;
+        strings.reserve(strings_per_request);
+        for (std::size_t i {0}; i < strings_per_request; ++i)
+        {
+            strings.push_back(lib2::format<"request {} field {}: {:.2f} (a value long enough to spill)">(i, i * 7, static_cast<double>(i) / 3));
+        }
+        lib2::benchmarking::do_not_optimize(strings);
+    }
+
+    std::size_t items_per_iteration() const noexcept final
+    {
+        return strings_per_request;
+    }
+};
+
+class format_arena final : public lib2::benchmarking::benchmark
+{
+public:
+    format_arena()
+        : lib2::benchmarking::benchmark{"lib2::format into monotonic_arena"} {}
+
+    void operator()() final
+    {
+        {
+            std::vector<lib2::arena_string, lib2::arena_allocator<lib2::arena_string>> strings {lib2::arena_allocator<lib2::arena_string>{&arena}};
+            strings.reserve(strings_per_request);
+            for (std::size_t i {0}; i < strings_per_request; ++i)
+            {
+                strings.push_back(lib2::format<"request {} field {}: {:.2f} (a value long enough to spill)">(std::allocator_arg, lib2::arena_allocator<char>{&arena}, i, i * 7, static_cast<double>(i) / 3));
+            }
+            lib2::benchmarking::do_not_optimize(strings);
+        }
+        arena.reset();
+    }
+
+    std::size_t items_per_iteration() const noexcept final
+    {
+        return strings_per_request;
+    }
+private:
+    lib2::monotonic_arena arena;
+};
+
+class format_pool final : public lib2::benchmarking::benchmark
+{
+public:
+    format_pool()
+        : lib2::benchmarking::benchmark{"lib2::format into thread_caching_pool"} {}
+
+    void operator()() final
+    {
+        std::vector<lib2::arena_string, lib2::arena_allocator<lib2::arena_string>> strings {lib2::arena_allocator<lib2::arena_string>{&pool}};
+        strings.reserve(strings_per_request);
+        for (std::size_t i {0}; i < strings_per_request; ++i)
+        {
+            strings.push_back(lib2::format<"request {} field {}: {:.2f} (a value long enough to spill)">(std::allocator_arg, lib2::arena_allocator<char>{&pool}, i, i * 7, static_cast<double>(i) / 3));
+        }
+        lib2::benchmarking::do_not_optimize(strings);
+    }
+
+    std::size_t items_per_iteration() const noexcept final
+    {
+        return strings_per_request;
+    }
+private:
+    lib2::thread_caching_pool pool;
+};
+
+int main(int argc, char** argv)
+{
+    lib2::benchmarking::benchmark_suite request_benchmarks;
+    request_benchmarks.add_benchmark<format_heap>();
+    request_benchmarks.add_benchmark<format_arena>();
+    request_benchmarks.add_benchmark<format_pool>();
+
+    lib2::benchmarking::benchmark_runner runner;
+    runner.add_suite("Formatting a request's strings", request_benchmarks);
+
+    return lib2::benchmarking::benchmark_main(runner, argc, argv);
+}
\ No newline at end of file
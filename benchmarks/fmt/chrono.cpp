@@ -0,0 +1,181 @@
+import std;
+
+import lib2;
+
+// Log-like timestamps: microseconds apart, so most fall in the same
+// second as the one before
+class timestamp_benchmark : public lib2::benchmarking::benchmark
+{
+public:
+    using lib2::benchmarking::benchmark::benchmark;
+
+    void setup() override
+    {
+        time = std::chrono::sys_time<std::chrono::microseconds>{std::chrono::seconds{1'700'000'000}};
+    }
+protected:
+    std::chrono::sys_time<std::chrono::microseconds> next_time() noexcept
+    {
+        time += std::chrono::microseconds{37};
+        return time;
+    }
+private:
+    std::chrono::sys_time<std::chrono::microseconds> time;
+};
+
+class format_timestamp final : public timestamp_benchmark
+{
+public:
+    format_timestamp()
+        : timestamp_benchmark{"std::format"} {}
+
+    void operator()()
+    {
+        const auto str {std::format("{:%F %T}", next_time())};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class lib2_format_timestamp final : public timestamp_benchmark
+{
+public:
+    lib2_format_timestamp()
+        : timestamp_benchmark{"lib2::format"} {}
+
+    void operator()()
+    {
+        const auto str {lib2::format<"{:%F %T}">(next_time())};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class lib2_format_to_timestamp final : public timestamp_benchmark
+{
+public:
+    lib2_format_to_timestamp()
+        : timestamp_benchmark{"lib2::format_to"} {}
+
+    void operator()()
+    {
+        lib2::ospanstream out {buf};
+        lib2::format_to<"{:%F %T}">(out, next_time());
+        lib2::benchmarking::do_not_optimize(buf);
+    }
+private:
+    std::byte buf[64];
+};
+
+class format_time_of_day final : public timestamp_benchmark
+{
+public:
+    format_time_of_day()
+        : timestamp_benchmark{"std::format"} {}
+
+    void operator()()
+    {
+        const auto str {std::format("{:%H:%M:%S}", next_time().time_since_epoch())};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class lib2_format_time_of_day final : public timestamp_benchmark
+{
+public:
+    lib2_format_time_of_day()
+        : timestamp_benchmark{"lib2::format"} {}
+
+    void operator()()
+    {
+        const auto str {lib2::format<"{:%H:%M:%S}">(next_time().time_since_epoch())};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+// Latency-like durations, as benchmark and trace output prints them
+class elapsed_benchmark : public lib2::benchmarking::benchmark
+{
+public:
+    using lib2::benchmarking::benchmark::benchmark;
+
+    void setup() override
+    {
+        std::mt19937_64 gen {42};
+        std::uniform_int_distribution<std::int64_t> dist {0, 100'000'000};
+        for (auto& val : values)
+        {
+            val = std::chrono::nanoseconds{dist(gen)};
+        }
+        next = 0;
+    }
+protected:
+    std::chrono::nanoseconds next_elapsed() noexcept
+    {
+        return values[next++ % values.size()];
+    }
+private:
+    std::array<std::chrono::nanoseconds, 4096> values;
+    std::size_t next {0};
+};
+
+class format_elapsed final : public elapsed_benchmark
+{
+public:
+    format_elapsed()
+        : elapsed_benchmark{"std::format"} {}
+
+    void operator()()
+    {
+        const auto str {std::format("{}", next_elapsed())};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class lib2_format_elapsed final : public elapsed_benchmark
+{
+public:
+    lib2_format_elapsed()
+        : elapsed_benchmark{"lib2::format"} {}
+
+    void operator()()
+    {
+        const auto str {lib2::format<"{}">(next_elapsed())};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class lib2_format_elapsed_auto final : public elapsed_benchmark
+{
+public:
+    lib2_format_elapsed_auto()
+        : elapsed_benchmark{"lib2::format auto"} {}
+
+    void operator()()
+    {
+        const auto str {lib2::format<"{:auto}">(next_elapsed())};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+int main(int argc, char** argv)
+{
+    lib2::benchmarking::benchmark_suite timestamp_benchmarks;
+    timestamp_benchmarks.add_benchmark<format_timestamp>();
+    timestamp_benchmarks.add_benchmark<lib2_format_timestamp>();
+    timestamp_benchmarks.add_benchmark<lib2_format_to_timestamp>();
+
+    lib2::benchmarking::benchmark_suite duration_benchmarks;
+    duration_benchmarks.add_benchmark<format_time_of_day>();
+    duration_benchmarks.add_benchmark<lib2_format_time_of_day>();
+
+    lib2::benchmarking::benchmark_suite elapsed_benchmarks;
+    elapsed_benchmarks.add_benchmark<format_elapsed>();
+    elapsed_benchmarks.add_benchmark<lib2_format_elapsed>();
+    elapsed_benchmarks.add_benchmark<lib2_format_elapsed_auto>();
+
+    lib2::benchmarking::benchmark_runner runner {{.min_time = std::chrono::seconds{5}, .count_events = true}};
+    runner.add_suite("Formatting a sys_time as %F %T", timestamp_benchmarks);
+    runner.add_suite("Formatting a duration as %H:%M:%S", duration_benchmarks);
+    runner.add_suite("Formatting a duration as a count and unit", elapsed_benchmarks);
+
+    return lib2::benchmarking::benchmark_main(runner, argc, argv);
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+import std;
+
+import lib2;
+
+// Telemetry-like values: readings with a few decimals, as logged metrics
+// and sensor data usually are
+class double_benchmark : public lib2::benchmarking::benchmark
+{
+public:
+    using lib2::benchmarking::benchmark::benchmark;
+
+    void setup() override
+    {
+        std::mt19937_64 gen {42};
+        std::uniform_int_distribution<std::int64_t> dist {-100'000'000, 100'000'000};
+        for (auto& val : values)
+        {
+            val = static_cast<double>(dist(gen)) / 1000.0;
+        }
+        next = 0;
+    }
+protected:
+    double get_double() noexcept
+    {
+        return values[next++ % values.size()];
+    }
+private:
+    std::array<double, 4096> values;
+    std::size_t next {0};
+};
+
+class to_chars_shortest final : public double_benchmark
+{
+public:
+    to_chars_shortest()
+        : double_benchmark{"std::to_chars"} {}
+
+    void operator()()
+    {
+        const auto result {std::to_chars(std::ranges::begin(buf), std::ranges::end(buf), get_double())};
+        lib2::benchmarking::do_not_optimize(result);
+    }
+private:
+    char buf[32];
+};
+
+class format_shortest final : public double_benchmark
+{
+public:
+    format_shortest()
+        : double_benchmark{"std::format"} {}
+
+    void operator()()
+    {
+        const auto str {std::format("{}", get_double())};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class lib2_format_shortest final : public double_benchmark
+{
+public:
+    lib2_format_shortest()
+        : double_benchmark{"lib2::format"} {}
+
+    void operator()()
+    {
+        const auto str {lib2::format<"{}">(get_double())};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class lib2_format_to_shortest final : public double_benchmark
+{
+public:
+    lib2_format_to_shortest()
+        : double_benchmark{"lib2::format_to"} {}
+
+    void operator()()
+    {
+        lib2::ospanstream out {buf};
+        lib2::format_to<"{}">(out, get_double());
+        lib2::benchmarking::do_not_optimize(buf);
+    }
+private:
+    std::byte buf[32];
+};
+
+class to_chars_fixed final : public double_benchmark
+{
+public:
+    to_chars_fixed()
+        : double_benchmark{"std::to_chars"} {}
+
+    void operator()()
+    {
+        const auto result {std::to_chars(std::ranges::begin(buf), std::ranges::end(buf), get_double(), std::chars_format::fixed, 3)};
+        lib2::benchmarking::do_not_optimize(result);
+    }
+private:
+    char buf[32];
+};
+
+class format_fixed final : public double_benchmark
+{
+public:
+    format_fixed()
+        : double_benchmark{"std::format"} {}
+
+    void operator()()
+    {
+        const auto str {std::format("{:.3f}", get_double())};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class lib2_format_fixed final : public double_benchmark
+{
+public:
+    lib2_format_fixed()
+        : double_benchmark{"lib2::format"} {}
+
+    void operator()()
+    {
+        const auto str {lib2::format<"{:.3f}">(get_double())};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class lib2_format_to_fixed final : public double_benchmark
+{
+public:
+    lib2_format_to_fixed()
+        : double_benchmark{"lib2::format_to"} {}
+
+    void operator()()
+    {
+        lib2::ospanstream out {buf};
+        lib2::format_to<"{:.3f}">(out, get_double());
+        lib2::benchmarking::do_not_optimize(buf);
+    }
+private:
+    std::byte buf[32];
+};
+
+int main(int argc, char** argv)
+{
+    // Each call takes tens of nanoseconds, so iterations are timed in
+    // batches and compared by their median
+    lib2::benchmarking::benchmark_suite shortest_benchmarks;
+    shortest_benchmarks.add_benchmark<to_chars_shortest>();
+    shortest_benchmarks.add_benchmark<format_shortest>();
+    shortest_benchmarks.add_benchmark<lib2_format_shortest>();
+    shortest_benchmarks.add_benchmark<lib2_format_to_shortest>();
+
+    lib2::benchmarking::benchmark_suite fixed_benchmarks;
+    fixed_benchmarks.add_benchmark<to_chars_fixed>();
+    fixed_benchmarks.add_benchmark<format_fixed>();
+    fixed_benchmarks.add_benchmark<lib2_format_fixed>();
+    fixed_benchmarks.add_benchmark<lib2_format_to_fixed>();
+
+    lib2::benchmarking::benchmark_runner runner {{.min_time = std::chrono::seconds{5}, .count_events = true}};
+    runner.add_suite("Shortest formatting of double", shortest_benchmarks);
+    runner.add_suite("Fixed formatting of double with precision 3", fixed_benchmarks);
+
+    return lib2::benchmarking::benchmark_main(runner, argc, argv);
+}
\ No newline at end of file
@@ -90,6 +90,67 @@ public:
     }
 };
 
+// Full range values, as counters and IDs are, rather than what
+// std::rand can produce
+template<class T>
+class full_range_benchmark : public lib2::benchmarking::benchmark
+{
+public:
+    using lib2::benchmarking::benchmark::benchmark;
+
+    void setup() override
+    {
+        std::mt19937_64 gen {42};
+        std::uniform_int_distribution<T> dist;
+        for (auto& val : values)
+        {
+            val = dist(gen);
+        }
+        next = 0;
+    }
+protected:
+    T get_int() noexcept
+    {
+        return values[next++ % values.size()];
+    }
+private:
+    std::array<T, 4096> values;
+    std::size_t next {0};
+};
+
+template<class T>
+class to_chars_full_int final : public full_range_benchmark<T>
+{
+public:
+    to_chars_full_int()
+        : full_range_benchmark<T>{"std::to_chars"} {}
+
+    void operator()()
+    {
+        const auto result {std::to_chars(std::ranges::begin(buf), std::ranges::end(buf), this->get_int())};
+        lib2::benchmarking::do_not_optimize(result);
+    }
+private:
+    char buf[24];
+};
+
+template<class T>
+class lib2_format_to_full_int final : public full_range_benchmark<T>
+{
+public:
+    lib2_format_to_full_int()
+        : full_range_benchmark<T>{"lib2::format_to"} {}
+
+    void operator()()
+    {
+        lib2::ospanstream out {buf};
+        lib2::format_to<"{}">(out, this->get_int());
+        lib2::benchmarking::do_not_optimize(buf);
+    }
+private:
+    std::byte buf[24];
+};
+
 int main()
 {
     const lib2::benchmarking::benchmarking_min_time ctx {std::chrono::seconds{5}};
@@ -140,6 +201,18 @@ int main()
     int64_benchmarks.add_benchmark<to_string_int<std::int64_t>>();
     int64_benchmarks.add_benchmark<lib2_format_int<std::int64_t>>();
     
+    lib2::benchmarking::benchmark_suite uint32_full_benchmarks;
+    uint32_full_benchmarks.add_benchmark<to_chars_full_int<std::uint32_t>>();
+    uint32_full_benchmarks.add_benchmark<lib2_format_to_full_int<std::uint32_t>>();
+
+    lib2::benchmarking::benchmark_suite uint64_full_benchmarks;
+    uint64_full_benchmarks.add_benchmark<to_chars_full_int<std::uint64_t>>();
+    uint64_full_benchmarks.add_benchmark<lib2_format_to_full_int<std::uint64_t>>();
+
+    lib2::benchmarking::benchmark_suite int64_full_benchmarks;
+    int64_full_benchmarks.add_benchmark<to_chars_full_int<std::int64_t>>();
+    int64_full_benchmarks.add_benchmark<lib2_format_to_full_int<std::int64_t>>();
+    
     lib2::print<"Default formatting of std::uint8:\n">();
     lib2::benchmarking::print_benchmarks(ctx, uint8_benchmarks);
 
@@ -163,4 +236,13 @@ int main()
 
     lib2::print<"\nDefault formatting of std::int64:\n">();
     lib2::benchmarking::print_benchmarks(ctx, int64_benchmarks);
+
+    lib2::print<"\nFull range formatting of std::uint32:\n">();
+    lib2::benchmarking::print_benchmarks(ctx, uint32_full_benchmarks);
+
+    lib2::print<"\nFull range formatting of std::uint64:\n">();
+    lib2::benchmarking::print_benchmarks(ctx, uint64_full_benchmarks);
+
+    lib2::print<"\nFull range formatting of std::int64:\n">();
+    lib2::benchmarking::print_benchmarks(ctx, int64_full_benchmarks);
 }
\ No newline at end of file
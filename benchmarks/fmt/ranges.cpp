@@ -0,0 +1,91 @@
+import std;
+
+import lib2;
+
+class int_vector_benchmark : public lib2::benchmarking::benchmark
+{
+public:
+    using lib2::benchmarking::benchmark::benchmark;
+
+    void setup() override
+    {
+        std::mt19937_64 gen {42};
+        std::uniform_int_distribution<int> dist {-1'000'000, 1'000'000};
+        values.resize(100'000);
+        for (auto& val : values)
+        {
+            val = dist(gen);
+        }
+    }
+protected:
+    std::vector<int> values;
+};
+
+class format_range final : public int_vector_benchmark
+{
+public:
+    format_range()
+        : int_vector_benchmark{"std::format"} {}
+
+    void operator()()
+    {
+        const auto str {std::format("{}", values)};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class lib2_format_range final : public int_vector_benchmark
+{
+public:
+    lib2_format_range()
+        : int_vector_benchmark{"lib2::format"} {}
+
+    void operator()()
+    {
+        const auto str {lib2::format<"{}">(values)};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class format_padded_range final : public int_vector_benchmark
+{
+public:
+    format_padded_range()
+        : int_vector_benchmark{"std::format"} {}
+
+    void operator()()
+    {
+        const auto str {std::format("{:>1000000}", values)};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class lib2_format_padded_range final : public int_vector_benchmark
+{
+public:
+    lib2_format_padded_range()
+        : int_vector_benchmark{"lib2::format"} {}
+
+    void operator()()
+    {
+        const auto str {lib2::format<"{:>1000000}">(values)};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+int main(int argc, char** argv)
+{
+    lib2::benchmarking::benchmark_suite range_benchmarks;
+    range_benchmarks.add_benchmark<format_range>();
+    range_benchmarks.add_benchmark<lib2_format_range>();
+
+    lib2::benchmarking::benchmark_suite padded_benchmarks;
+    padded_benchmarks.add_benchmark<format_padded_range>();
+    padded_benchmarks.add_benchmark<lib2_format_padded_range>();
+
+    lib2::benchmarking::benchmark_runner runner {{.min_time = std::chrono::seconds{5}, .count_events = true}};
+    runner.add_suite("Formatting a vector of 100k ints", range_benchmarks);
+    runner.add_suite("Formatting a vector of 100k ints padded to a width", padded_benchmarks);
+
+    return lib2::benchmarking::benchmark_main(runner, argc, argv);
+}
\ No newline at end of file
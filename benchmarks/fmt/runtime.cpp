@@ -0,0 +1,78 @@
+import std;
+
+import lib2;
+
+// An alert message template, as read from configuration
+class alert_benchmark : public lib2::benchmarking::benchmark
+{
+public:
+    using lib2::benchmarking::benchmark::benchmark;
+
+    void setup() override
+    {
+        fmt = "[{}] {} on {}: {:.1f}% over threshold {:.1f}% for {} checks";
+    }
+protected:
+    std::string fmt;
+    std::string_view level {"critical"};
+    std::string_view metric {"cpu.utilization"};
+    std::string_view host {"web-17.eu-west"};
+    double value {97.25};
+    double threshold {90.0};
+    int checks {12};
+};
+
+class vformat_alert final : public alert_benchmark
+{
+public:
+    vformat_alert()
+        : alert_benchmark{"std::vformat"} {}
+
+    void operator()()
+    {
+        const auto str {std::vformat(fmt, std::make_format_args(level, metric, host, value, threshold, checks))};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class lib2_vformat_alert final : public alert_benchmark
+{
+public:
+    lib2_vformat_alert()
+        : alert_benchmark{"lib2::vformat"} {}
+
+    void operator()()
+    {
+        const auto str {lib2::vformat(fmt, lib2::make_format_args(level, metric, host, value, threshold, checks))};
+        lib2::benchmarking::do_not_optimize(str);
+    }
+};
+
+class lib2_vformat_to_alert final : public alert_benchmark
+{
+public:
+    lib2_vformat_to_alert()
+        : alert_benchmark{"lib2::vformat_to"} {}
+
+    void operator()()
+    {
+        lib2::ospanstream out {buf};
+        lib2::vformat_to(out, fmt, lib2::make_format_args(level, metric, host, value, threshold, checks));
+        lib2::benchmarking::do_not_optimize(buf);
+    }
+private:
+    std::byte buf[128];
+};
+
+int main(int argc, char** argv)
+{
+    lib2::benchmarking::benchmark_suite alert_benchmarks;
+    alert_benchmarks.add_benchmark<vformat_alert>();
+    alert_benchmarks.add_benchmark<lib2_vformat_alert>();
+    alert_benchmarks.add_benchmark<lib2_vformat_to_alert>();
+
+    lib2::benchmarking::benchmark_runner runner {{.min_time = std::chrono::seconds{5}, .count_events = true}};
+    runner.add_suite("Formatting a runtime format string", alert_benchmarks);
+
+    return lib2::benchmarking::benchmark_main(runner, argc, argv);
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+import std;
+
+import lib2;
+
+// A row of a report: padded name columns, one of them not ASCII
+constexpr std::string_view name {"ingest.parser.records"};
+constexpr std::string_view unit {"r\xC3\xA9" "cords/s"};
+
+class format_to_padded final : public lib2::benchmarking::benchmark
+{
+public:
+    format_to_padded()
+        : lib2::benchmarking::benchmark{"std::format_to"} {}
+
+    void operator()()
+    {
+        const auto result {std::format_to_n(buf, sizeof(buf), "{:<32}|{:>12}|{:^16?}", name, unit, name)};
+        lib2::benchmarking::do_not_optimize(result);
+        lib2::benchmarking::do_not_optimize(buf);
+    }
+private:
+    char buf[96];
+};
+
+class lib2_format_to_padded final : public lib2::benchmarking::benchmark
+{
+public:
+    lib2_format_to_padded()
+        : lib2::benchmarking::benchmark{"lib2::format_to"} {}
+
+    void operator()()
+    {
+        lib2::ospanstream out {buf};
+        lib2::format_to<"{:<32}|{:>12}|{:^16?}">(out, name, unit, name);
+        lib2::benchmarking::do_not_optimize(buf);
+    }
+private:
+    std::byte buf[96];
+};
+
+int main()
+{
+    const lib2::benchmarking::benchmarking_min_time ctx {std::chrono::seconds{5}};
+
+    lib2::print<"Padded string columns:\n">();
+    format_to_padded b1;
+    lib2_format_to_padded b2;
+    lib2::benchmarking::print_benchmarks(ctx, b1, b2);
+}
\ No newline at end of file
@@ -6,7 +6,7 @@ class multiple_lib2_fstreams final : public lib2::benchmarking::benchmark
 {
 public:
     multiple_lib2_fstreams(const std::size_t amount)
-        : lib2::benchmarking::benchmark{"lib2_fstreams"}
+        : lib2::benchmarking::benchmark{lib2::format("lib2_fstreams ({} files)", amount)}
         {
             fstreams.resize(amount);
         }
@@ -29,7 +29,11 @@ public:
 
     void tear_down()
     {
-        fstreams.clear();
+        for (std::size_t i {0}; i < fstreams.size(); ++i)
+        {
+            fstreams[i].close();
+            std::filesystem::remove(name() + std::to_string(i));
+        }
     }
 private:
     std::vector<lib2::ofstream> fstreams;
@@ -39,7 +43,7 @@ class multiple_lib2_async_fstreams final : public lib2::benchmarking::benchmark
 {
 public:
     multiple_lib2_async_fstreams(const std::size_t amount)
-        : lib2::benchmarking::benchmark{"lib2_async_fstreams"}
+        : lib2::benchmarking::benchmark{lib2::format("lib2_async_fstreams ({} files)", amount)}
         {
             fstreams.resize(amount);
         }
@@ -48,7 +52,7 @@ public:
     {
         for (std::size_t i {0}; i < fstreams.size(); ++i)
         {
-            fstreams[i].open(name() + std::to_string(i));
+            fstreams[i].open(name() + std::to_string(i), lib2::openmode::out | lib2::openmode::trunc);
         }
     }
 
@@ -62,7 +66,11 @@ public:
 
     void tear_down()
     {
-        fstreams.clear();
+        for (std::size_t i {0}; i < fstreams.size(); ++i)
+        {
+            fstreams[i].close();
+            std::filesystem::remove(name() + std::to_string(i));
+        }
     }
 private:
     std::vector<lib2::async_ofstream> fstreams;
@@ -72,11 +80,18 @@ int main()
 {
     const lib2::benchmarking::benchmarking_min_time ctx {std::chrono::seconds{10}};
 
-    constexpr std::size_t amount_files {5};
-    multiple_lib2_fstreams fstreams {amount_files};
-    multiple_lib2_async_fstreams async_fstreams {amount_files};
+    // On Linux the async streams queue full buffers on io_uring and only
+    // wait for them on flush/close, so the gap over the blocking ofstream
+    // widens as more files are written in the same loop.
+    multiple_lib2_fstreams fstreams1 {1};
+    multiple_lib2_fstreams fstreams5 {5};
+    multiple_lib2_fstreams fstreams16 {16};
+    multiple_lib2_async_fstreams async_fstreams1 {1};
+    multiple_lib2_async_fstreams async_fstreams5 {5};
+    multiple_lib2_async_fstreams async_fstreams16 {16};
 
     lib2::benchmarking::print_benchmarks(ctx,
-       fstreams, async_fstreams
+       fstreams1, fstreams5, fstreams16,
+       async_fstreams1, async_fstreams5, async_fstreams16
     );
 }
\ No newline at end of file
@@ -2,6 +2,36 @@ import std;
 
 import lib2;
 
+class std_buf : public lib2::benchmarking::benchmark
+{
+public:
+    std_buf(std::size_t buf_size)
+        : lib2::benchmarking::benchmark{lib2::format("std_ofstream ({} KB)", buf_size / 1024)}
+        , buffer{std::make_unique<char[]>(buf_size)}
+        , buf_size{buf_size} {}
+
+    void setup() final
+    {
+        file.rdbuf()->pubsetbuf(buffer.get(), buf_size);
+        file.open(name());
+    }
+
+    void operator()() final
+    {
+        file << "Hello World! My name is " << name() << '\n';
+    }
+
+    void tear_down() final
+    {
+        file.close();
+        std::filesystem::remove(name());
+    }
+private:
+    std::unique_ptr<char[]> buffer;
+    std::size_t buf_size;
+    std::ofstream file;
+};
+
 class lib2_buf : public lib2::benchmarking::benchmark
 {
 public:
@@ -71,6 +101,15 @@ int main()
     lib2_buf b7 {262144};
     lib2_buf b8 {1048576};
 
+    std_buf bs1 {4096};
+    std_buf bs2 {8192};
+    std_buf bs3 {16384};
+    std_buf bs4 {32768};
+    std_buf bs5 {65536};
+    std_buf bs6 {131072};
+    std_buf bs7 {262144};
+    std_buf bs8 {1048576};
+
     lib2_async_buf ba1 {4096};
     lib2_async_buf ba2 {8192};
     lib2_async_buf ba3 {16384};
@@ -81,6 +120,7 @@ int main()
     lib2_async_buf ba8 {1048576};
 
     lib2::benchmarking::print_benchmarks(ctx,
+        bs1, bs2, bs3, bs4, bs5, bs6, bs7, bs8,
         b1, b2, b3, b4, b5, b6, b7, b8,
         ba1, ba2, ba3, ba4, ba5, ba6, ba7, ba8
     );
@@ -99,6 +99,40 @@ public:
     }
 };
 
+class lib2_scan_benchmark : public lib2::benchmarking::benchmark
+{
+public:
+    lib2_scan_benchmark()
+        : lib2::benchmarking::benchmark{"lib2::scan"} {}
+
+    void operator()() final
+    {
+        int v;
+        const auto it {lib2::scan(str, "{}", v)};
+        lib2::benchmarking::do_not_optimize(v);
+        lib2::benchmarking::do_not_optimize(it);
+    }
+private:
+    static constexpr std::string_view str {"123f"};
+};
+
+class lib2_compiled_scan_benchmark : public lib2::benchmarking::benchmark
+{
+public:
+    lib2_compiled_scan_benchmark()
+        : lib2::benchmarking::benchmark{"lib2::scan<>"} {}
+
+    void operator()() final
+    {
+        int v;
+        const auto it {lib2::scan<"{}">(str, v)};
+        lib2::benchmarking::do_not_optimize(v);
+        lib2::benchmarking::do_not_optimize(it);
+    }
+private:
+    static constexpr std::string_view str {"123f"};
+};
+
 int main()
 {
     const lib2::benchmarking::benchmarking_min_time ctx {std::chrono::seconds{5}};
@@ -107,8 +141,10 @@ int main()
     sscanf_benchmark b2;
     from_chars_benchmark b3;
     istream_setup_benchmark b4;
+    lib2_scan_benchmark b5;
+    lib2_compiled_scan_benchmark b6;
 
     lib2::benchmarking::print_benchmarks(ctx,
-        b1, b2, b3, b4
+        b1, b2, b3, b4, b5, b6
     );
 }
\ No newline at end of file
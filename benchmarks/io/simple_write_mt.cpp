@@ -0,0 +1,108 @@
+import std;
+
+import lib2;
+
+constexpr std::size_t buffer_size {64 * 1024};
+constexpr std::size_t lines_per_thread {1000};
+
+class lib2_fstream_mutex final : public lib2::benchmarking::benchmark
+{
+public:
+    lib2_fstream_mutex(const std::size_t num_threads)
+        : lib2::benchmarking::benchmark{lib2::format("lib2_fstream_mutex ({} threads)", num_threads)}
+        , num_threads{num_threads} {}
+
+    void setup() final
+    {
+        file.open(name());
+        file.setbuf(buffer, buffer_size);
+    }
+
+    void operator()() final
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t t {0}; t < num_threads; ++t)
+        {
+            threads.emplace_back([this, t] {
+                for (std::size_t i {0}; i < lines_per_thread; ++i)
+                {
+                    const std::scoped_lock lock {mutex};
+                    lib2::format_to<"Hello World! My name is {} from thread {}\n">(file, name(), t);
+                }
+            });
+        }
+    }
+
+    void tear_down() final
+    {
+        file.close();
+        std::filesystem::remove(name());
+    }
+private:
+    std::size_t num_threads;
+    std::mutex mutex;
+    lib2::ofstream file;
+    std::byte buffer[buffer_size];
+};
+
+class lib2_sync_ostream final : public lib2::benchmarking::benchmark
+{
+public:
+    lib2_sync_ostream(const std::size_t num_threads)
+        : lib2::benchmarking::benchmark{lib2::format("lib2_sync_ostream ({} threads)", num_threads)}
+        , num_threads{num_threads} {}
+
+    void setup() final
+    {
+        file.open(name());
+        file.setbuf(buffer, buffer_size);
+        out.emplace(file);
+    }
+
+    void operator()() final
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t t {0}; t < num_threads; ++t)
+        {
+            threads.emplace_back([this, t] {
+                auto& local {out->local()};
+                for (std::size_t i {0}; i < lines_per_thread; ++i)
+                {
+                    lib2::format_to<"Hello World! My name is {} from thread {}\n">(local, name(), t);
+                }
+            });
+        }
+    }
+
+    void tear_down() final
+    {
+        out.reset();
+        file.close();
+        std::filesystem::remove(name());
+    }
+private:
+    std::size_t num_threads;
+    lib2::ofstream file;
+    std::optional<lib2::sync_ostream> out;
+    std::byte buffer[buffer_size];
+};
+
+int main()
+{
+    const lib2::benchmarking::benchmarking_min_time ctx {std::chrono::seconds{8}};
+
+    lib2_fstream_mutex m1 {1};
+    lib2_fstream_mutex m2 {2};
+    lib2_fstream_mutex m4 {4};
+    lib2_fstream_mutex m8 {8};
+
+    lib2_sync_ostream s1 {1};
+    lib2_sync_ostream s2 {2};
+    lib2_sync_ostream s4 {4};
+    lib2_sync_ostream s8 {8};
+
+    lib2::benchmarking::print_benchmarks(ctx,
+        m1, m2, m4, m8,
+        s1, s2, s4, s8
+    );
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+import std;
+
+import lib2;
+
+constexpr std::size_t buffer_size {64 * 1024};
+constexpr std::size_t num_samples {1'000'000};
+
+class lib2_fstream_fmt final : public lib2::benchmarking::benchmark
+{
+public:
+    lib2_fstream_fmt()
+        : lib2::benchmarking::benchmark{"lib2_fstream_fmt"} {}
+
+    void setup() final
+    {
+        file.open(name());
+        file.setbuf(buffer, buffer_size);
+    }
+
+    void operator()() final
+    {
+        lib2::format_to<"Hello World! My name is {} and this is line {} ({:.3f})\n">(file, name(), line, static_cast<double>(line) / 7);
+        ++line;
+    }
+
+    void tear_down() final
+    {
+        file.close();
+        std::filesystem::remove(name());
+    }
+private:
+    lib2::ofstream file;
+    std::size_t line {0};
+    std::byte buffer[buffer_size];
+};
+
+class lib2_async_logger final : public lib2::benchmarking::benchmark
+{
+public:
+    lib2_async_logger()
+        : lib2::benchmarking::benchmark{"lib2_async_logger"} {}
+
+    void setup() final
+    {
+        file.open(name());
+        file.setbuf(buffer, buffer_size);
+        logger.emplace(file);
+    }
+
+    void operator()() final
+    {
+        logger->log<"Hello World! My name is {} and this is line {} ({:.3f})\n">(name(), line, static_cast<double>(line) / 7);
+        ++line;
+    }
+
+    void tear_down() final
+    {
+        logger.reset();
+        file.close();
+        std::filesystem::remove(name());
+    }
+private:
+    lib2::ofstream file;
+    std::optional<lib2::async_logger> logger;
+    std::size_t line {0};
+    std::byte buffer[buffer_size];
+};
+
+int main()
+{
+    lib2_fstream_fmt fstream_fmt;
+    lib2_async_logger async_logger;
+
+    lib2::benchmarking::print_latencies(num_samples,
+        fstream_fmt,
+        async_logger
+    );
+}
\ No newline at end of file
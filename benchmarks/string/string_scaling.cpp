@@ -0,0 +1,85 @@
+import std;
+
+import lib2;
+
+// Each family copies n bytes, so throughput shows where the small-size
+// overheads stop mattering and the complexity fit should come out O(n)
+constexpr std::size_t max_size {1 << 20};
+
+static const std::string source (max_size, 'x');
+
+class std_string_copy final : public lib2::benchmarking::parameterized_benchmark
+{
+public:
+    std_string_copy(const std::size_t n)
+        : lib2::benchmarking::parameterized_benchmark{"std::string copy", n} {}
+
+    void operator()() final
+    {
+        const std::string copy {source.data(), n()};
+        lib2::benchmarking::do_not_optimize(copy);
+    }
+
+    std::size_t bytes_per_iteration() const noexcept final
+    {
+        return n();
+    }
+};
+
+class lazy_string_copy final : public lib2::benchmarking::parameterized_benchmark
+{
+public:
+    lazy_string_copy(const std::size_t n)
+        : lib2::benchmarking::parameterized_benchmark{"lazy_string copy", n}
+        , str{std::string{source.data(), n}} {}
+
+    void operator()() final
+    {
+        const auto copy {str};
+        lib2::benchmarking::do_not_optimize(copy);
+    }
+
+    std::size_t bytes_per_iteration() const noexcept final
+    {
+        return n();
+    }
+private:
+    lib2::lazy_string str;
+};
+
+class ostringstream_write final : public lib2::benchmarking::parameterized_benchmark
+{
+public:
+    ostringstream_write(const std::size_t n)
+        : lib2::benchmarking::parameterized_benchmark{"ostringstream write", n} {}
+
+    void operator()() final
+    {
+        lib2::ostringstream out;
+        out.write(std::string_view{source.data(), n()});
+        lib2::benchmarking::do_not_optimize(out);
+    }
+
+    std::size_t bytes_per_iteration() const noexcept final
+    {
+        return n();
+    }
+};
+
+int main(int argc, char** argv)
+{
+    const auto sizes {lib2::benchmarking::range_multiplier(8, max_size)};
+
+    lib2::benchmarking::benchmark_suite copy_benchmarks;
+    copy_benchmarks.add_benchmark_family<std_string_copy>(sizes);
+    copy_benchmarks.add_benchmark_family<lazy_string_copy>(sizes);
+
+    lib2::benchmarking::benchmark_suite stream_benchmarks;
+    stream_benchmarks.add_benchmark_family<ostringstream_write>(sizes);
+
+    lib2::benchmarking::benchmark_runner runner {{.min_time = std::chrono::milliseconds{500}}};
+    runner.add_suite("Copying n bytes", copy_benchmarks);
+    runner.add_suite("Writing n bytes to a string stream", stream_benchmarks);
+
+    return lib2::benchmarking::benchmark_main(runner, argc, argv);
+}
\ No newline at end of file
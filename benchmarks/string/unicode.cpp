@@ -0,0 +1,197 @@
+import std;
+
+import lib2;
+
+// One MiB of each kind of input. Throughput is reported against the size of
+// the input side.
+constexpr std::size_t input_size {1 << 20};
+
+static std::string make_utf8(const std::string_view pattern)
+{
+    std::string str;
+    while (str.size() + pattern.size() <= input_size)
+    {
+        str += pattern;
+    }
+    return str;
+}
+
+static const std::string ascii_text {make_utf8("The quick brown fox jumps over the lazy dog. ")};
+static const std::string mixed_text {make_utf8("Ingest \xC3\xBC" "ber caf\xC3\xA9s, \xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E and \xF0\x9F\x98\x80 emoji. ")};
+
+static std::u16string make_utf16(const std::string& utf8)
+{
+    std::u16string str;
+    lib2::utf8_to_utf16(utf8, std::back_inserter(str));
+    return str;
+}
+
+static const std::u16string ascii_text16 {make_utf16(ascii_text)};
+static const std::u16string mixed_text16 {make_utf16(mixed_text)};
+
+class unicode_benchmark : public lib2::benchmarking::benchmark
+{
+public:
+    unicode_benchmark(std::string name, const std::size_t bytes)
+        : lib2::benchmarking::benchmark{std::move(name)}
+        , bytes{bytes} {}
+
+    const std::size_t bytes;
+};
+
+class codepoint_view_validate final : public unicode_benchmark
+{
+public:
+    codepoint_view_validate(const std::string& input)
+        : unicode_benchmark{"views::utf8_codepoints", input.size()}
+        , input{input} {}
+
+    void operator()() final
+    {
+        bool valid {true};
+        const auto view {lib2::views::utf8_codepoints(input)};
+        for (auto it {view.begin()}; it != view.end(); ++it)
+        {
+            valid &= !it.invalid();
+        }
+        lib2::benchmarking::do_not_optimize(valid);
+    }
+private:
+    const std::string& input;
+};
+
+class validate_utf8 final : public unicode_benchmark
+{
+public:
+    validate_utf8(const std::string& input)
+        : unicode_benchmark{"lib2::validate_utf8", input.size()}
+        , input{input} {}
+
+    void operator()() final
+    {
+        lib2::benchmarking::do_not_optimize(lib2::validate_utf8(input));
+    }
+private:
+    const std::string& input;
+};
+
+class count_codepoints final : public unicode_benchmark
+{
+public:
+    count_codepoints(const std::string& input)
+        : unicode_benchmark{"lib2::count_codepoints", input.size()}
+        , input{input} {}
+
+    void operator()() final
+    {
+        lib2::benchmarking::do_not_optimize(lib2::count_codepoints(input));
+    }
+private:
+    const std::string& input;
+};
+
+// Writing through a string iterator rather than a pointer takes the
+// per-code point path
+class utf8_to_utf16_iterator final : public unicode_benchmark
+{
+public:
+    utf8_to_utf16_iterator(const std::string& input)
+        : unicode_benchmark{"utf8_to_utf16 (iterator)", input.size()}
+        , input{input}
+        , output(input.size(), u'\0') {}
+
+    void operator()() final
+    {
+        lib2::utf8_to_utf16(input, output.begin());
+        lib2::benchmarking::do_not_optimize(output);
+    }
+private:
+    const std::string& input;
+    std::u16string output;
+};
+
+class utf8_to_utf16_bulk final : public unicode_benchmark
+{
+public:
+    utf8_to_utf16_bulk(const std::string& input)
+        : unicode_benchmark{"utf8_to_utf16 (contiguous)", input.size()}
+        , input{input}
+        , output(input.size(), u'\0') {}
+
+    void operator()() final
+    {
+        lib2::utf8_to_utf16(input, output.data());
+        lib2::benchmarking::do_not_optimize(output);
+    }
+private:
+    const std::string& input;
+    std::u16string output;
+};
+
+class utf16_to_utf8_iterator final : public unicode_benchmark
+{
+public:
+    utf16_to_utf8_iterator(const std::u16string& input)
+        : unicode_benchmark{"utf16_to_utf8 (iterator)", input.size() * sizeof(char16_t)}
+        , input{input}
+        , output(input.size() * 3, '\0') {}
+
+    void operator()() final
+    {
+        lib2::utf16_to_utf8(input, output.begin());
+        lib2::benchmarking::do_not_optimize(output);
+    }
+private:
+    const std::u16string& input;
+    std::string output;
+};
+
+class utf16_to_utf8_bulk final : public unicode_benchmark
+{
+public:
+    utf16_to_utf8_bulk(const std::u16string& input)
+        : unicode_benchmark{"utf16_to_utf8 (contiguous)", input.size() * sizeof(char16_t)}
+        , input{input}
+        , output(input.size() * 3, '\0') {}
+
+    void operator()() final
+    {
+        lib2::utf16_to_utf8(input, output.data());
+        lib2::benchmarking::do_not_optimize(output);
+    }
+private:
+    const std::u16string& input;
+    std::string output;
+};
+
+template<std::derived_from<unicode_benchmark>... Benches>
+void print_throughput(const lib2::benchmarking::benchmarking_context& ctx, Benches&&... benches)
+{
+    const auto print_one {[&](unicode_benchmark& bench) {
+        const auto result {ctx.run_benchmark(bench)};
+        const auto bytes {static_cast<double>(bench.bytes * result.num_iterations)};
+        // Bytes per nanosecond is GB/s
+        lib2::print<"{:<28} {:>8.2f} GB/s\n">(bench.name(), bytes / static_cast<double>(result.total_time.count()));
+    }};
+
+    (print_one(benches), ...);
+}
+
+int main()
+{
+    const lib2::benchmarking::benchmarking_min_time ctx {std::chrono::seconds{5}};
+
+    lib2::print<"Validating ASCII UTF-8:\n">();
+    print_throughput(ctx, codepoint_view_validate{ascii_text}, validate_utf8{ascii_text}, count_codepoints{ascii_text});
+
+    lib2::print<"\nValidating mixed UTF-8:\n">();
+    print_throughput(ctx, codepoint_view_validate{mixed_text}, validate_utf8{mixed_text}, count_codepoints{mixed_text});
+
+    lib2::print<"\nTranscoding ASCII:\n">();
+    print_throughput(ctx, utf8_to_utf16_iterator{ascii_text}, utf8_to_utf16_bulk{ascii_text},
+                          utf16_to_utf8_iterator{ascii_text16}, utf16_to_utf8_bulk{ascii_text16});
+
+    lib2::print<"\nTranscoding mixed text:\n">();
+    print_throughput(ctx, utf8_to_utf16_iterator{mixed_text}, utf8_to_utf16_bulk{mixed_text},
+                          utf16_to_utf8_iterator{mixed_text16}, utf16_to_utf8_bulk{mixed_text16});
+}
\ No newline at end of file
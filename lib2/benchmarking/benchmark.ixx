@@ -22,10 +22,77 @@ namespace lib2::benchmarking
 		{
 			return name_;
 		}
+
+		// Work done by one call, for reporting throughput. 0 when the
+		// benchmark has no meaningful amount.
+		[[nodiscard]] virtual std::size_t bytes_per_iteration() const noexcept
+		{
+			return 0;
+		}
+
+		[[nodiscard]] virtual std::size_t items_per_iteration() const noexcept
+		{
+			return 0;
+		}
+
+		// Input size for fitting how the time grows, 0 when the benchmark
+		// is not part of a family
+		[[nodiscard]] virtual std::size_t complexity_n() const noexcept
+		{
+			return 0;
+		}
 	private:
 		std::string name_;
 	};
 
+	// A benchmark of a family run over a range of sizes or thread counts.
+	// Its name is "<family>/<n>".
+	export
+	class parameterized_benchmark : public benchmark
+	{
+	public:
+		parameterized_benchmark(const std::string_view family, const std::size_t n)
+			: benchmark{std::string{family} + '/' + std::to_string(n)}
+			, n_{n} {}
+
+		[[nodiscard]] std::size_t n() const noexcept
+		{
+			return n_;
+		}
+
+		[[nodiscard]] std::size_t complexity_n() const noexcept override
+		{
+			return n_;
+		}
+	private:
+		std::size_t n_;
+	};
+
+	// lo, lo * multiplier, lo * multiplier^2, ... up to and always
+	// including hi
+	export
+	[[nodiscard]] std::vector<std::size_t> range_multiplier(const std::size_t lo, const std::size_t hi, const std::size_t multiplier = 8)
+	{
+		std::vector<std::size_t> values;
+		for (auto n {std::max(lo, std::size_t{1})}; n < hi; n *= std::max(multiplier, std::size_t{2}))
+		{
+			values.push_back(n);
+		}
+		values.push_back(hi);
+		return values;
+	}
+
+	export
+	[[nodiscard]] std::vector<std::size_t> dense_range(const std::size_t lo, const std::size_t hi, const std::size_t step = 1)
+	{
+		std::vector<std::size_t> values;
+		for (auto n {lo}; n <= hi; n += std::max(step, std::size_t{1}))
+		{
+			values.push_back(n);
+		}
+		return values;
+	}
+
 	export
 	class noop_benchmark : public benchmark
 	{
@@ -6,96 +6,253 @@ import lib2.io;
 import lib2.fmt;
 
 import :benchmark_output;
+import :complexity;
+import :latency;
+import :perf_counters;
+import :statistics;
 
 namespace lib2::benchmarking
 {
-    template<class Rep, class Period>
-    static std::string best_fit_duration_string(const std::chrono::duration<Rep, Period> dur)
+    static float calc_perf_multiple(const benchmark_result& r1, const benchmark_result& r2) noexcept
     {
-        if constexpr (std::integral<Rep>)
+        const auto time_multiple {static_cast<float>(r2.total_time.count()) / static_cast<float>(r1.total_time.count())};
+        const auto iteration_multiple {static_cast<float>(r1.num_iterations) / static_cast<float>(r2.num_iterations)};
+
+        return std::max(time_multiple, iteration_multiple);
+    }
+
+    void print_benchmarks(lib2::text_ostream& stream, const std::vector<std::pair<std::string_view, benchmark_result>>& results)
+    {
+        std::size_t name_column_width {9};
+        std::size_t time_column_width {5};
+        std::size_t iterations_column_width {10};
+        std::size_t multiple_column_width {8};
+
+        for (const auto& [name, result] : results)
         {
-            if (dur.count() < 10000 && (dur.count() % 1000 || dur.count() == 0))
+            name_column_width       = std::max(name_column_width, name.size());
+            time_column_width       = std::max(time_column_width, lib2::formatted_size<"{:auto}">(result.total_time));
+            iterations_column_width = std::max(iterations_column_width, lib2::formatted_size<"{}">(result.num_iterations));
+            multiple_column_width   = std::max(multiple_column_width, lib2::formatted_size<"{:.2f}">(calc_perf_multiple(result, results.back().second)));
+        }
+
+        const auto banner_width {name_column_width + 1 + time_column_width + 1 + iterations_column_width + 1 + multiple_column_width};
+        
+        stream.fill('-', banner_width);
+        lib2::format_to<"\n{:<{}} {:>{}} {:>{}} {:<{}}\n">(stream, "Benchmark", name_column_width, "Time", time_column_width, "Iterations", iterations_column_width, "Multiple", multiple_column_width);
+        stream.fill('-', banner_width);
+        stream.put('\n');
+        for (const auto& [name, result] : results)
+        {
+            lib2::format_to<"{:<{}} {:>{}auto} {:>{}} {:<{}.2f}\n">(stream, name, name_column_width, result.total_time, time_column_width, result.num_iterations, iterations_column_width, calc_perf_multiple(result, results.back().second), multiple_column_width);
+        }
+    }
+
+    void print_latencies(lib2::text_ostream& stream, const std::vector<std::pair<std::string_view, latency_result>>& results)
+    {
+        constexpr std::array<std::string_view, 6> headers {"Min", "p50", "p90", "p99", "p99.9", "Max"};
+
+        const auto row_times {[](const latency_result& result) {
+            return std::array<std::chrono::nanoseconds, headers.size()>{result.min, result.p50, result.p90, result.p99, result.p999, result.max};
+        }};
+
+        std::size_t name_column_width {9};
+        std::array<std::size_t, headers.size()> time_column_widths;
+        std::ranges::transform(headers, time_column_widths.begin(), [](const auto header) { return header.size(); });
+
+        for (const auto& [name, result] : results)
+        {
+            const auto times {row_times(result)};
+
+            name_column_width = std::max(name_column_width, name.size());
+            for (std::size_t i {0}; i < times.size(); ++i)
             {
-                return lib2::format<"{}">(dur);
+                time_column_widths[i] = std::max(time_column_widths[i], lib2::formatted_size<"{:auto}">(times[i]));
             }
         }
-        else
+
+        const auto banner_width {name_column_width + std::ranges::fold_left(time_column_widths, std::size_t{0}, [](const auto total, const auto width) { return total + 1 + width; })};
+
+        stream.fill('-', banner_width);
+        lib2::format_to<"\n{:<{}}">(stream, "Benchmark", name_column_width);
+        for (std::size_t i {0}; i < headers.size(); ++i)
+        {
+            lib2::format_to<" {:>{}}">(stream, headers[i], time_column_widths[i]);
+        }
+        stream.put('\n');
+        stream.fill('-', banner_width);
+        stream.put('\n');
+
+        for (const auto& [name, result] : results)
         {
-            if (dur.count() < 10000)
+            lib2::format_to<"{:<{}}">(stream, name, name_column_width);
+
+            const auto times {row_times(result)};
+            for (std::size_t i {0}; i < times.size(); ++i)
             {
-                return lib2::format<"{:.2f}{:%q}">(dur.count(), dur);
+                lib2::format_to<" {:>{}auto}">(stream, times[i], time_column_widths[i]);
             }
+            stream.put('\n');
         }
+    }
 
-        if constexpr (Period::num < std::exa::num)
+    static std::string event_count_string(const std::optional<double> count, const bool fraction = false)
+    {
+        if (!count)
+        {
+            return "-";
+        }
+        return fraction ? lib2::format<"{:.2f}">(*count) : lib2::format<"{:.1f}">(*count);
+    }
+
+    // Throughput at the median time, in bytes if the benchmark counts them
+    // and in items otherwise
+    static std::string throughput_string(const benchmark_statistics& stats)
+    {
+        const auto seconds {stats.median.count() / 1e9};
+        const auto amount {stats.bytes_per_iteration != 0 ? stats.bytes_per_iteration : stats.items_per_iteration};
+        if (amount == 0 || seconds <= 0)
         {
-            if constexpr (std::integral<Rep>)
+            return "-";
+        }
+
+        constexpr std::array<std::string_view, 5> byte_units {"B/s", "KB/s", "MB/s", "GB/s", "TB/s"};
+        constexpr std::array<std::string_view, 5> item_units {"/s", "k/s", "M/s", "G/s", "T/s"};
+        const auto& units {stats.bytes_per_iteration != 0 ? byte_units : item_units};
+
+        auto rate {static_cast<double>(amount) / seconds};
+        std::size_t unit {0};
+        while (rate >= 1000 && unit + 1 < units.size())
+        {
+            rate /= 1000;
+            ++unit;
+        }
+        return lib2::format<"{:.2f}{}">(rate, units[unit]);
+    }
+
+    // Fits the time of each family, the benchmarks named "<family>/<n>",
+    // that was run for at least three sizes
+    static void print_complexity(lib2::text_ostream& stream, const std::vector<std::pair<std::string_view, benchmark_statistics>>& results)
+    {
+        struct family_times
+        {
+            std::string_view family;
+            std::vector<std::size_t> ns;
+            std::vector<double> times;
+        };
+
+        std::vector<family_times> families;
+        for (const auto& [name, stats] : results)
+        {
+            if (stats.complexity_n == 0)
             {
-                if (dur.count() % 1000)
-                {
-                    return best_fit_duration_string(
-                        std::chrono::duration_cast<std::chrono::duration<float, std::ratio_multiply<Period, std::ratio<1000>>>>(dur)
-                    );
-                }
-                else
-                {
-                    return best_fit_duration_string(
-                        std::chrono::duration_cast<std::chrono::duration<Rep, std::ratio_multiply<Period, std::ratio<1000>>>>(dur)
-                    );
-                }
+                continue;
             }
-            else
+
+            const auto family {name.substr(0, name.rfind('/'))};
+            auto it {std::ranges::find(families, family, &family_times::family)};
+            if (it == families.end())
             {
-                return best_fit_duration_string(
-                    std::chrono::duration_cast<std::chrono::duration<Rep, std::ratio_multiply<Period, std::ratio<1000>>>>(dur)
-                );
+                it = families.insert(families.end(), family_times{.family = family});
             }
+            it->ns.push_back(stats.complexity_n);
+            it->times.push_back(stats.median.count());
         }
-        else
+
+        for (const auto& [family, ns, times] : families)
         {
-            if constexpr (std::integral<Rep>)
-            {
-                return lib2::format<"{}">(dur);
-            }
-            else
+            if (ns.size() < 3)
             {
-                return lib2::format<"{:.2f}{:%q}">(dur.count(), dur);
+                continue;
             }
+
+            const auto fit {fit_complexity(ns, times)};
+            lib2::format_to<"{}: {} with {:.4g}ns per unit, RMS {:.1f}%\n">(stream, family, to_string(fit.big_o), fit.coefficient, fit.rms * 100);
         }
     }
 
-    static float calc_perf_multiple(const benchmark_result& r1, const benchmark_result& r2) noexcept
+    void print_statistics(lib2::text_ostream& stream, const std::vector<std::pair<std::string_view, benchmark_statistics>>& results)
     {
-        const auto time_multiple {static_cast<float>(r2.total_time.count()) / static_cast<float>(r1.total_time.count())};
-        const auto iteration_multiple {static_cast<float>(r1.num_iterations) / static_cast<float>(r2.num_iterations)};
+        std::vector<std::string_view> headers {"Min", "Median", "p99", "Stddev", "Outliers", "Samples", "Batch"};
 
-        return std::max(time_multiple, iteration_multiple);
-    }
+        const bool show_throughput {std::ranges::any_of(results, [](const auto& result) {
+            return result.second.bytes_per_iteration != 0 || result.second.items_per_iteration != 0;
+        })};
+        if (show_throughput)
+        {
+            headers.push_back("Throughput");
+        }
+
+        // Event columns only show up when something was counted
+        const bool show_events {std::ranges::any_of(results, [](const auto& result) { return !result.second.events.empty(); })};
+        if (show_events)
+        {
+            headers.insert(headers.end(), {"Cycles", "Instrs", "IPC", "Br-miss", "L1D-miss", "LLC-miss"});
+        }
+
+        std::vector<std::vector<std::string>> rows;
+        rows.reserve(results.size());
 
-    void print_benchmarks(lib2::text_ostream& stream, const std::vector<std::pair<std::string_view, benchmark_result>>& results)
-    {
         std::size_t name_column_width {9};
-        std::size_t time_column_width {5};
-        std::size_t iterations_column_width {10};
-        std::size_t multiple_column_width {8};
+        std::vector<std::size_t> column_widths(headers.size());
+        std::ranges::transform(headers, column_widths.begin(), [](const auto header) { return header.size(); });
 
         for (const auto& [name, result] : results)
         {
-            name_column_width       = std::max(name_column_width, name.size());
-            time_column_width       = std::max(time_column_width, best_fit_duration_string(result.total_time).size());
-            iterations_column_width = std::max(iterations_column_width, lib2::formatted_size<"{}">(result.num_iterations));
-            multiple_column_width   = std::max(multiple_column_width, lib2::formatted_size<"{:.2f}">(calc_perf_multiple(result, results.back().second)));
+            auto& row {rows.emplace_back()};
+            row.push_back(lib2::format<"{:auto}">(result.min));
+            row.push_back(lib2::format<"{:auto}">(result.median));
+            row.push_back(lib2::format<"{:auto}">(result.p99));
+            row.push_back(lib2::format<"{:auto}">(result.stddev));
+            row.push_back(lib2::format<"{}">(result.num_outliers));
+            row.push_back(lib2::format<"{}">(result.num_samples));
+            row.push_back(lib2::format<"{}">(result.batch_size));
+
+            if (show_throughput)
+            {
+                row.push_back(throughput_string(result));
+            }
+
+            if (show_events)
+            {
+                const auto& events {result.events};
+                row.push_back(event_count_string(events.cycles));
+                row.push_back(event_count_string(events.instructions));
+                row.push_back(event_count_string(events.ipc(), true));
+                row.push_back(event_count_string(events.branch_misses, true));
+                row.push_back(event_count_string(events.l1d_misses, true));
+                row.push_back(event_count_string(events.llc_misses, true));
+            }
+
+            name_column_width = std::max(name_column_width, name.size());
+            for (std::size_t i {0}; i < row.size(); ++i)
+            {
+                column_widths[i] = std::max(column_widths[i], row[i].size());
+            }
         }
 
-        const auto banner_width {name_column_width + 1 + time_column_width + 1 + iterations_column_width + 1 + multiple_column_width};
-        
+        const auto banner_width {name_column_width + std::ranges::fold_left(column_widths, std::size_t{0}, [](const auto total, const auto width) { return total + 1 + width; })};
+
         stream.fill('-', banner_width);
-        lib2::format_to<"\n{:<{}} {:>{}} {:>{}} {:<{}}\n">(stream, "Benchmark", name_column_width, "Time", time_column_width, "Iterations", iterations_column_width, "Multiple", multiple_column_width);
+        lib2::format_to<"\n{:<{}}">(stream, "Benchmark", name_column_width);
+        for (std::size_t i {0}; i < headers.size(); ++i)
+        {
+            lib2::format_to<" {:>{}}">(stream, headers[i], column_widths[i]);
+        }
+        stream.put('\n');
         stream.fill('-', banner_width);
         stream.put('\n');
-        for (const auto& [name, result] : results)
+
+        for (std::size_t r {0}; r < results.size(); ++r)
         {
-            lib2::format_to<"{:<{}} {:>{}} {:>{}} {:<{}.2f}\n">(stream, name, name_column_width, best_fit_duration_string(result.total_time), time_column_width, result.num_iterations, iterations_column_width, calc_perf_multiple(result, results.back().second), multiple_column_width);
+            lib2::format_to<"{:<{}}">(stream, results[r].first, name_column_width);
+            for (std::size_t i {0}; i < headers.size(); ++i)
+            {
+                lib2::format_to<" {:>{}}">(stream, rows[r][i], column_widths[i]);
+            }
+            stream.put('\n');
         }
+
+        print_complexity(stream, results);
     }
 }
\ No newline at end of file
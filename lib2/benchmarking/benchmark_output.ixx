@@ -9,10 +9,15 @@ import lib2.fmt;
 import :benchmark;
 import :benchmark_suite;
 import :benchmarking_context;
+import :latency;
+import :runner;
+import :statistics;
 
 namespace lib2::benchmarking
 {
     void print_benchmarks(lib2::text_ostream& stream, const std::vector<std::pair<std::string_view, benchmark_result>>& results);
+    void print_latencies(lib2::text_ostream& stream, const std::vector<std::pair<std::string_view, latency_result>>& results);
+    void print_statistics(lib2::text_ostream& stream, const std::vector<std::pair<std::string_view, benchmark_statistics>>& results);
 
     export
     void print_benchmarks(lib2::text_ostream& stream, const benchmarking_context& ctx, benchmark_suite& suite)
@@ -78,4 +83,80 @@ namespace lib2::benchmarking
     { 
         print_benchmarks(lib2::cout, ctx, benches...);
     }
+
+    export
+    template<std::derived_from<benchmark>... Benches>
+    void print_latencies(lib2::text_ostream& stream, const std::size_t num_samples, Benches&... benches)
+    {
+        std::vector<std::pair<std::string_view, latency_result>> runs;
+
+        const auto add_run {[&](auto& bench) {
+            runs.emplace_back(std::piecewise_construct,
+                std::forward_as_tuple(bench.name()),
+                std::forward_as_tuple(measure_latency(bench, num_samples))
+            );
+        }};
+
+        (add_run(benches), ...);
+
+        std::ranges::sort(runs, {}, [](const auto& pair) {
+            return pair.second.p50;
+        });
+
+        print_latencies(stream, runs);
+    }
+
+    export
+    template<std::derived_from<benchmark>... Benches>
+    void print_latencies(const std::size_t num_samples, Benches&... benches)
+    {
+        print_latencies(lib2::cout, num_samples, benches...);
+    }
+
+    export
+    void print_statistics(lib2::text_ostream& stream, const suite_statistics& suite)
+    {
+        std::vector<std::pair<std::string_view, benchmark_statistics>> runs;
+        runs.reserve(suite.results.size());
+        for (const auto& [name, stats] : suite.results)
+        {
+            runs.emplace_back(name, stats);
+        }
+
+        if (!suite.name.empty())
+        {
+            lib2::format_to<"{}:\n">(stream, suite.name);
+        }
+        if (suite.core && !suite.pinned)
+        {
+            lib2::format_to<"Could not pin to core {}, other threads may have shared it\n">(stream, *suite.core);
+        }
+        print_statistics(stream, runs);
+    }
+
+    export
+    void print_statistics(const std::span<const suite_statistics> suites)
+    {
+        for (const auto& suite : suites)
+        {
+            print_statistics(lib2::cout, suite);
+            lib2::cout.put('\n');
+        }
+    }
+
+    export
+    template<std::derived_from<benchmark>... Benches>
+    void print_statistics(lib2::text_ostream& stream, const run_options& options, Benches&... benches)
+    {
+        std::vector<std::pair<std::string_view, benchmark_statistics>> runs;
+        (runs.emplace_back(benches.name(), run_statistics(benches, options)), ...);
+        print_statistics(stream, runs);
+    }
+
+    export
+    template<std::derived_from<benchmark>... Benches>
+    void print_statistics(const run_options& options, Benches&... benches)
+    {
+        print_statistics(lib2::cout, options, benches...);
+    }
 }
\ No newline at end of file
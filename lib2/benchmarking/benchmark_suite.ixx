@@ -27,6 +27,18 @@ namespace lib2::benchmarking
             add_benchmark<benchmark_t>(std::forward<Args>(args)...);
         }
 
+        // Adds T{n, args...} for every n of r. args are copied into each
+        // benchmark, not forwarded.
+        template<std::derived_from<benchmark> T, std::ranges::input_range R, class... Args>
+            requires(std::convertible_to<std::ranges::range_value_t<R>, std::size_t>)
+        void add_benchmark_family(R&& r, const Args&... args)
+        {
+            for (const std::size_t n : r)
+            {
+                add_benchmark<T>(n, args...);
+            }
+        }
+
         // template<std::derived_from<benchmark> T>
         // void add_benchmark(T&& bench)
         // {
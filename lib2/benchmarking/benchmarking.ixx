@@ -3,4 +3,10 @@ export import :do_not_optimize;
 export import :benchmark;
 export import :benchmarking_context;
 export import :benchmark_suite;
-export import :benchmark_output;
\ No newline at end of file
+export import :latency;
+export import :perf_counters;
+export import :statistics;
+export import :complexity;
+export import :runner;
+export import :benchmark_output;
+export import :result_file;
\ No newline at end of file
@@ -0,0 +1,120 @@
+export module lib2.benchmarking:complexity;
+
+import std;
+
+namespace lib2::benchmarking
+{
+    export
+    enum class complexity
+    {
+        o_1,
+        o_log_n,
+        o_n,
+        o_n_log_n,
+        o_n_squared,
+        o_n_cubed
+    };
+
+    export
+    [[nodiscard]] constexpr std::string_view to_string(const complexity c) noexcept
+    {
+        switch (c)
+        {
+        case complexity::o_1:
+            return "O(1)";
+        case complexity::o_log_n:
+            return "O(log n)";
+        case complexity::o_n:
+            return "O(n)";
+        case complexity::o_n_log_n:
+            return "O(n log n)";
+        case complexity::o_n_squared:
+            return "O(n^2)";
+        case complexity::o_n_cubed:
+            return "O(n^3)";
+        }
+        return "O(?)";
+    }
+
+    [[nodiscard]] double complexity_function(const complexity c, const double n) noexcept
+    {
+        switch (c)
+        {
+        case complexity::o_1:
+            return 1;
+        case complexity::o_log_n:
+            return std::log2(n);
+        case complexity::o_n:
+            return n;
+        case complexity::o_n_log_n:
+            return n * std::log2(n);
+        case complexity::o_n_squared:
+            return n * n;
+        case complexity::o_n_cubed:
+            return n * n * n;
+        }
+        return 1;
+    }
+
+    // time ~= coefficient * f(n), with the RMS of the residuals relative to
+    // the mean time
+    export
+    struct complexity_fit
+    {
+        complexity big_o {complexity::o_1};
+        double coefficient {0};
+        double rms {0};
+    };
+
+    // Least squares fit of each candidate, keeping the one with the
+    // smallest residual
+    export
+    [[nodiscard]] complexity_fit fit_complexity(const std::span<const std::size_t> ns, const std::span<const double> times) noexcept
+    {
+        const auto count {std::min(ns.size(), times.size())};
+        if (count == 0)
+        {
+            return {};
+        }
+
+        double mean_time {0};
+        for (std::size_t i {0}; i < count; ++i)
+        {
+            mean_time += times[i];
+        }
+        mean_time /= static_cast<double>(count);
+
+        complexity_fit best {.rms = std::numeric_limits<double>::infinity()};
+        for (const auto c : {complexity::o_1, complexity::o_log_n, complexity::o_n, complexity::o_n_log_n, complexity::o_n_squared, complexity::o_n_cubed})
+        {
+            double sum_ft {0};
+            double sum_ff {0};
+            for (std::size_t i {0}; i < count; ++i)
+            {
+                const auto f {complexity_function(c, static_cast<double>(ns[i]))};
+                sum_ft += f * times[i];
+                sum_ff += f * f;
+            }
+
+            if (sum_ff == 0)
+            {
+                continue;
+            }
+
+            const auto coefficient {sum_ft / sum_ff};
+            double sum_residuals {0};
+            for (std::size_t i {0}; i < count; ++i)
+            {
+                const auto residual {times[i] - coefficient * complexity_function(c, static_cast<double>(ns[i]))};
+                sum_residuals += residual * residual;
+            }
+
+            const auto rms {std::sqrt(sum_residuals / static_cast<double>(count)) / mean_time};
+            if (rms < best.rms)
+            {
+                best = {c, coefficient, rms};
+            }
+        }
+        return best;
+    }
+}
\ No newline at end of file
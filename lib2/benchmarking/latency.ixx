@@ -0,0 +1,72 @@
+export module lib2.benchmarking:latency;
+
+import std;
+
+import lib2.utility;
+
+import :benchmark;
+import :statistics;
+
+namespace lib2::benchmarking
+{
+    // Distribution of the time taken by single calls of a benchmark, for
+    // code where the tail matters more than the throughput
+    export
+    struct latency_result
+    {
+        std::size_t num_samples {0};
+        std::chrono::nanoseconds min {0};
+        std::chrono::nanoseconds p50 {0};
+        std::chrono::nanoseconds p90 {0};
+        std::chrono::nanoseconds p99 {0};
+        std::chrono::nanoseconds p999 {0};
+        std::chrono::nanoseconds max {0};
+    };
+
+    // See quantile, rounded to whole nanoseconds
+    [[nodiscard]] std::chrono::nanoseconds percentile(const std::span<const std::chrono::nanoseconds> sorted, const double p) noexcept
+    {
+        return std::chrono::nanoseconds{std::llround(quantile<std::chrono::nanoseconds>(sorted, p))};
+    }
+
+    export
+    latency_result measure_latency(benchmark& bench, const std::size_t num_samples)
+    {
+        std::vector<std::chrono::nanoseconds> samples;
+        samples.reserve(num_samples);
+        bench.setup();
+
+        try
+        {
+            for (std::size_t i {0}; i < num_samples; ++i)
+            {
+                const lib2::stopwatch stopwatch;
+                bench();
+                samples.push_back(stopwatch.elapsed_time());
+            }
+        }
+        catch (...)
+        {
+            bench.tear_down();
+            throw;
+        }
+
+        bench.tear_down();
+
+        if (samples.empty())
+        {
+            return {};
+        }
+
+        std::ranges::sort(samples);
+        return {
+            .num_samples = samples.size(),
+            .min         = samples.front(),
+            .p50         = percentile(samples, 0.5),
+            .p90         = percentile(samples, 0.9),
+            .p99         = percentile(samples, 0.99),
+            .p999        = percentile(samples, 0.999),
+            .max         = samples.back()
+        };
+    }
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+module;
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+module lib2.benchmarking;
+
+import std;
+
+import :perf_counters;
+
+namespace lib2::benchmarking
+{
+#if defined(__linux__)
+    struct perf_event_config
+    {
+        std::uint32_t type;
+        std::uint64_t config;
+    };
+
+    // In the order of the members of event_counts
+    static constexpr std::array<perf_event_config, 5> perf_events {{
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES}
+    }};
+
+    static int open_perf_event(const perf_event_config& event) noexcept
+    {
+        perf_event_attr attr {};
+        attr.size = sizeof(attr);
+        attr.type = event.type;
+        attr.config = event.config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    }
+
+    static std::optional<double> read_perf_event(const int fd) noexcept
+    {
+        if (fd < 0)
+        {
+            return std::nullopt;
+        }
+
+        std::uint64_t values[3];
+        if (::read(fd, values, sizeof(values)) != sizeof(values) || values[2] == 0)
+        {
+            return std::nullopt;
+        }
+
+        // values are the count, time enabled and time running
+        return static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]);
+    }
+
+    perf_counters::perf_counters() noexcept
+    {
+        for (std::size_t i {0}; i < num_events; ++i)
+        {
+            fds_[i] = open_perf_event(perf_events[i]);
+        }
+    }
+
+    perf_counters::~perf_counters() noexcept
+    {
+        for (const auto fd : fds_)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+    }
+
+    bool perf_counters::available() const noexcept
+    {
+        return std::ranges::any_of(fds_, [](const int fd) { return fd >= 0; });
+    }
+
+    void perf_counters::start() noexcept
+    {
+        for (const auto fd : fds_)
+        {
+            if (fd >= 0)
+            {
+                ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    void perf_counters::stop() noexcept
+    {
+        for (const auto fd : fds_)
+        {
+            if (fd >= 0)
+            {
+                ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+    }
+
+    event_counts perf_counters::read() const noexcept
+    {
+        return {
+            .cycles        = read_perf_event(fds_[0]),
+            .instructions  = read_perf_event(fds_[1]),
+            .branch_misses = read_perf_event(fds_[2]),
+            .l1d_misses    = read_perf_event(fds_[3]),
+            .llc_misses    = read_perf_event(fds_[4])
+        };
+    }
+#else
+    perf_counters::perf_counters() noexcept
+    {
+        fds_.fill(-1);
+    }
+
+    perf_counters::~perf_counters() noexcept = default;
+
+    bool perf_counters::available() const noexcept
+    {
+        return false;
+    }
+
+    void perf_counters::start() noexcept {}
+    void perf_counters::stop() noexcept {}
+
+    event_counts perf_counters::read() const noexcept
+    {
+        return {};
+    }
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+export module lib2.benchmarking:perf_counters;
+
+import std;
+
+namespace lib2::benchmarking
+{
+    // Hardware events per iteration of a benchmark. Events the machine or
+    // its permissions do not allow counting are left empty.
+    export
+    struct event_counts
+    {
+        std::optional<double> cycles;
+        std::optional<double> instructions;
+        std::optional<double> branch_misses;
+        std::optional<double> l1d_misses;
+        std::optional<double> llc_misses;
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return !cycles && !instructions && !branch_misses && !l1d_misses && !llc_misses;
+        }
+
+        [[nodiscard]] std::optional<double> ipc() const noexcept
+        {
+            if (!cycles || !instructions || *cycles == 0)
+            {
+                return std::nullopt;
+            }
+            return *instructions / *cycles;
+        }
+
+        [[nodiscard]] event_counts per(const double n) const noexcept
+        {
+            const auto div {[=](const std::optional<double> v) {
+                return v ? std::optional{*v / n} : std::nullopt;
+            }};
+            return {div(cycles), div(instructions), div(branch_misses), div(l1d_misses), div(llc_misses)};
+        }
+    };
+
+    // Hardware counters for the calling thread, opened with perf_event_open
+    // on Linux. Each event is opened on its own so that one the kernel
+    // refuses does not take the others with it. Elsewhere, or when
+    // perf_event_paranoid forbids it, nothing is counted.
+    export
+    class perf_counters
+    {
+    public:
+        perf_counters() noexcept;
+        ~perf_counters() noexcept;
+
+        perf_counters(const perf_counters&) = delete;
+        perf_counters& operator=(const perf_counters&) = delete;
+
+        [[nodiscard]] bool available() const noexcept;
+
+        // Counting accumulates over every start/stop pair
+        void start() noexcept;
+        void stop() noexcept;
+
+        // Totals since construction, scaled up when the kernel had to
+        // multiplex the counters
+        [[nodiscard]] event_counts read() const noexcept;
+    private:
+        static constexpr std::size_t num_events {5};
+        std::array<int, num_events> fds_;
+    };
+}
\ No newline at end of file
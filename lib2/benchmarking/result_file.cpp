@@ -0,0 +1,507 @@
+module lib2.benchmarking;
+
+import std;
+
+import lib2.io;
+import lib2.fmt;
+
+import :benchmark_output;
+import :perf_counters;
+import :result_file;
+import :runner;
+import :statistics;
+
+namespace lib2::benchmarking
+{
+    static constexpr std::array<std::string_view, 18> csv_columns {
+        "suite", "name", "samples", "outliers", "batch_size",
+        "min_ns", "median_ns", "p99_ns", "mean_ns", "stddev_ns",
+        "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses",
+        "bytes_per_iteration", "items_per_iteration", "n"
+    };
+
+    // Files written before the throughput and complexity columns were
+    // added have only the columns up to llc_misses
+    static constexpr std::size_t csv_columns_without_n {15};
+
+    static void write_json_string(lib2::text_ostream stream, const std::string_view str)
+    {
+        stream.put('"');
+        for (const char c : str)
+        {
+            switch (c)
+            {
+            case '"':
+                stream.write("\\\"");
+                break;
+            case '\\':
+                stream.write("\\\\");
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    lib2::format_to<"\\u{:0>4x}">(stream, static_cast<unsigned int>(c));
+                }
+                else
+                {
+                    stream.put(c);
+                }
+            }
+        }
+        stream.put('"');
+    }
+
+    // JSON has no NaN or infinity, so those are null like a missing value
+    static void write_json_number(lib2::text_ostream stream, const std::optional<double> value)
+    {
+        if (value && std::isfinite(*value))
+        {
+            lib2::format_to<"{}">(stream, *value);
+        }
+        else
+        {
+            stream.write("null");
+        }
+    }
+
+    void write_json(lib2::text_ostream stream, const std::span<const suite_statistics> suites)
+    {
+        stream.write("{\n  \"suites\": [");
+        for (std::size_t s {0}; s < suites.size(); ++s)
+        {
+            stream.write(s == 0 ? "\n    {\n      \"name\": " : ",\n    {\n      \"name\": ");
+            write_json_string(stream, suites[s].name);
+            stream.write(",\n      \"benchmarks\": [");
+
+            const auto& results {suites[s].results};
+            for (std::size_t b {0}; b < results.size(); ++b)
+            {
+                const auto& [name, stats] {results[b]};
+                stream.write(b == 0 ? "\n        {\"name\": " : ",\n        {\"name\": ");
+                write_json_string(stream, name);
+                lib2::format_to<", \"samples\": {}, \"outliers\": {}, \"batch_size\": {}">(stream, stats.num_samples, stats.num_outliers, stats.batch_size);
+
+                const std::pair<std::string_view, std::optional<double>> numbers[] {
+                    {"min_ns", stats.min.count()},
+                    {"median_ns", stats.median.count()},
+                    {"p99_ns", stats.p99.count()},
+                    {"mean_ns", stats.mean.count()},
+                    {"stddev_ns", stats.stddev.count()},
+                    {"cycles", stats.events.cycles},
+                    {"instructions", stats.events.instructions},
+                    {"branch_misses", stats.events.branch_misses},
+                    {"l1d_misses", stats.events.l1d_misses},
+                    {"llc_misses", stats.events.llc_misses}
+                };
+                for (const auto& [key, value] : numbers)
+                {
+                    lib2::format_to<", \"{}\": ">(stream, key);
+                    write_json_number(stream, value);
+                }
+                lib2::format_to<", \"bytes_per_iteration\": {}, \"items_per_iteration\": {}, \"n\": {}}}">(stream, stats.bytes_per_iteration, stats.items_per_iteration, stats.complexity_n);
+            }
+            stream.write(results.empty() ? "]\n    }" : "\n      ]\n    }");
+        }
+        stream.write(suites.empty() ? "]\n}\n" : "\n  ]\n}\n");
+    }
+
+    static void write_csv_field(lib2::text_ostream stream, const std::string_view field)
+    {
+        if (field.find_first_of(",\"\r\n") == std::string_view::npos)
+        {
+            stream.write(field);
+            return;
+        }
+
+        stream.put('"');
+        for (const char c : field)
+        {
+            if (c == '"')
+            {
+                stream.put('"');
+            }
+            stream.put(c);
+        }
+        stream.put('"');
+    }
+
+    static void write_csv_number(lib2::text_ostream stream, const std::optional<double> value)
+    {
+        stream.put(',');
+        if (value)
+        {
+            lib2::format_to<"{}">(stream, *value);
+        }
+    }
+
+    void write_csv(lib2::text_ostream stream, const std::span<const suite_statistics> suites)
+    {
+        for (std::size_t i {0}; i < csv_columns.size(); ++i)
+        {
+            if (i != 0)
+            {
+                stream.put(',');
+            }
+            stream.write(csv_columns[i]);
+        }
+        stream.put('\n');
+
+        for (const auto& suite : suites)
+        {
+            for (const auto& [name, stats] : suite.results)
+            {
+                write_csv_field(stream, suite.name);
+                stream.put(',');
+                write_csv_field(stream, name);
+                lib2::format_to<",{},{},{},{},{},{},{},{}">(stream, stats.num_samples, stats.num_outliers, stats.batch_size,
+                    stats.min.count(), stats.median.count(), stats.p99.count(), stats.mean.count(), stats.stddev.count());
+                write_csv_number(stream, stats.events.cycles);
+                write_csv_number(stream, stats.events.instructions);
+                write_csv_number(stream, stats.events.branch_misses);
+                write_csv_number(stream, stats.events.l1d_misses);
+                write_csv_number(stream, stats.events.llc_misses);
+                lib2::format_to<",{},{},{}\n">(stream, stats.bytes_per_iteration, stats.items_per_iteration, stats.complexity_n);
+            }
+        }
+    }
+
+    // Splits CSV text into records of fields, handling quoted fields
+    static std::vector<std::vector<std::string>> split_csv(const std::string_view text)
+    {
+        std::vector<std::vector<std::string>> records;
+        std::vector<std::string> record;
+        std::string field;
+        bool quoted {false};
+        bool in_quotes {false};
+
+        const auto end_field {[&] {
+            record.push_back(std::move(field));
+            field.clear();
+            quoted = false;
+        }};
+
+        for (std::size_t i {0}; i < text.size(); ++i)
+        {
+            const char c {text[i]};
+            if (in_quotes)
+            {
+                if (c != '"')
+                {
+                    field += c;
+                }
+                else if (i + 1 < text.size() && text[i + 1] == '"')
+                {
+                    field += '"';
+                    ++i;
+                }
+                else
+                {
+                    in_quotes = false;
+                }
+            }
+            else if (c == '"' && field.empty() && !quoted)
+            {
+                in_quotes = true;
+                quoted = true;
+            }
+            else if (c == ',')
+            {
+                end_field();
+            }
+            else if (c == '\n' || c == '\r')
+            {
+                if (!field.empty() || quoted || !record.empty())
+                {
+                    end_field();
+                    records.push_back(std::move(record));
+                    record.clear();
+                }
+            }
+            else
+            {
+                field += c;
+            }
+        }
+
+        if (in_quotes)
+        {
+            throw std::invalid_argument{"Unterminated quote in CSV results"};
+        }
+
+        if (!field.empty() || quoted || !record.empty())
+        {
+            end_field();
+            records.push_back(std::move(record));
+        }
+        return records;
+    }
+
+    template<class T>
+    static T parse_csv_number(const std::string_view field)
+    {
+        T value {};
+        const auto [ptr, ec] {std::from_chars(field.data(), field.data() + field.size(), value)};
+        if (ec != std::errc{} || ptr != field.data() + field.size())
+        {
+            throw std::invalid_argument{"Invalid number in CSV results"};
+        }
+        return value;
+    }
+
+    static std::optional<double> parse_csv_count(const std::string_view field)
+    {
+        if (field.empty())
+        {
+            return std::nullopt;
+        }
+        return parse_csv_number<double>(field);
+    }
+
+    std::vector<suite_statistics> parse_csv_results(const std::string_view text)
+    {
+        const auto records {split_csv(text)};
+        const auto num_columns {records.empty() ? 0 : records.front().size()};
+        if ((num_columns != csv_columns.size() && num_columns != csv_columns_without_n) ||
+            !std::ranges::equal(records.front(), csv_columns | std::views::take(num_columns)))
+        {
+            throw std::invalid_argument{"Missing CSV results header"};
+        }
+
+        const auto parse_optional_column {[&](const std::vector<std::string>& record, const std::size_t column) {
+            return column < num_columns ? parse_csv_number<std::size_t>(record[column]) : std::size_t{0};
+        }};
+
+        std::vector<suite_statistics> suites;
+        for (const auto& record : records | std::views::drop(1))
+        {
+            if (record.size() != num_columns)
+            {
+                throw std::invalid_argument{"Wrong number of fields in CSV results"};
+            }
+
+            auto suite {std::ranges::find(suites, record[0], &suite_statistics::name)};
+            if (suite == suites.end())
+            {
+                suite = suites.insert(suites.end(), suite_statistics{.name = record[0]});
+            }
+
+            benchmark_statistics stats {
+                .num_samples  = parse_csv_number<std::size_t>(record[2]),
+                .num_outliers = parse_csv_number<std::size_t>(record[3]),
+                .batch_size   = parse_csv_number<std::size_t>(record[4]),
+                .min          = fractional_nanoseconds{parse_csv_number<double>(record[5])},
+                .median       = fractional_nanoseconds{parse_csv_number<double>(record[6])},
+                .p99          = fractional_nanoseconds{parse_csv_number<double>(record[7])},
+                .mean         = fractional_nanoseconds{parse_csv_number<double>(record[8])},
+                .stddev       = fractional_nanoseconds{parse_csv_number<double>(record[9])},
+                .events       = {
+                    .cycles        = parse_csv_count(record[10]),
+                    .instructions  = parse_csv_count(record[11]),
+                    .branch_misses = parse_csv_count(record[12]),
+                    .l1d_misses    = parse_csv_count(record[13]),
+                    .llc_misses    = parse_csv_count(record[14])
+                },
+                .bytes_per_iteration = parse_optional_column(record, 15),
+                .items_per_iteration = parse_optional_column(record, 16),
+                .complexity_n        = parse_optional_column(record, 17)
+            };
+            suite->results.emplace_back(record[1], stats);
+        }
+        return suites;
+    }
+
+    std::vector<suite_statistics> load_csv_results(const std::filesystem::path& path)
+    {
+        lib2::ifstream file {path};
+
+        std::string text;
+        std::array<std::byte, 4096> buf;
+        while (const auto count {file.read(buf.data(), buf.size())})
+        {
+            text.append(reinterpret_cast<const char*>(buf.data()), count);
+        }
+        return parse_csv_results(text);
+    }
+
+    std::vector<benchmark_comparison> compare_results(const std::span<const suite_statistics> baseline, const std::span<const suite_statistics> current, const comparison_options& options)
+    {
+        std::vector<benchmark_comparison> comparisons;
+        for (const auto& suite : current)
+        {
+            const auto base_suite {std::ranges::find(baseline, suite.name, &suite_statistics::name)};
+            if (base_suite == baseline.end())
+            {
+                continue;
+            }
+
+            for (const auto& [name, stats] : suite.results)
+            {
+                const auto base {std::ranges::find(base_suite->results, name, [](const auto& result) -> const std::string& { return result.first; })};
+                if (base == base_suite->results.end())
+                {
+                    continue;
+                }
+
+                const auto& base_stats {base->second};
+                const auto base_mean {base_stats.mean.count()};
+                if (base_mean <= 0 || base_stats.num_samples == 0 || stats.num_samples == 0)
+                {
+                    continue;
+                }
+
+                const auto variance {[](const benchmark_statistics& s) {
+                    return s.stddev.count() * s.stddev.count() / static_cast<double>(s.num_samples);
+                }};
+                const auto delta {stats.mean.count() - base_mean};
+                const auto margin {options.z * std::sqrt(variance(base_stats) + variance(stats))};
+
+                benchmark_comparison comparison {
+                    .suite       = suite.name,
+                    .name        = name,
+                    .baseline    = base_stats.mean,
+                    .current     = stats.mean,
+                    .change      = delta / base_mean,
+                    .change_low  = (delta - margin) / base_mean,
+                    .change_high = (delta + margin) / base_mean
+                };
+                comparison.regression = comparison.change_low > 0 && comparison.change > options.min_relative_change;
+                comparison.improvement = comparison.change_high < 0 && comparison.change < -options.min_relative_change;
+                comparisons.push_back(std::move(comparison));
+            }
+        }
+        return comparisons;
+    }
+
+    void print_comparison(lib2::text_ostream stream, const std::span<const benchmark_comparison> comparisons)
+    {
+        constexpr std::array<std::string_view, 5> headers {"Baseline", "Current", "Change", "Interval", "Verdict"};
+
+        std::vector<std::pair<std::string, std::array<std::string, headers.size()>>> rows;
+        rows.reserve(comparisons.size());
+
+        std::size_t name_column_width {9};
+        std::array<std::size_t, headers.size()> column_widths;
+        std::ranges::transform(headers, column_widths.begin(), [](const auto header) { return header.size(); });
+
+        for (const auto& comparison : comparisons)
+        {
+            auto& [name, row] {rows.emplace_back()};
+            name = comparison.suite.empty() ? comparison.name : lib2::format<"{}/{}">(comparison.suite, comparison.name);
+            row[0] = lib2::format<"{:.2f}ns">(comparison.baseline.count());
+            row[1] = lib2::format<"{:.2f}ns">(comparison.current.count());
+            row[2] = lib2::format<"{:+.2f}%">(comparison.change * 100);
+            row[3] = lib2::format<"[{:+.2f}%, {:+.2f}%]">(comparison.change_low * 100, comparison.change_high * 100);
+            row[4] = comparison.regression ? "regression" : comparison.improvement ? "improvement" : "";
+
+            name_column_width = std::max(name_column_width, name.size());
+            for (std::size_t i {0}; i < row.size(); ++i)
+            {
+                column_widths[i] = std::max(column_widths[i], row[i].size());
+            }
+        }
+
+        const auto banner_width {name_column_width + std::ranges::fold_left(column_widths, std::size_t{0}, [](const auto total, const auto width) { return total + 1 + width; })};
+
+        stream.fill('-', banner_width);
+        lib2::format_to<"\n{:<{}}">(stream, "Benchmark", name_column_width);
+        for (std::size_t i {0}; i < headers.size(); ++i)
+        {
+            lib2::format_to<" {:>{}}">(stream, headers[i], column_widths[i]);
+        }
+        stream.put('\n');
+        stream.fill('-', banner_width);
+        stream.put('\n');
+
+        for (const auto& [name, row] : rows)
+        {
+            lib2::format_to<"{:<{}}">(stream, name, name_column_width);
+            for (std::size_t i {0}; i < row.size(); ++i)
+            {
+                lib2::format_to<" {:>{}}">(stream, row[i], column_widths[i]);
+            }
+            stream.put('\n');
+        }
+    }
+
+    int benchmark_main(const benchmark_runner& runner, const int argc, const char* const* const argv)
+    {
+        std::optional<std::string_view> json_path;
+        std::optional<std::string_view> csv_path;
+        std::optional<std::string_view> baseline_path;
+        comparison_options options;
+
+        for (int i {1}; i < argc; ++i)
+        {
+            const std::string_view arg {argv[i]};
+            const auto value {arg.substr(std::min(arg.find('=') + 1, arg.size()))};
+
+            if (arg.starts_with("--json="))
+            {
+                json_path = value;
+            }
+            else if (arg.starts_with("--csv="))
+            {
+                csv_path = value;
+            }
+            else if (arg.starts_with("--baseline="))
+            {
+                baseline_path = value;
+            }
+            else if (arg.starts_with("--threshold="))
+            {
+                const auto [ptr, ec] {std::from_chars(value.data(), value.data() + value.size(), options.min_relative_change)};
+                if (ec != std::errc{} || ptr != value.data() + value.size())
+                {
+                    lib2::format_to<"Invalid threshold: {}\n">(lib2::cerr, value);
+                    return 2;
+                }
+            }
+            else
+            {
+                lib2::format_to<"Unknown argument: {}\n">(lib2::cerr, arg);
+                return 2;
+            }
+        }
+
+        // Read first so that a bad baseline fails before the long run
+        std::vector<suite_statistics> baseline;
+        if (baseline_path)
+        {
+            try
+            {
+                baseline = load_csv_results(std::filesystem::path{*baseline_path});
+            }
+            catch (const std::exception& e)
+            {
+                lib2::format_to<"Invalid baseline {}: {}\n">(lib2::cerr, *baseline_path, e.what());
+                return 2;
+            }
+        }
+
+        const auto results {runner.run()};
+        print_statistics(results);
+
+        if (json_path)
+        {
+            lib2::ofstream file {std::filesystem::path{*json_path}};
+            write_json(file, results);
+        }
+
+        if (csv_path)
+        {
+            lib2::ofstream file {std::filesystem::path{*csv_path}};
+            write_csv(file, results);
+        }
+
+        if (!baseline_path)
+        {
+            return 0;
+        }
+
+        const auto comparisons {compare_results(baseline, results, options)};
+        lib2::format_to<"Compared with {}:\n">(lib2::cout, *baseline_path);
+        print_comparison(lib2::cout, comparisons);
+
+        return std::ranges::any_of(comparisons, &benchmark_comparison::regression) ? 1 : 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+export module lib2.benchmarking:result_file;
+
+import std;
+
+import lib2.io;
+
+import :runner;
+import :statistics;
+
+namespace lib2::benchmarking
+{
+    // Results as JSON or CSV, one record per benchmark. Times are per
+    // iteration in nanoseconds and event counts that were not captured
+    // are null in JSON and empty in CSV. JSON has no NaN or infinity, so
+    // those are null as well.
+    export
+    void write_json(lib2::text_ostream stream, std::span<const suite_statistics> suites);
+
+    export
+    void write_csv(lib2::text_ostream stream, std::span<const suite_statistics> suites);
+
+    // Reads back what write_csv wrote, including files from before the
+    // bytes_per_iteration, items_per_iteration and n columns, throwing
+    // std::invalid_argument on anything else
+    export
+    [[nodiscard]] std::vector<suite_statistics> parse_csv_results(std::string_view text);
+
+    export
+    [[nodiscard]] std::vector<suite_statistics> load_csv_results(const std::filesystem::path& path);
+
+    export
+    struct comparison_options
+    {
+        // Two-sided normal quantile of the confidence interval, 1.96 for 95%
+        double z {1.96};
+
+        // Changes smaller than this fraction of the baseline are noise even
+        // when they are statistically significant
+        double min_relative_change {0.02};
+    };
+
+    export
+    struct benchmark_comparison
+    {
+        std::string suite;
+        std::string name;
+        fractional_nanoseconds baseline {0};
+        fractional_nanoseconds current {0};
+
+        // Change of the mean relative to the baseline, with its confidence
+        // interval
+        double change {0};
+        double change_low {0};
+        double change_high {0};
+
+        bool regression {false};
+        bool improvement {false};
+    };
+
+    // Matches benchmarks by suite and name and compares their means with a
+    // Welch interval. Benchmarks missing from either side are skipped.
+    export
+    [[nodiscard]] std::vector<benchmark_comparison> compare_results(std::span<const suite_statistics> baseline, std::span<const suite_statistics> current, const comparison_options& options = {});
+
+    export
+    void print_comparison(lib2::text_ostream stream, std::span<const benchmark_comparison> comparisons);
+
+    // Runs the suites, prints them and then handles the arguments
+    //     --json=<file>      write the results as JSON
+    //     --csv=<file>       write the results as CSV
+    //     --baseline=<file>  compare against an earlier CSV file
+    //     --threshold=<x>    min_relative_change for the comparison
+    // Returns 1 when the comparison finds a regression, and 2 on bad
+    // arguments or a baseline that cannot be read.
+    export
+    int benchmark_main(const benchmark_runner& runner, int argc, const char* const* argv);
+}
\ No newline at end of file
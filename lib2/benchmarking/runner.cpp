@@ -0,0 +1,197 @@
+module;
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+module lib2.benchmarking;
+
+import std;
+
+import lib2.utility;
+
+import :perf_counters;
+import :runner;
+import :statistics;
+
+namespace lib2::benchmarking
+{
+    static constexpr std::size_t max_batch_size {std::size_t{1} << 30};
+
+    static std::chrono::nanoseconds time_batch(benchmark& bench, const std::size_t batch_size)
+    {
+        const lib2::stopwatch stopwatch;
+        for (std::size_t i {0}; i < batch_size; ++i)
+        {
+            bench();
+        }
+        return stopwatch.elapsed_time();
+    }
+
+    static std::size_t calibrate_batch_size(benchmark& bench, const run_options& options)
+    {
+        if (options.batch_size != 0)
+        {
+            return options.batch_size;
+        }
+
+        std::size_t batch_size {1};
+        while (batch_size < max_batch_size && time_batch(bench, batch_size) < options.min_batch_time)
+        {
+            batch_size *= 2;
+        }
+        return batch_size;
+    }
+
+    benchmark_statistics run_statistics(benchmark& bench, const run_options& options)
+    {
+        std::vector<double> samples;
+        std::size_t batch_size {1};
+
+        // Counters are switched on and off outside the timed region, so
+        // their syscalls do not show up in the samples
+        std::optional<perf_counters> counters;
+        if (options.count_events)
+        {
+            counters.emplace();
+        }
+        const bool counting {counters && counters->available()};
+
+        bench.setup();
+
+        try
+        {
+            const lib2::stopwatch warmup;
+            while (warmup.elapsed_time() < options.warmup_time)
+            {
+                bench();
+            }
+
+            batch_size = calibrate_batch_size(bench, options);
+
+            const lib2::stopwatch total;
+            while (samples.size() < options.max_samples &&
+                   (samples.size() < options.min_samples || total.elapsed_time() < options.min_time))
+            {
+                if (counting)
+                {
+                    counters->start();
+                }
+
+                const auto elapsed {time_batch(bench, batch_size)};
+
+                if (counting)
+                {
+                    counters->stop();
+                }
+
+                samples.push_back(fractional_nanoseconds{elapsed}.count() / static_cast<double>(batch_size));
+            }
+        }
+        catch (...)
+        {
+            bench.tear_down();
+            throw;
+        }
+
+        bench.tear_down();
+
+        auto stats {compute_statistics(std::move(samples), batch_size, options.outlier_fence)};
+        stats.bytes_per_iteration = bench.bytes_per_iteration();
+        stats.items_per_iteration = bench.items_per_iteration();
+        stats.complexity_n = bench.complexity_n();
+
+        if (counting && stats.num_iterations() != 0)
+        {
+            stats.events = counters->read().per(static_cast<double>(stats.num_iterations()));
+        }
+        return stats;
+    }
+
+    bool pin_current_thread(const std::size_t core) noexcept
+    {
+#if defined(_WIN32)
+        if (core >= sizeof(DWORD_PTR) * 8)
+        {
+            return false;
+        }
+        return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << core) != 0;
+#elif defined(__linux__)
+        if (core >= CPU_SETSIZE)
+        {
+            return false;
+        }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        return false;
+#endif
+    }
+
+    suite_statistics benchmark_runner::run_suite(const std::pair<std::string, benchmark_suite*>& suite) const
+    {
+        suite_statistics stats {.name = suite.first};
+        for (auto& bench : *suite.second)
+        {
+            stats.results.emplace_back(bench.name(), run_statistics(bench, options_));
+        }
+        return stats;
+    }
+
+    std::vector<suite_statistics> benchmark_runner::run() const
+    {
+        std::vector<suite_statistics> results(suites_.size());
+
+        if (cores_.empty())
+        {
+            for (std::size_t i {0}; i < suites_.size(); ++i)
+            {
+                results[i] = run_suite(suites_[i]);
+            }
+            return results;
+        }
+
+        const auto num_threads {std::min(cores_.size(), suites_.size())};
+        std::vector<std::exception_ptr> errors(num_threads);
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(num_threads);
+            for (std::size_t t {0}; t < num_threads; ++t)
+            {
+                threads.emplace_back([&, t] {
+                    try
+                    {
+                        const auto pinned {pin_current_thread(cores_[t])};
+                        for (std::size_t i {t}; i < suites_.size(); i += num_threads)
+                        {
+                            results[i] = run_suite(suites_[i]);
+                            results[i].core = cores_[t];
+                            results[i].pinned = pinned;
+                        }
+                    }
+                    catch (...)
+                    {
+                        errors[t] = std::current_exception();
+                    }
+                });
+            }
+        }
+
+        for (const auto& error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+        return results;
+    }
+}
\ No newline at end of file
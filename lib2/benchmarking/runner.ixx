@@ -0,0 +1,88 @@
+export module lib2.benchmarking:runner;
+
+import std;
+
+import :benchmark;
+import :benchmark_suite;
+import :statistics;
+
+namespace lib2::benchmarking
+{
+    export
+    struct run_options
+    {
+        // Time spent running the benchmark untimed before sampling, to warm
+        // up caches, branch predictors and the clock frequency
+        std::chrono::nanoseconds warmup_time {std::chrono::milliseconds{100}};
+
+        // Sampling goes on until both of these are reached
+        std::chrono::nanoseconds min_time {std::chrono::seconds{1}};
+        std::size_t min_samples {100};
+        std::size_t max_samples {1'000'000};
+
+        // Iterations timed together per sample. 0 picks the smallest power
+        // of two whose batch takes at least min_batch_time, so the cost of
+        // reading the clock is spread over the batch.
+        std::size_t batch_size {0};
+        std::chrono::nanoseconds min_batch_time {std::chrono::microseconds{20}};
+
+        // See compute_statistics, 0 keeps every sample
+        double outlier_fence {1.5};
+
+        // Count hardware events around each batch, where perf_counters
+        // are available
+        bool count_events {false};
+    };
+
+    export
+    benchmark_statistics run_statistics(benchmark& bench, const run_options& options);
+
+    // Pins the calling thread to a logical core. Returns false where that
+    // is not supported or the core does not exist.
+    export
+    bool pin_current_thread(std::size_t core) noexcept;
+
+    export
+    struct suite_statistics
+    {
+        std::string name;
+        std::vector<std::pair<std::string, benchmark_statistics>> results;
+
+        // The core the suite ran on when the runner was given cores, and
+        // whether its thread was actually pinned there
+        std::optional<std::size_t> core;
+        bool pinned {false};
+    };
+
+    // Runs suites of benchmarks and collects the statistics of each
+    // benchmark. Without cores the suites run one after another on the
+    // calling thread. With cores, each core gets a thread pinned to it and
+    // the suites are shared out between them round robin, so suites that
+    // do not contend for memory bandwidth can run side by side.
+    export
+    class benchmark_runner
+    {
+    public:
+        explicit benchmark_runner(const run_options& options = {}, std::vector<std::size_t> cores = {})
+            : options_{options}
+            , cores_{std::move(cores)} {}
+
+        void add_suite(std::string name, benchmark_suite& suite)
+        {
+            suites_.emplace_back(std::move(name), &suite);
+        }
+
+        [[nodiscard]] const run_options& options() const noexcept
+        {
+            return options_;
+        }
+
+        [[nodiscard]] std::vector<suite_statistics> run() const;
+    private:
+        run_options options_;
+        std::vector<std::size_t> cores_;
+        std::vector<std::pair<std::string, benchmark_suite*>> suites_;
+
+        suite_statistics run_suite(const std::pair<std::string, benchmark_suite*>& suite) const;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+export module lib2.benchmarking:statistics;
+
+import std;
+
+import :perf_counters;
+
+namespace lib2::benchmarking
+{
+    // Per-iteration times can be fractions of a nanosecond once iterations
+    // are timed in batches
+    export
+    using fractional_nanoseconds = std::chrono::duration<double, std::nano>;
+
+    // Summary of the per-iteration samples of a benchmark after outliers
+    // are dropped
+    export
+    struct benchmark_statistics
+    {
+        std::size_t num_samples {0};
+        std::size_t num_outliers {0};
+        std::size_t batch_size {1};
+        fractional_nanoseconds min {0};
+        fractional_nanoseconds median {0};
+        fractional_nanoseconds p99 {0};
+        fractional_nanoseconds mean {0};
+        fractional_nanoseconds stddev {0};
+        event_counts events;
+
+        // Copied from the benchmark, see benchmark::bytes_per_iteration
+        std::size_t bytes_per_iteration {0};
+        std::size_t items_per_iteration {0};
+        std::size_t complexity_n {0};
+
+        [[nodiscard]] std::size_t num_iterations() const noexcept
+        {
+            return (num_samples + num_outliers) * batch_size;
+        }
+    };
+
+    // Linearly interpolated quantile of sorted samples, the usual estimate
+    // of R and NumPy. Shared by the statistics and latency percentiles so
+    // that a p99 means the same thing in both.
+    export
+    template<class T>
+    [[nodiscard]] double quantile(const std::span<const T> sorted, const double q) noexcept
+    {
+        const auto value {[&](const std::size_t i) -> double {
+            if constexpr (std::is_arithmetic_v<T>)
+            {
+                return static_cast<double>(sorted[i]);
+            }
+            else
+            {
+                return static_cast<double>(sorted[i].count());
+            }
+        }};
+
+        const auto pos {q * static_cast<double>(sorted.size() - 1)};
+        const auto i {static_cast<std::size_t>(pos)};
+        if (i + 1 >= sorted.size())
+        {
+            return value(sorted.size() - 1);
+        }
+        return value(i) + (pos - static_cast<double>(i)) * (value(i + 1) - value(i));
+    }
+
+    // Samples outside of Tukey's fences, outlier_fence interquartile ranges
+    // beyond the quartiles, are dropped. Scheduling and interrupts only
+    // ever make samples slower so this mostly trims the upper end.
+    export
+    benchmark_statistics compute_statistics(std::vector<double> samples, const std::size_t batch_size, const double outlier_fence)
+    {
+        if (samples.empty())
+        {
+            return {.batch_size = batch_size};
+        }
+
+        std::ranges::sort(samples);
+
+        const auto total {samples.size()};
+        if (outlier_fence > 0 && samples.size() >= 4)
+        {
+            const auto q1 {quantile<double>(samples, 0.25)};
+            const auto q3 {quantile<double>(samples, 0.75)};
+            const auto iqr {q3 - q1};
+            const auto low {std::ranges::lower_bound(samples, q1 - outlier_fence * iqr)};
+            const auto high {std::ranges::upper_bound(samples, q3 + outlier_fence * iqr)};
+            samples.erase(high, samples.end());
+            samples.erase(samples.begin(), low);
+        }
+
+        const auto n {static_cast<double>(samples.size())};
+        const auto mean {std::ranges::fold_left(samples, 0.0, std::plus{}) / n};
+        const auto sum_squares {std::ranges::fold_left(samples, 0.0, [=](const double acc, const double x) {
+            return acc + (x - mean) * (x - mean);
+        })};
+
+        return {
+            .num_samples  = samples.size(),
+            .num_outliers = total - samples.size(),
+            .batch_size   = batch_size,
+            .min          = fractional_nanoseconds{samples.front()},
+            .median       = fractional_nanoseconds{quantile<double>(samples, 0.5)},
+            .p99          = fractional_nanoseconds{quantile<double>(samples, 0.99)},
+            .mean         = fractional_nanoseconds{mean},
+            .stddev       = fractional_nanoseconds{samples.size() > 1 ? std::sqrt(sum_squares / (n - 1)) : 0.0}
+        };
+    }
+}
\ No newline at end of file
@@ -1,7 +1,15 @@
+module;
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIB2_FMT_SSE2
+#endif
+
 export module lib2.fmt:arithmetic;
 
 import std;
 
+import lib2.platform;
 import lib2.strings;
 import lib2.io;
 
@@ -10,6 +18,7 @@ import :context;
 import :parsers;
 import :format;
 import :string;
+import :floating;
 
 namespace lib2
 {
@@ -87,44 +96,165 @@ namespace lib2
         return end;
     }
 
+    constexpr auto base10_digit_count_table {[] {
+        std::array<std::uint64_t, 32> table {};
+        for (std::size_t i {0}; i < table.size(); ++i)
+        {
+            const std::uint64_t smallest {std::uint64_t{1} << i};
+            std::uint64_t digits {1};
+            std::uint64_t next_power {10};
+            while (next_power <= smallest)
+            {
+                ++digits;
+                next_power *= 10;
+            }
+
+            table[i] = (digits << 32) + (next_power < (std::uint64_t{1} << 32) ? (std::uint64_t{1} << 32) - next_power : 0);
+        }
+        return table;
+    }()};
+
+    constexpr auto base10_powers {[] {
+        std::array<std::uint64_t, 20> table {};
+        std::uint64_t power {1};
+        for (auto& p : table)
+        {
+            p = power;
+            power *= 10;
+        }
+        return table;
+    }()};
+
+    // Branch free: the 32-bit version bumps the digit count of the lowest
+    // value with the same bit width when val reaches the next power of ten,
+    // the 64-bit version estimates log10 from log2 and corrects it
     template<std::unsigned_integral T>
-    constexpr char* to_chars_base10(char* const, char* end, T val) noexcept
+    constexpr int count_digits_base10(const T val) noexcept
     {
-        constexpr unsigned char digit_table[][3] {
-            "00", "01", "02", "03",
-            "04", "05", "06", "07",
-            "08", "09", "10", "11",
-            "12", "13", "14", "15",
-            "16", "17", "18", "19",
-            "20", "21", "22", "23",
-            "24", "25", "26", "27",
-            "28", "29", "30", "31",
-            "32", "33", "34", "35",
-            "36", "37", "38", "39",
-            "40", "41", "42", "43",
-            "44", "45", "46", "47",
-            "48", "49", "50", "51",
-            "52", "53", "54", "55",
-            "56", "57", "58", "59",
-            "60", "61", "62", "63",
-            "64", "65", "66", "67",
-            "68", "69", "70", "71",
-            "72", "73", "74", "75",
-            "76", "77", "78", "79",
-            "80", "81", "82", "83",
-            "84", "85", "86", "87",
-            "88", "89", "90", "91",
-            "92", "93", "94", "95",
-            "96", "97", "98", "99"
-        };
+        if constexpr (sizeof(T) <= sizeof(std::uint32_t))
+        {
+            return static_cast<int>((val + base10_digit_count_table[log2_floor(val)]) >> 32);
+        }
+        else
+        {
+            const auto t {((log2_floor(val) + 1) * 1233) >> 12};
+            return t - ((val | 1) < base10_powers[t]) + 1;
+        }
+    }
+
+#if defined(LIB2_FMT_SSE2)
+    // The eight digits of val < 10^8, one per 16-bit lane, most
+    // significant first
+    inline __m128i base10_digits_sse2(const std::uint32_t val) noexcept
+    {
+        // abcd, efgh = abcdefgh divmod 10000
+        const auto abcdefgh {_mm_cvtsi32_si128(static_cast<int>(val))};
+        const auto abcd {_mm_srli_epi64(_mm_mul_epu32(abcdefgh, _mm_set1_epi32(static_cast<int>(0xD1B71759))), 45)};
+        const auto efgh {_mm_sub_epi32(abcdefgh, _mm_mul_epu32(abcd, _mm_set1_epi32(10000)))};
+
+        // [abcd * 4 x4, efgh * 4 x4]
+        const auto v1 {_mm_slli_epi64(_mm_unpacklo_epi16(abcd, efgh), 2)};
+        const auto v2 {_mm_unpacklo_epi16(v1, v1)};
+        const auto v3 {_mm_unpacklo_epi32(v2, v2)};
+
+        // [a, ab, abc, abcd, e, ef, efg, efgh] by multiplying with the
+        // reciprocals of 1000, 100, 10 and 1 then shifting back down
+        const auto v4 {_mm_mulhi_epu16(v3, _mm_setr_epi16(8389, 5243, 13108, -32768, 8389, 5243, 13108, -32768))};
+        const auto v5 {_mm_mulhi_epu16(v4, _mm_setr_epi16(1 << 7, 1 << 11, 1 << 13, -32768, 1 << 7, 1 << 11, 1 << 13, -32768))};
+
+        // Subtract ten times the previous lane to leave a single digit
+        const auto v6 {_mm_slli_epi64(_mm_mullo_epi16(v5, _mm_set1_epi16(10)), 16)};
+        return _mm_sub_epi16(v5, v6);
+    }
+
+    inline void write_8_digits_base10(char* const dest, const std::uint32_t val) noexcept
+    {
+        const auto digits {_mm_packus_epi16(base10_digits_sse2(val), _mm_setzero_si128())};
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), _mm_add_epi8(digits, _mm_set1_epi8('0')));
+    }
+
+    inline void write_16_digits_base10(char* const dest, const std::uint64_t val) noexcept
+    {
+        const auto high {base10_digits_sse2(static_cast<std::uint32_t>(val / 100000000))};
+        const auto low {base10_digits_sse2(static_cast<std::uint32_t>(val % 100000000))};
+        const auto digits {_mm_packus_epi16(high, low)};
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_add_epi8(digits, _mm_set1_epi8('0')));
+    }
+#else
+    // The eight digits of val < 10^8 as ASCII, packed into a 64-bit word
+    // in memory order. Each step splits every lane in two with a
+    // multiply-shift in place of a division.
+    inline std::uint64_t base10_digits_swar(const std::uint32_t val) noexcept
+    {
+        const std::uint64_t high {val / 10000};
+        const std::uint64_t low {val % 10000};
+
+        // [abcd, efgh] -> [ab, cd, ef, gh]
+        const auto merged {high | (low << 32)};
+        const auto hundreds {((merged * 10486) >> 20) & ((0x7FULL << 32) | 0x7FULL)};
+        const auto pairs {((merged - 100 * hundreds) << 16) + hundreds};
+
+        // [ab, cd, ef, gh] -> [a, b, c, d, e, f, g, h]
+        auto tens {((pairs * 103) >> 10) & 0x000F000F000F000FULL};
+        tens += (pairs - 10 * tens) << 8;
+        return tens + 0x3030303030303030ULL;
+    }
 
+    inline void write_8_digits_base10(char* const dest, const std::uint32_t val) noexcept
+    {
+        auto digits {base10_digits_swar(val)};
+        if constexpr (std::endian::native == std::endian::big)
+        {
+            digits = std::byteswap(digits);
+        }
+        std::memcpy(dest, &digits, sizeof(digits));
+    }
+
+    inline void write_16_digits_base10(char* const dest, const std::uint64_t val) noexcept
+    {
+        write_8_digits_base10(dest, static_cast<std::uint32_t>(val / 100000000));
+        write_8_digits_base10(dest + 8, static_cast<std::uint32_t>(val % 100000000));
+    }
+#endif
+
+    constexpr unsigned char base10_digit_pairs[][3] {
+        "00", "01", "02", "03",
+        "04", "05", "06", "07",
+        "08", "09", "10", "11",
+        "12", "13", "14", "15",
+        "16", "17", "18", "19",
+        "20", "21", "22", "23",
+        "24", "25", "26", "27",
+        "28", "29", "30", "31",
+        "32", "33", "34", "35",
+        "36", "37", "38", "39",
+        "40", "41", "42", "43",
+        "44", "45", "46", "47",
+        "48", "49", "50", "51",
+        "52", "53", "54", "55",
+        "56", "57", "58", "59",
+        "60", "61", "62", "63",
+        "64", "65", "66", "67",
+        "68", "69", "70", "71",
+        "72", "73", "74", "75",
+        "76", "77", "78", "79",
+        "80", "81", "82", "83",
+        "84", "85", "86", "87",
+        "88", "89", "90", "91",
+        "92", "93", "94", "95",
+        "96", "97", "98", "99"
+    };
+
+    template<std::unsigned_integral T>
+    constexpr char* to_chars_base10_scalar(char* end, T val) noexcept
+    {
         while (val >= 100)
         {
             const auto remainder {val % 100};
             val /= 100;
             end -= 2;
-            end[0] = digit_table[remainder][0];
-            end[1] = digit_table[remainder][1];
+            end[0] = base10_digit_pairs[remainder][0];
+            end[1] = base10_digit_pairs[remainder][1];
         }
 
         if (val < 10)
@@ -134,8 +264,83 @@ namespace lib2
         else
         {
             end -= 2;
-            end[0] = digit_table[val][0];
-            end[1] = digit_table[val][1];
+            end[0] = base10_digit_pairs[val][0];
+            end[1] = base10_digit_pairs[val][1];
+        }
+
+        return end;
+    }
+
+    // Outside of constant evaluation 32 and 64-bit values are written in
+    // whole blocks of 8 or 16 digits, zero padded on the left. The buffer
+    // must therefore hold the widest value of T before `end`.
+    template<std::unsigned_integral T>
+    constexpr char* to_chars_base10(char* const, char* const end, const T val) noexcept
+    {
+        if consteval
+        {
+            return to_chars_base10_scalar(end, val);
+        }
+        else
+        {
+            if constexpr (sizeof(T) < sizeof(std::uint32_t) || sizeof(T) > sizeof(std::uint64_t))
+            {
+                return to_chars_base10_scalar(end, val);
+            }
+            else
+            {
+                if (val < 100)
+                {
+                    return to_chars_base10_scalar(end, val);
+                }
+
+                const auto digits {count_digits_base10(val)};
+                if (val < 100000000)
+                {
+                    write_8_digits_base10(end - 8, static_cast<std::uint32_t>(val));
+                }
+                else if constexpr (sizeof(T) == sizeof(std::uint32_t))
+                {
+                    write_8_digits_base10(end - 8, static_cast<std::uint32_t>(val % 100000000));
+                    to_chars_base10_scalar(end - 8, val / 100000000);
+                }
+                else
+                {
+                    if (val < 10000000000000000)
+                    {
+                        write_16_digits_base10(end - 16, val);
+                    }
+                    else
+                    {
+                        write_16_digits_base10(end - 16, val % 10000000000000000);
+                        to_chars_base10_scalar(end - 16, val / 10000000000000000);
+                    }
+                }
+
+                return end - digits;
+            }
+        }
+    }
+
+    // Writes the low width digits of val at begin, zero padded on the
+    // left, and returns the end of them
+    template<std::unsigned_integral T>
+    constexpr char* to_chars_base10_fixed(char* const begin, T val, const int width) noexcept
+    {
+        const auto end {begin + width};
+        auto it {end};
+        while (it - begin >= 2)
+        {
+            const auto remainder {val % 100};
+            val /= 100;
+            it -= 2;
+            it[0] = base10_digit_pairs[remainder][0];
+            it[1] = base10_digit_pairs[remainder][1];
+        }
+
+        if (it != begin)
+        {
+            *--it = static_cast<char>('0' + val % 10);
         }
 
         return end;
@@ -578,32 +783,49 @@ namespace lib2
             }
         }
 
+        static constexpr std::size_t max_default_size {std::numeric_limits<T>::digits10 + 1 + std::signed_integral<T>};
+
         static void default_format(const T val, format_context& ctx)
         {
-            char buf[std::numeric_limits<T>::digits10 + 1 + std::signed_integral<T>];
-            char* begin;
+            char buf[max_default_size];
+            const auto begin {default_chars(buf, val)};
+            ctx.stream.write(std::string_view{begin, std::ranges::end(buf)});
+        }
 
+        static char* default_format_to(char* const out, const T val) noexcept
+        {
+            // to_chars_base10 pads whole blocks to the left of the digits,
+            // so they can not be written in place after earlier output
+            char buf[max_default_size];
+            const auto begin {default_chars(buf, val)};
+            return std::copy(begin, std::ranges::end(buf), out);
+        }
+    private:
+        static char* default_chars(char (&buf)[max_default_size], const T val) noexcept
+        {
             if constexpr (std::unsigned_integral<T>)
             {
-                begin = to_chars_base10(buf, std::ranges::end(buf), val);
+                return to_chars_base10(buf, std::ranges::end(buf), val);
             }
             else
             {
                 if (val < 0)
                 {
-                    begin = to_chars_base10(buf, std::ranges::end(buf), std::make_unsigned_t<T>(-val));
-                    *--begin = '-';
-                }
-                else
-                {
-                    begin = to_chars_base10(buf, std::ranges::end(buf), std::make_unsigned_t<T>(val));
+                    // Negated as unsigned so the minimum value does not overflow
+                    const auto begin {to_chars_base10(buf, std::ranges::end(buf), static_cast<std::make_unsigned_t<T>>(0 - static_cast<std::make_unsigned_t<T>>(val)))};
+                    *(begin - 1) = '-';
+                    return begin - 1;
                 }
+                return to_chars_base10(buf, std::ranges::end(buf), std::make_unsigned_t<T>(val));
             }
-
-            ctx.stream.write(std::string_view{begin, std::ranges::end(buf)});
         }
     };
 
+    // Types handled by to_chars_shortest and to_chars_fixed; long double
+    // goes through std::to_chars
+    template<class F>
+    concept native_floating_point = std::same_as<F, float> || std::same_as<F, double>;
+
     export
     template<std::floating_point F>
     struct formatter<F> : public width_parser, public precision_parser
@@ -668,38 +890,51 @@ namespace lib2
             const auto precision {this->get_precision(ctx)};
 
             constexpr std::size_t extra {1};
-            char buf[29 + extra];
+            char buf[64 + extra];
+            std::string large;
             char* begin {buf + extra};
             char* extra_begin {begin};
-            char* end;
-            bool neg;
+            char* end {nullptr};
 
-            if ((neg = val < 0))
-            {
-                val = -val;
-            }
+            // signbit rather than val < 0 so that -0 and -nan keep their sign
+            const bool neg {std::signbit(val)};
+            val = std::abs(val);
 
-            if (type)
+            if constexpr (native_floating_point<F>)
             {
-                if (precision)
+                if (!type && !precision)
                 {
-                    end = lib2::to_chars(begin, std::ranges::end(buf), val, *type, *precision);
+                    end = to_chars_shortest(begin, val);
                 }
-                else
+                else if (type == std::chars_format::fixed && precision && *precision <= fixed_max_precision && std::isfinite(val))
                 {
-                    end = lib2::to_chars(begin, std::ranges::end(buf), val, *type);
+                    end = to_chars_fixed(begin, val, static_cast<int>(*precision));
                 }
             }
-            else
+
+            if (!end)
             {
-                if (precision)
-                {
-                    end = lib2::to_chars(begin, std::ranges::end(buf), val, std::chars_format::general, *precision);
-                }
-                else
+                const auto convert {[&](char* const first, char* const last) {
+                    if (precision)
+                    {
+                        return std::to_chars(first, last, val, type.value_or(std::chars_format::general), static_cast<int>(*precision));
+                    }
+                    if (type)
+                    {
+                        return std::to_chars(first, last, val, *type);
+                    }
+                    return std::to_chars(first, last, val);
+                }};
+
+                auto result {convert(begin, std::ranges::end(buf))};
+                if (result.ec == std::errc::value_too_large)
                 {
-                    end = lib2::to_chars(begin, std::ranges::end(buf), val);
+                    // Fixed notation of the largest values, or a large precision
+                    large.resize(extra + std::numeric_limits<F>::max_exponent10 + 8 + precision.value_or(0));
+                    begin = extra_begin = large.data() + extra;
+                    result = convert(begin, large.data() + large.size());
                 }
+                end = result.ptr;
             }
 
             if (neg)
@@ -742,11 +977,41 @@ namespace lib2
             }
         }
 
+        static constexpr std::size_t max_default_size {native_floating_point<F> ? shortest_max_size : 64};
+
+        static char* default_format_to(char* const out, const F val) noexcept
+        {
+            if constexpr (native_floating_point<F>)
+            {
+                return to_chars_shortest(out, val);
+            }
+            else
+            {
+                return to_chars(out, out + max_default_size, val);
+            }
+        }
+
         static void default_format(const F val, format_context& ctx)
         {
-            char buf[30];
-            const auto ptr {to_chars(buf, std::ranges::end(buf), val)};
-            ctx.stream.write(std::string_view{buf, ptr});
+            if constexpr (native_floating_point<F>)
+            {
+                if (ctx.stream.stream.write_available() >= shortest_max_size)
+                {
+                    ctx.stream.produce([val](char* const beg, char*) noexcept {
+                        return to_chars_shortest(beg, val);
+                    });
+                }
+                else
+                {
+                    char buf[shortest_max_size];
+                    ctx.stream.write(std::string_view{buf, to_chars_shortest(buf, val)});
+                }
+            }
+            else
+            {
+                char buf[max_default_size];
+                ctx.stream.write(std::string_view{buf, default_format_to(buf, val)});
+            }
         }
     };
 
@@ -796,13 +1061,28 @@ namespace lib2
             int_fmt.format(reinterpret_cast<std::uintptr_t>(value), ctx);
         }
 
+        static constexpr std::size_t max_default_size {std::numeric_limits<std::uintptr_t>::digits / 4 + 2};
+
         static void default_format(const void* const value, format_context& ctx)
         {
-            char buf[std::numeric_limits<std::uintptr_t>::digits + 3];
+            char buf[max_default_size];
+            const auto begin {default_chars(buf, value)};
+            ctx.stream.write(std::string_view{begin, std::ranges::end(buf)});
+        }
+
+        static char* default_format_to(char* const out, const void* const value) noexcept
+        {
+            char buf[max_default_size];
+            const auto begin {default_chars(buf, value)};
+            return std::copy(begin, std::ranges::end(buf), out);
+        }
+    private:
+        static char* default_chars(char (&buf)[max_default_size], const void* const value) noexcept
+        {
             auto begin {to_chars_base16(buf, std::ranges::end(buf), reinterpret_cast<std::uintptr_t>(value))};
             *--begin = 'x';
             *--begin = '0';
-            ctx.stream.write(std::string_view{begin, std::ranges::end(buf)});
+            return begin;
         }
     };
 
@@ -823,6 +1103,11 @@ namespace lib2
         {
             return formatter<const void*>::default_format(const_cast<const void*>(value), ctx);
         }
+
+        static char* default_format_to(char* const out, const volatile void* const value) noexcept
+        {
+            return formatter<const void*>::default_format_to(out, const_cast<const void*>(value));
+        }
     };
 
     export
@@ -842,6 +1127,13 @@ namespace lib2
         {
             ctx.stream.write("nullptr");
         }
+
+        static constexpr std::size_t max_default_size {7};
+
+        static char* default_format_to(char* const out, const std::nullptr_t) noexcept
+        {
+            return std::copy_n("nullptr", max_default_size, out);
+        }
     };
 
     export
@@ -944,5 +1236,13 @@ namespace lib2
         {
             ctx.stream.put(value);
         }
+
+        static constexpr std::size_t max_default_size {1};
+
+        static char* default_format_to(char* const out, const char value) noexcept
+        {
+            *out = value;
+            return out + 1;
+        }
     };
 }
\ No newline at end of file
@@ -38,180 +38,270 @@ namespace lib2
     template<>
     struct formatter<chrono_suffix<std::atto>> : public format_parser
     {
+        static constexpr std::string_view text {"as"};
+
         static void format(const chrono_suffix<std::atto>, format_context& ctx)
         {
-            ctx.stream.write("as");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::femto>> : public format_parser
     {
+        static constexpr std::string_view text {"fs"};
+
         static void format(const chrono_suffix<std::femto>, format_context& ctx)
         {
-            ctx.stream.write("fs");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::pico>> : public format_parser
     {
+        static constexpr std::string_view text {"ps"};
+
         static void format(const chrono_suffix<std::pico>, format_context& ctx)
         {
-            ctx.stream.write("ps");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::nano>> : public format_parser
     {
+        static constexpr std::string_view text {"ns"};
+
         static void format(const chrono_suffix<std::nano>, format_context& ctx)
         {
-            ctx.stream.write("ns");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::micro>> : public format_parser
     {
+        static constexpr std::string_view text {"us"};
+
         static void format(const chrono_suffix<std::micro>, format_context& ctx)
         {
-            ctx.stream.write("us");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::milli>> : public format_parser
     {
+        static constexpr std::string_view text {"ms"};
+
         static void format(const chrono_suffix<std::milli>, format_context& ctx)
         {
-            ctx.stream.write("ms");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::centi>> : public format_parser
     {
+        static constexpr std::string_view text {"cs"};
+
         static void format(const chrono_suffix<std::centi>, format_context& ctx)
         {
-            ctx.stream.write("cs");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::deci>> : public format_parser
     {
+        static constexpr std::string_view text {"ds"};
+
         static void format(const chrono_suffix<std::deci>, format_context& ctx)
         {
-            ctx.stream.write("ds");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::ratio<1>>> : public format_parser
     {
+        static constexpr std::string_view text {"s"};
+
         static void format(const chrono_suffix<std::ratio<1>>, format_context& ctx)
         {
-            ctx.stream.put('s');
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::deca>> : public format_parser
     {
+        static constexpr std::string_view text {"das"};
+
         static void format(const chrono_suffix<std::deca>, format_context& ctx)
         {
-            ctx.stream.write("das");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::hecto>> : public format_parser
     {
+        static constexpr std::string_view text {"hs"};
+
         static void format(const chrono_suffix<std::hecto>, format_context& ctx)
         {
-            ctx.stream.write("hs");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::kilo>> : public format_parser
     {
+        static constexpr std::string_view text {"ks"};
+
         static void format(const chrono_suffix<std::kilo>, format_context& ctx)
         {
-            ctx.stream.write("ks");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::mega>> : public format_parser
     {
+        static constexpr std::string_view text {"Ms"};
+
         static void format(const chrono_suffix<std::mega>, format_context& ctx)
         {
-            ctx.stream.write("Ms");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::giga>> : public format_parser
     {
+        static constexpr std::string_view text {"Gs"};
+
         static void format(const chrono_suffix<std::giga>, format_context& ctx)
         {
-            ctx.stream.write("Gs");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::tera>> : public format_parser
     {
+        static constexpr std::string_view text {"Ts"};
+
         static void format(const chrono_suffix<std::tera>, format_context& ctx)
         {
-            ctx.stream.write("Ts");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::peta>> : public format_parser
     {
+        static constexpr std::string_view text {"Ps"};
+
         static void format(const chrono_suffix<std::peta>, format_context& ctx)
         {
-            ctx.stream.write("Ps");
+            ctx.stream.write(text);
         }
     };
     
     template<>
     struct formatter<chrono_suffix<std::exa>> : public format_parser
     {
+        static constexpr std::string_view text {"Es"};
+
         static void format(const chrono_suffix<std::exa>, format_context& ctx)
         {
-            ctx.stream.write("Es");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::ratio<60>>> : public format_parser
     {
+        static constexpr std::string_view text {"min"};
+
         static void format(const chrono_suffix<std::ratio<60>>, format_context& ctx)
         {
-            ctx.stream.write("min");
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::ratio<3600>>> : public format_parser
     {
+        static constexpr std::string_view text {"h"};
+
         static void format(const chrono_suffix<std::ratio<3600>>, format_context& ctx)
         {
-            ctx.stream.put('h');
+            ctx.stream.write(text);
         }
     };
 
     template<>
     struct formatter<chrono_suffix<std::ratio<86400>>> : public format_parser
     {
+        static constexpr std::string_view text {"d"};
+
         static void format(const chrono_suffix<std::ratio<86400>>, format_context& ctx)
         {
-            ctx.stream.put('d');
+            ctx.stream.write(text);
+        }
+    };
+
+    // One step of a chrono spec, as compiled by chrono_formatter::parse()
+    struct chrono_op
+    {
+        enum class kind : std::uint8_t
+        {
+            literal,
+            character,
+            day,
+            day_space,
+            month,
+            year,
+            century,
+            year_of_century,
+            iso_weekday,
+            weekday,
+            day_of_year,
+            hour,
+            minute,
+            second,
+            subseconds,
+            utc_offset,
+            time_zone,
+            count,
+            suffix,
+            locale
+        };
+
+        kind type {kind::literal};
+        char ch {};
+        char mod {};
+        // The text of a literal, in fmt()
+        std::uint32_t pos {0};
+        std::uint32_t size {0};
+
+        // Whether the op writes the same for every time within a second
+        [[nodiscard]] constexpr bool whole_second() const noexcept
+        {
+            switch (type)
+            {
+            case kind::subseconds:
+            case kind::count:
+            case kind::suffix:
+            case kind::locale:
+                return false;
+            default:
+                return true;
+            }
         }
     };
 
@@ -249,6 +339,7 @@ namespace lib2
         {
             self.validate(fmt);
             self.fmt_ = fmt;
+            self.compile();
         }
 
         static constexpr bool validate_spec(const char spec, const char mod) noexcept
@@ -286,111 +377,54 @@ namespace lib2
         template<class Rep = int, class Period = std::ratio<1>>
         void format_tm(const std::tm& value, format_context& ctx, const std::chrono::duration<Rep, Period> d = {}) const
         {
-            std::ios ios{nullptr};
-            ios.imbue(get_locale(ctx));
-            const auto& time_facet {std::use_facet<std::time_put<char, text_ostream_iterator>>(ios.getloc())};
-
-            bool in_format {false};
-            char mod {};
-
-            const auto f {fmt()};
-            const auto end {f.end()};
-            auto begin {f.begin()};
-            
-            while (begin != end)
+            if (compiled_)
             {
-                const auto iter {std::find(begin, end, '%')};
-                if (begin != iter)
-                {
-                    ctx.stream.write(std::string_view{begin, iter});
-                }
-
-                if (iter == end)
+                format_ops(value, ctx, d, 0, num_ops_);
+            }
+            else
+            {
+                // Too long to have been compiled up front, so it is
+                // compiled as it is written
+                std::optional<std::ios> ios;
+                for (std::size_t pos {0}; pos < fmt_.size();)
                 {
-                    break;
+                    compile_op(fmt_, pos, [&](const chrono_op op) {
+                        put_op(op, value, ctx, d, ios);
+                    });
                 }
+            }
+        }
 
-                begin = iter;
-
-                ++begin;
-                const auto spec {*begin};
-                ++begin;
+        // Writes ops [first, last) of the compiled spec
+        template<class Rep, class Period>
+        void format_ops(const std::tm& value, format_context& ctx, const std::chrono::duration<Rep, Period> d, const std::size_t first, const std::size_t last) const
+        {
+            std::optional<std::ios> ios;
+            for (auto i {first}; i < last; ++i)
+            {
+                put_op(ops_[i], value, ctx, d, ios);
+            }
+        }
 
-                if (begin != end)
-                {
-                    if (spec == 'O' || spec == 'E')
-                    {
-                        time_facet.put(text_ostream_iterator{ctx.stream}, ios, fill, &value, *begin, spec);
-                        continue;
-                    }
-                }
+        // How many ops at the start of the compiled spec write the same for
+        // every time within a second
+        [[nodiscard]] constexpr std::size_t whole_second_ops() const noexcept
+        {
+            return compiled_ ? num_whole_second_ops_ : 0;
+        }
 
-                switch (spec)
-                {
-                case '%':
-                    ctx.stream.put('%');
-                    break;
-                case 'n':
-                    ctx.stream.put('\n');
-                    break;
-                case 't':
-                    ctx.stream.put('\t');
-                    break;
-                case 'Q':
-                    formatter<Rep>::default_format(d.count(), ctx);
-                    break;
-                case 'q':
-                    formatter<chrono_suffix<Period>>::format({}, ctx);
-                    break;
-                case 'd':
-                    lib2::format_to<"{:02}">(ctx.stream, value.tm_mday);
-                    break;
-                case 'e':
-                    lib2::format_to<"{: >2}">(ctx.stream, value.tm_mday);
-                    break;
-                case 'm':
-                    lib2::format_to<"{:02}">(ctx.stream, value.tm_mon + 1);
-                    break;
-                case 'C':
-                    lib2::format_to<"{:02}">(ctx.stream, value.tm_year + 1900);
-                    break;
-                case 'Y':
-                    lib2::format_to<"{:04}">(ctx.stream, value.tm_year + 1900);
-                    break;
-                case 'y':
-                    lib2::format_to<"{:02}">(ctx.stream, (value.tm_year + 1900) % 100);
-                    break;
-                case 'u':
-                    formatter<int>::default_format(value.tm_wday + 1, ctx);
-                    break;
-                case 'w':
-                    formatter<int>::default_format(value.tm_wday, ctx);
-                    break;
-                case 'H':
-                    lib2::format_to<"{:02}">(ctx.stream, value.tm_hour);
-                    break;
-                case 'M':
-                    lib2::format_to<"{:02}">(ctx.stream, value.tm_min);
-                    break;
-                case 'S':
-                    if constexpr (std::chrono::treat_as_floating_point_v<Rep>)
-                    {
-                        const std::chrono::hh_mm_ss hhmmss {d};
-                        lib2::format_to<"{:.{}}">(ctx.stream, (d - hhmmss.hours() - hhmmss.minutes()).count(), std::size_t(std::min(std::intmax_t{6}, denom_10th<Period>::value)));
-                    }
-                    else
-                    {
-                        lib2::format_to<"{:02}">(ctx.stream, value.tm_sec);
-                    }
-                    break;
-                default:
-                    time_facet.put(text_ostream_iterator{ctx.stream}, ios, fill, &value, spec);
-                    break;
-                }
-            }
+        [[nodiscard]] constexpr std::size_t num_ops() const noexcept
+        {
+            return num_ops_;
         }
     private:
+        static constexpr std::size_t max_ops {32};
+
         std::string_view fmt_;
+        std::array<chrono_op, max_ops> ops_ {};
+        std::size_t num_ops_ {0};
+        std::size_t num_whole_second_ops_ {0};
+        bool compiled_ {false};
 
         constexpr void validate(this const auto& self, const std::string_view fmt)
         {
@@ -442,6 +476,296 @@ namespace lib2
                 throw format_error{"Invalid chrono spec: %"};
             }
         }
+
+        // Compiles the spec into ops, unless it has more than max_ops
+        constexpr void compile()
+        {
+            num_ops_ = 0;
+            compiled_ = true;
+            for (std::size_t pos {0}; compiled_ && pos < fmt_.size();)
+            {
+                compile_op(fmt_, pos, [&](const chrono_op op) {
+                    if (num_ops_ == ops_.size())
+                    {
+                        compiled_ = false;
+                        return;
+                    }
+                    ops_[num_ops_++] = op;
+                });
+            }
+
+            num_whole_second_ops_ = 0;
+            while (num_whole_second_ops_ < num_ops_ && ops_[num_whole_second_ops_].whole_second())
+            {
+                ++num_whole_second_ops_;
+            }
+        }
+
+        // Compiles the literal text or the field at pos in a validated spec,
+        // passing its ops to emit, and moves pos past it. Fields that do not
+        // depend on the locale are broken down into numeric ops, and
+        // everything else is left to std::time_put.
+        template<class F>
+        static constexpr void compile_op(const std::string_view fmt, std::size_t& pos, F&& emit)
+        {
+            using enum chrono_op::kind;
+
+            if (fmt[pos] != '%')
+            {
+                const auto end {std::min(fmt.find('%', pos), fmt.size())};
+                emit(chrono_op{.type = literal, .pos = static_cast<std::uint32_t>(pos), .size = static_cast<std::uint32_t>(end - pos)});
+                pos = end;
+                return;
+            }
+
+            ++pos;
+            char mod {};
+            if (fmt[pos] == 'E' || fmt[pos] == 'O')
+            {
+                mod = fmt[pos++];
+            }
+            const auto spec {fmt[pos++]};
+
+            const auto add_field {[&](const chrono_op::kind type) {
+                emit(chrono_op{.type = type, .ch = spec, .mod = mod});
+            }};
+            const auto add_character {[&](const char ch) {
+                emit(chrono_op{.type = chrono_op::kind::character, .ch = ch});
+            }};
+
+            // The modified forms use the locale's alternative representations
+            if (mod && spec != 'z')
+            {
+                add_field(locale);
+                return;
+            }
+
+            switch (spec)
+            {
+            case '%':
+                add_character('%');
+                break;
+            case 'n':
+                add_character('\n');
+                break;
+            case 't':
+                add_character('\t');
+                break;
+            case 'd':
+                add_field(day);
+                break;
+            case 'e':
+                add_field(day_space);
+                break;
+            case 'm':
+                add_field(month);
+                break;
+            case 'Y':
+                add_field(year);
+                break;
+            case 'C':
+                add_field(century);
+                break;
+            case 'y':
+                add_field(year_of_century);
+                break;
+            case 'u':
+                add_field(iso_weekday);
+                break;
+            case 'w':
+                add_field(weekday);
+                break;
+            case 'j':
+                add_field(day_of_year);
+                break;
+            case 'H':
+                add_field(hour);
+                break;
+            case 'M':
+                add_field(minute);
+                break;
+            case 'S':
+                add_field(second);
+                add_field(subseconds);
+                break;
+            case 'z':
+                add_field(utc_offset);
+                break;
+            case 'Z':
+                add_field(time_zone);
+                break;
+            case 'Q':
+                add_field(count);
+                break;
+            case 'q':
+                add_field(suffix);
+                break;
+            case 'D':
+                add_field(month);
+                add_character('/');
+                add_field(day);
+                add_character('/');
+                add_field(year_of_century);
+                break;
+            case 'F':
+                add_field(year);
+                add_character('-');
+                add_field(month);
+                add_character('-');
+                add_field(day);
+                break;
+            case 'R':
+                add_field(hour);
+                add_character(':');
+                add_field(minute);
+                break;
+            case 'T':
+                add_field(hour);
+                add_character(':');
+                add_field(minute);
+                add_character(':');
+                add_field(second);
+                add_field(subseconds);
+                break;
+            default:
+                add_field(locale);
+                break;
+            }
+        }
+
+        // Writes val zero padded to Digits, or as format would if it has
+        // more digits or is negative
+        template<int Digits>
+        static void put_digits(format_context& ctx, const int val)
+        {
+            constexpr auto limit {Digits == 2 ? 100 : Digits == 3 ? 1000 : 10000};
+            if (val >= 0 && val < limit)
+            {
+                char buf[Digits];
+                to_chars_base10_fixed(buf, static_cast<unsigned int>(val), Digits);
+                ctx.stream.write(buf, Digits);
+            }
+            else if constexpr (Digits == 2)
+            {
+                lib2::format_to<"{:02}">(ctx.stream, val);
+            }
+            else if constexpr (Digits == 3)
+            {
+                lib2::format_to<"{:03}">(ctx.stream, val);
+            }
+            else
+            {
+                lib2::format_to<"{:04}">(ctx.stream, val);
+            }
+        }
+
+        template<class Rep, class Period>
+        void put_op(const chrono_op op, const std::tm& value, format_context& ctx, const std::chrono::duration<Rep, Period> d, std::optional<std::ios>& ios) const
+        {
+            using enum chrono_op::kind;
+            using hh_mm_ss = std::chrono::hh_mm_ss<std::chrono::duration<Rep, Period>>;
+
+            switch (op.type)
+            {
+            case literal:
+                ctx.stream.write(fmt_.data() + op.pos, op.size);
+                break;
+            case character:
+                ctx.stream.put(op.ch);
+                break;
+            case day:
+                put_digits<2>(ctx, value.tm_mday);
+                break;
+            case day_space:
+                if (value.tm_mday >= 0 && value.tm_mday < 10)
+                {
+                    const char buf[] {' ', static_cast<char>('0' + value.tm_mday)};
+                    ctx.stream.write(buf, 2);
+                }
+                else
+                {
+                    lib2::format_to<"{: >2}">(ctx.stream, value.tm_mday);
+                }
+                break;
+            case month:
+                put_digits<2>(ctx, value.tm_mon + 1);
+                break;
+            case year:
+                put_digits<4>(ctx, value.tm_year + 1900);
+                break;
+            case century:
+                {
+                    const auto y {value.tm_year + 1900};
+                    put_digits<2>(ctx, (y >= 0 ? y : y - 99) / 100);
+                }
+                break;
+            case year_of_century:
+                put_digits<2>(ctx, ((value.tm_year + 1900) % 100 + 100) % 100);
+                break;
+            case iso_weekday:
+                formatter<int>::default_format(value.tm_wday == 0 ? 7 : value.tm_wday, ctx);
+                break;
+            case weekday:
+                formatter<int>::default_format(value.tm_wday, ctx);
+                break;
+            case day_of_year:
+                put_digits<3>(ctx, value.tm_yday + 1);
+                break;
+            case hour:
+                put_digits<2>(ctx, value.tm_hour);
+                break;
+            case minute:
+                put_digits<2>(ctx, value.tm_min);
+                break;
+            case second:
+                if constexpr (std::chrono::treat_as_floating_point_v<Rep>)
+                {
+                    const hh_mm_ss hhmmss {d};
+                    lib2::format_to<"{:.{}}">(ctx.stream, (d - hhmmss.hours() - hhmmss.minutes()).count(), std::size_t(std::min(std::intmax_t{6}, denom_10th<Period>::value)));
+                }
+                else
+                {
+                    put_digits<2>(ctx, value.tm_sec);
+                }
+                break;
+            case subseconds:
+                // Floating point seconds already have their fraction
+                if constexpr (!std::chrono::treat_as_floating_point_v<Rep> && hh_mm_ss::fractional_width > 0)
+                {
+                    constexpr auto width {static_cast<int>(hh_mm_ss::fractional_width)};
+                    char buf[width + 1];
+                    buf[0] = '.';
+                    to_chars_base10_fixed(buf + 1, static_cast<std::uint64_t>(hh_mm_ss{d}.subseconds().count()), width);
+                    ctx.stream.write(buf, width + 1);
+                }
+                break;
+            case utc_offset:
+                ctx.stream.write(op.mod ? std::string_view{"+00:00"} : std::string_view{"+0000"});
+                break;
+            case time_zone:
+                ctx.stream.write("UTC");
+                break;
+            case count:
+                formatter<Rep>::default_format(d.count(), ctx);
+                break;
+            case suffix:
+                formatter<chrono_suffix<Period>>::format({}, ctx);
+                break;
+            case locale:
+                {
+                    // Set up on first use, as most specs never need it
+                    if (!ios)
+                    {
+                        ios.emplace(nullptr);
+                        ios->imbue(get_locale(ctx));
+                    }
+
+                    const auto& time_facet {std::use_facet<std::time_put<char, text_ostream_iterator>>(ios->getloc())};
+                    time_facet.put(text_ostream_iterator{ctx.stream}, *ios, fill, &value, op.ch, op.mod);
+                }
+                break;
+            }
+        }
     };
 
     export
@@ -466,7 +790,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -508,7 +832,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -568,7 +892,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -624,7 +948,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -684,7 +1008,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -728,7 +1052,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -765,7 +1089,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -818,7 +1142,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -855,7 +1179,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -899,7 +1223,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -937,7 +1261,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -981,7 +1305,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -1039,7 +1363,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -1076,7 +1400,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -1121,7 +1445,7 @@ namespace lib2
 
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
             if (this->fmt().empty())
             {
@@ -1148,34 +1472,82 @@ namespace lib2
         }
     };
 
+    // Durations with a bounded count and a fixed suffix have a default
+    // format of bounded size, so format<"{}"> can write them together with
+    // its other bounded arguments
+    template<class Rep, class Period>
+    struct duration_default_format {};
+
+    template<class Rep, class Period>
+        requires(bounded_default_formattable<Rep> && requires { formatter<chrono_suffix<Period>>::text; })
+    struct duration_default_format<Rep, Period>
+    {
+        static constexpr std::size_t max_default_size {formatter<Rep>::max_default_size + formatter<chrono_suffix<Period>>::text.size()};
+
+        static char* default_format_to(char* const out, const std::chrono::duration<Rep, Period> d) noexcept
+        {
+            constexpr auto suffix {formatter<chrono_suffix<Period>>::text};
+            return std::ranges::copy(suffix, formatter<Rep>::default_format_to(out, d.count())).out;
+        }
+    };
+
     export
     template<class Rep, class Period>
-    struct formatter<std::chrono::duration<Rep, Period>> : public chrono_formatter, public precision_parser
+    struct formatter<std::chrono::duration<Rep, Period>> : public chrono_formatter, public precision_parser, public duration_default_format<Rep, Period>
     {
-        using chrono_formatter::parse;
+        // Set by the spec "auto", which writes the duration in the unit
+        // that fits it best, to precision decimals (2 by default)
+        bool best_fit {false};
+
+        constexpr auto parse(format_parse_context& ctx)
+        {
+            const auto end {this->chrono_formatter::parse(ctx)};
+            best_fit = this->fmt() == "auto";
+            return end;
+        }
 
         void format(const std::chrono::duration<Rep, Period> d, format_context& ctx) const
         {
             const auto width {this->get_width(ctx)};
 
+            if (best_fit || this->fmt().empty())
+            {
+                // Only a count and a suffix, so it is written straight to
+                // the stream and measured rather than buffered to pad it
+                const auto precision {this->get_precision(ctx)};
+                const auto write {[&](format_context& out) {
+                    if (best_fit)
+                    {
+                        format_best_fit(d, out, precision ? *precision : 2);
+                    }
+                    else
+                    {
+                        default_format(d, out);
+                    }
+                }};
+
+                if (width)
+                {
+                    format_padded(ctx, fill, align, width, write);
+                }
+                else
+                {
+                    write(ctx);
+                }
+                return;
+            }
+
             ostringstream temp_os;
             text_ostream ref_os {width ? temp_os : ctx.stream};
-            format_context temp_context {this->get_locale(ctx), ref_os};
+            format_context temp_context {ctx, ref_os};
 
-            if (this->fmt().empty())
-            {
-                default_format(d, temp_context);
-            }
-            else
-            {
-                const std::chrono::hh_mm_ss<std::chrono::duration<Rep, Period>> hhmmss{d};
-                const std::tm time {
-                    .tm_sec  = int(hhmmss.seconds().count())
-                ,   .tm_min  = int(hhmmss.minutes().count())
-                ,   .tm_hour = int(hhmmss.hours().count())
-                };
-                this->format_tm(time, temp_context, d);
-            }
+            const std::chrono::hh_mm_ss<std::chrono::duration<Rep, Period>> hhmmss{d};
+            const std::tm time {
+                .tm_sec  = int(hhmmss.seconds().count())
+            ,   .tm_min  = int(hhmmss.minutes().count())
+            ,   .tm_hour = int(hhmmss.hours().count())
+            };
+            this->format_tm(time, temp_context, d);
 
             if (width)
             {
@@ -1189,7 +1561,15 @@ namespace lib2
 
         static void default_format(const std::chrono::duration<Rep, Period> d, format_context& ctx)
         {
-            lib2::format_to<"{}{}">(ctx.locale(), ctx.stream, d.count(), chrono_suffix<Period>{});
+            if constexpr (default_formattable<Rep>)
+            {
+                formatter<Rep>::default_format(d.count(), ctx);
+            }
+            else
+            {
+                lib2::format_to<"{}">(ctx.stream, d.count());
+            }
+            formatter<chrono_suffix<Period>>::format({}, ctx);
         }
 
         static constexpr bool validate_spec(const char spec, const char mod) noexcept
@@ -1214,5 +1594,180 @@ namespace lib2
                 return chrono_formatter::validate_spec(spec, mod);
             }
         }
+    private:
+        // Moves up a unit, a factor of 1000, while the count is 10000 or
+        // more. Whole counts are written as they are and anything else to
+        // precision decimals.
+        template<class R, class P>
+        static void format_best_fit(const std::chrono::duration<R, P> d, format_context& ctx, const std::size_t precision)
+        {
+            if constexpr (std::integral<R>)
+            {
+                if (d.count() < 10000 && (d.count() % 1000 || d.count() == 0))
+                {
+                    formatter<std::chrono::duration<R, P>>::default_format(d, ctx);
+                    return;
+                }
+            }
+            else if (d.count() < 10000)
+            {
+                format_fixed(d, ctx, precision);
+                return;
+            }
+
+            if constexpr (P::num < std::exa::num)
+            {
+                using larger = std::ratio_multiply<P, std::ratio<1000>>;
+                if constexpr (std::integral<R>)
+                {
+                    if (d.count() % 1000)
+                    {
+                        format_best_fit(std::chrono::duration_cast<std::chrono::duration<float, larger>>(d), ctx, precision);
+                    }
+                    else
+                    {
+                        format_best_fit(std::chrono::duration_cast<std::chrono::duration<R, larger>>(d), ctx, precision);
+                    }
+                }
+                else
+                {
+                    format_best_fit(std::chrono::duration_cast<std::chrono::duration<R, larger>>(d), ctx, precision);
+                }
+            }
+            else if constexpr (std::integral<R>)
+            {
+                formatter<std::chrono::duration<R, P>>::default_format(d, ctx);
+            }
+            else
+            {
+                format_fixed(d, ctx, precision);
+            }
+        }
+
+        template<class R, class P>
+        static void format_fixed(const std::chrono::duration<R, P> d, format_context& ctx, const std::size_t precision)
+        {
+            lib2::format_to<"{:.{}f}">(ctx.stream, d.count(), precision);
+            formatter<chrono_suffix<P>>::format({}, ctx);
+        }
+    };
+
+    // What the leading whole second ops of a sys_time spec last wrote on
+    // this thread. Timestamps on log lines mostly fall in the same second
+    // as the one before, so their date and time are copied from here
+    // rather than formatted again.
+    struct chrono_second_cache
+    {
+        std::string fmt;
+        std::chrono::sys_seconds time {std::chrono::sys_seconds::min()};
+        ostringstream prefix;
+    };
+
+    thread_local chrono_second_cache second_cache;
+
+    export
+    template<class Duration>
+    struct formatter<std::chrono::sys_time<Duration>> : public chrono_formatter
+    {
+        void format(const std::chrono::sys_time<Duration> tp, format_context& ctx) const
+        {
+            const auto width {this->get_width(ctx)};
+
+            ostringstream temp_os;
+            text_ostream ref_os {width ? temp_os : ctx.stream};
+            format_context temp_context {ctx, ref_os};
+
+            if (this->fmt().empty())
+            {
+                default_format(tp, temp_context);
+            }
+            else
+            {
+                format_time(tp, temp_context);
+            }
+
+            if (width)
+            {
+                formatter<std::string_view> str_fmt;
+                str_fmt.fill  = fill;
+                str_fmt.align = align;
+                str_fmt.set_width(width);
+                str_fmt.format(temp_os.view(), ctx);
+            }
+        }
+
+        static void default_format(const std::chrono::sys_time<Duration> tp, format_context& ctx)
+        {
+            lib2::format_to<"{:%F %T}">(ctx.stream, tp);
+        }
+
+        static constexpr bool validate_spec(const char spec, const char mod) noexcept
+        {
+            switch (spec)
+            {
+            case 'Q':
+            case 'q':
+                return false;
+            case 'c':
+                return mod == 0 || mod == 'E';
+            case 'U':
+            case 'W':
+            case 'V':
+                return mod == 0 || mod == 'O';
+            case 'G':
+            case 'g':
+            case 'j':
+            case 'Z':
+                return mod == 0;
+            case 'z':
+                return mod == 0 || mod == 'E' || mod == 'O';
+            }
+
+            return formatter<std::chrono::year_month_day>::validate_spec(spec, mod) ||
+                   formatter<std::chrono::weekday>::validate_spec(spec, mod) ||
+                   formatter<std::chrono::seconds>::validate_spec(spec, mod);
+        }
+    private:
+        void format_time(const std::chrono::sys_time<Duration> tp, format_context& ctx) const
+        {
+            const auto days {std::chrono::floor<std::chrono::days>(tp)};
+            const auto since_midnight {tp - days};
+            const std::chrono::year_month_day ymd {days};
+            const std::chrono::hh_mm_ss hhmmss {since_midnight};
+
+            const std::tm time {
+                .tm_sec  = int(hhmmss.seconds().count())
+            ,   .tm_min  = int(hhmmss.minutes().count())
+            ,   .tm_hour = int(hhmmss.hours().count())
+            ,   .tm_mday = int(unsigned{ymd.day()})
+            ,   .tm_mon  = int(unsigned{ymd.month()}) - 1
+            ,   .tm_year = int{ymd.year()} - 1900
+            ,   .tm_wday = int(std::chrono::weekday{days}.c_encoding())
+            ,   .tm_yday = int((days - std::chrono::sys_days{ymd.year() / std::chrono::January / 1}).count())
+            };
+
+            const auto cached_ops {this->whole_second_ops()};
+            if (cached_ops == 0 || std::chrono::treat_as_floating_point_v<typename Duration::rep>)
+            {
+                this->format_tm(time, ctx, since_midnight);
+                return;
+            }
+
+            const auto second {std::chrono::floor<std::chrono::seconds>(tp)};
+            if (second_cache.time != second || second_cache.fmt != this->fmt())
+            {
+                // Invalidated first in case formatting throws
+                second_cache.time = std::chrono::sys_seconds::min();
+                second_cache.prefix.clear();
+                format_context cache_context {ctx, second_cache.prefix};
+                this->format_ops(time, cache_context, since_midnight, 0, cached_ops);
+
+                second_cache.fmt = this->fmt();
+                second_cache.time = second;
+            }
+
+            ctx.stream.write(second_cache.prefix.view());
+            this->format_ops(time, ctx, since_midnight, cached_ops, this->num_ops());
+        }
     };
-}
+}
\ No newline at end of file
@@ -12,6 +12,8 @@ namespace lib2
     template<class... Args>
     struct format_arg_store;
 
+    struct parsed_format;
+
     export
     class format_arg;
 
@@ -101,6 +103,8 @@ namespace lib2
     private:
         std::size_t num_args;
         std::size_t i;
+
+        friend struct parsed_format;
     };
 
     export
@@ -151,6 +155,17 @@ namespace lib2
         { formatter<T>::default_format(value, format_ctx) };
     };
 
+    // Default formats with a known upper size, which can be written with
+    // unchecked stores once that much room has been reserved
+    export
+    template<class T>
+    concept bounded_default_formattable = default_formattable<T> &&
+        requires(const T& value, char* out)
+    {
+        { formatter<T>::max_default_size } -> std::convertible_to<std::size_t>;
+        { formatter<T>::default_format_to(out, value) } -> std::same_as<char*>;
+    };
+
     // For making nice errors
     template<class T>
     struct assert_formattable
@@ -0,0 +1,25 @@
+export module lib2.fmt:floating;
+
+import std;
+
+namespace lib2
+{
+    // Longest output of to_chars_shortest, sign included
+    constexpr std::size_t shortest_max_size {24};
+
+    // Largest precision to_chars_fixed is used for; it needs room for
+    // fixed_max_integral_digits + 1 + precision characters
+    constexpr std::size_t fixed_max_precision {32};
+    constexpr std::size_t fixed_max_integral_digits {17};
+
+    // Same output as std::to_chars(first, last, val), from the shortest
+    // digits that round trip
+    char* to_chars_shortest(char* out, float val) noexcept;
+    char* to_chars_shortest(char* out, double val) noexcept;
+
+    // Same output as std::to_chars(first, last, val, std::chars_format::fixed, precision)
+    // for a non-negative finite val, or nullptr when that can not be
+    // decided from the shortest digits
+    char* to_chars_fixed(char* out, float val, int precision) noexcept;
+    char* to_chars_fixed(char* out, double val, int precision) noexcept;
+}
\ No newline at end of file
@@ -5,6 +5,7 @@ export import :parsers;
 export import :format;
 export import :string;
 export import :arithmetic;
+export import :floating;
 export import :misc;
 export import :ranges;
-export import :chrono;
+export import :chrono;
\ No newline at end of file
@@ -37,19 +37,276 @@ namespace lib2
         }
     };
 
-    text_ostream vformat_to(text_ostream os, const std::string_view fmt, const format_args args)
+    // The spec of a built-in argument type, parsed into its formatter, or
+    // monostate for the default format
+    using parsed_spec = std::variant<
+        std::monostate,
+        formatter<bool>,
+        formatter<char>,
+        formatter<std::intmax_t>,
+        formatter<std::uintmax_t>,
+        formatter<long double>,
+        formatter<std::string_view>,
+        formatter<const void*>
+    >;
+
+    struct parsed_instruction
+    {
+        enum class kind : std::uint8_t
+        {
+            literal,
+            arg
+        } type;
+
+        // Where a literal, or the spec of an argument of custom type, starts
+        std::size_t pos {0};
+        std::size_t size {0};
+        std::size_t idx {0};
+
+        // State of the automatic argument ids where a custom argument's
+        // spec starts, as its parse may take some for dynamic specs
+        std::size_t next_arg {0};
+        parsed_spec spec {};
+    };
+
+    // A format string as parsed for one set of argument types. Custom
+    // types have no formatter to keep, so their specs are parsed again
+    // through their handle each time.
+    struct parsed_format
+    {
+        std::vector<parsed_instruction> instructions;
+
+        void format(const std::string_view fmt, format_context& fmt_ctx) const
+        {
+            for (const auto& instr : instructions)
+            {
+                if (instr.type == parsed_instruction::kind::literal)
+                {
+                    fmt_ctx.stream.write(fmt.substr(instr.pos, instr.size));
+                    continue;
+                }
+
+                fmt_ctx.args.get(instr.idx).visit(overloaded {
+                    [&](const format_arg::handle& h) {
+                        format_parse_context parse_ctx {fmt.substr(instr.pos), fmt_ctx.args.size()};
+                        parse_ctx.i = instr.next_arg;
+                        h.format(parse_ctx, fmt_ctx);
+                    },
+                    [&]<class T>(const T& value) {
+                        if (const auto fmtr {std::get_if<formatter<T>>(&instr.spec)})
+                        {
+                            fmtr->format(value, fmt_ctx);
+                        }
+                        else
+                        {
+                            formatter<T>::default_format(value, fmt_ctx);
+                        }
+                    }
+                });
+            }
+        }
+
+        static std::size_t next_arg(const format_parse_context& parse_ctx) noexcept
+        {
+            return parse_ctx.i;
+        }
+    };
+
+    // Formats like runtime_collector while keeping what it parsed
+    struct recording_collector : public runtime_collector
+    {
+        std::string_view fmt;
+        parsed_format parsed;
+
+        void string_literal(const std::string_view str)
+        {
+            runtime_collector::string_literal(str);
+            parsed.instructions.push_back({.type=parsed_instruction::kind::literal, .pos=static_cast<std::size_t>(str.data() - fmt.data()), .size=str.size()});
+        }
+
+        void arg(const std::size_t idx, format_parse_context& parse_ctx)
+        {
+            fmt_ctx.args.get(idx).visit(overloaded {
+                [&](const format_arg::handle& h) {
+                    parsed.instructions.push_back({.type=parsed_instruction::kind::arg, .pos=static_cast<std::size_t>(parse_ctx.begin - fmt.data()), .idx=idx, .next_arg=parsed_format::next_arg(parse_ctx)});
+                    h.format(parse_ctx, fmt_ctx);
+                },
+                [&]<class T>(const T& value) {
+                    auto& instr {parsed.instructions.emplace_back(parsed_instruction{.type=parsed_instruction::kind::arg, .idx=idx})};
+                    if (parse_ctx.begin == parse_ctx.end || *parse_ctx.begin == '}')
+                    {
+                        formatter<T>::default_format(value, fmt_ctx);
+                    }
+                    else
+                    {
+                        auto& fmtr {instr.spec.emplace<formatter<T>>()};
+                        parse_ctx.begin = fmtr.parse(parse_ctx);
+                        fmtr.format(value, fmt_ctx);
+                    }
+                }
+            });
+        }
+    };
+
+    struct format_cache_hash
+    {
+        using is_transparent = void;
+
+        std::size_t operator()(const std::string_view key) const noexcept
+        {
+            return std::hash<std::string_view>{}(key);
+        }
+    };
+
+    struct format_cache_entry
+    {
+        parsed_format parsed;
+        std::uint64_t last_used {0};
+    };
+
+    // Parsed format strings of this thread. Once it holds max_entries, the
+    // least recently used entry makes room for a new one. Formatters may
+    // format themselves, so while a format is running further up the
+    // stack its entry may be in use and nothing is evicted; new strings
+    // are then formatted without being recorded.
+    struct format_cache
+    {
+        static constexpr std::size_t max_entries {256};
+
+        std::string key;
+        std::uint64_t clock {0};
+        std::size_t depth {0};
+        std::unordered_map<std::string, format_cache_entry, format_cache_hash, std::equal_to<>> entries;
+
+        void evict_one() noexcept
+        {
+            auto oldest {entries.begin()};
+            for (auto it {entries.begin()}; it != entries.end(); ++it)
+            {
+                if (it->second.last_used < oldest->second.last_used)
+                {
+                    oldest = it;
+                }
+            }
+            entries.erase(oldest);
+        }
+    };
+
+    thread_local format_cache parsed_formats;
+
+    template<class T>
+    static void append_bytes(std::string& key, const T& value)
+    {
+        key.append(reinterpret_cast<const char*>(std::addressof(value)), sizeof(value));
+    }
+
+    // Keys a parse by the types of args, custom types by their handle's
+    // format function, then by the address or the text of fmt
+    static void make_key(std::string& key, const std::string_view fmt, const format_args args, const bool by_address)
     {
-        runtime_collector collector {.fmt_ctx={os, args}};
-        format_parse_context parse_ctx {fmt, args.size()};
+        key.clear();
+        key.push_back(by_address ? 'a' : 't');
+        append_bytes(key, args.size());
+        for (std::size_t i {0}; i < args.size(); ++i)
+        {
+            append_bytes(key, args.get(i).visit(overloaded {
+                [](const format_arg::handle& h) {
+                    return reinterpret_cast<std::uintptr_t>(h.func);
+                },
+                []<class T>(const T&) {
+                    return static_cast<std::uintptr_t>(format_arg::to_format_arg<T>::value);
+                }
+            }));
+        }
+
+        if (by_address)
+        {
+            append_bytes(key, fmt.data());
+            append_bytes(key, fmt.size());
+        }
+        else
+        {
+            key.append(fmt);
+        }
+    }
+
+    static void cached_format(const std::string_view fmt, format_context& fmt_ctx, const bool by_address)
+    {
+        auto& cache {parsed_formats};
+
+        struct depth_guard
+        {
+            std::size_t& depth;
+
+            ~depth_guard() noexcept
+            {
+                --depth;
+            }
+        } guard {++cache.depth};
+
+        const auto nested {cache.depth > 1};
+        if (nested && cache.entries.size() >= format_cache::max_entries)
+        {
+            runtime_collector collector {.fmt_ctx=fmt_ctx};
+            format_parse_context parse_ctx {fmt, fmt_ctx.args.size()};
+            do_format(parse_ctx, collector);
+            return;
+        }
+
+        make_key(cache.key, fmt, fmt_ctx.args, by_address);
+
+        if (const auto it {cache.entries.find(std::string_view{cache.key})}; it != cache.entries.end())
+        {
+            it->second.last_used = ++cache.clock;
+            it->second.parsed.format(fmt, fmt_ctx);
+            return;
+        }
+
+        // Formatting may use the cache, and with it its key
+        auto key {cache.key};
+
+        recording_collector collector {{.fmt_ctx=fmt_ctx}, fmt};
+        format_parse_context parse_ctx {fmt, fmt_ctx.args.size()};
         do_format(parse_ctx, collector);
+
+        if (cache.entries.size() >= format_cache::max_entries)
+        {
+            if (nested)
+            {
+                return;
+            }
+            cache.evict_one();
+        }
+        cache.entries.emplace(std::move(key), format_cache_entry{std::move(collector.parsed), ++cache.clock});
+    }
+
+    text_ostream vformat_to(text_ostream os, const std::string_view fmt, const format_args args)
+    {
+        format_context fmt_ctx {os, args};
+        cached_format(fmt, fmt_ctx, false);
+        os.stream.end_record();
         return os;
     }
 
     text_ostream vformat_to(const std::locale& loc, text_ostream os, const std::string_view fmt, const format_args args)
     {
-        runtime_collector collector {.fmt_ctx={loc, os, args}};
-        format_parse_context parse_ctx {fmt, args.size()};
-        do_format(parse_ctx, collector);
+        format_context fmt_ctx {loc, os, args};
+        cached_format(fmt, fmt_ctx, false);
+        os.stream.end_record();
+        return os;
+    }
+
+    text_ostream vformat_static_to(text_ostream os, const std::string_view fmt, const format_args args)
+    {
+        format_context fmt_ctx {os, args};
+        cached_format(fmt, fmt_ctx, true);
+        return os;
+    }
+
+    text_ostream vformat_static_to(const std::locale& loc, text_ostream os, const std::string_view fmt, const format_args args)
+    {
+        format_context fmt_ctx {loc, os, args};
+        cached_format(fmt, fmt_ctx, true);
         return os;
     }
 }
\ No newline at end of file
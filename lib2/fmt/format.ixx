@@ -255,12 +255,20 @@ namespace lib2
         }
     };
 
+    // The parse of each format string is cached per thread, by its text
+    // and the types of args, so formatting with the same string again
+    // only replays its literals and preparsed specs
     export
     text_ostream vformat_to(text_ostream, std::string_view, format_args);
 
     export
     text_ostream vformat_to(const std::locale&, text_ostream, std::string_view, format_args);
 
+    // vformat_to for format strings with static storage, as those of
+    // format_string are, whose parse is cached by address instead
+    text_ostream vformat_static_to(text_ostream, std::string_view, format_args);
+    text_ostream vformat_static_to(const std::locale&, text_ostream, std::string_view, format_args);
+
     export
     template<class... Args>
     class format_string
@@ -315,7 +323,7 @@ namespace lib2
                     fmt.remove_suffix(trailing_str_size);
                 }
 
-                vformat_to(os, fmt, make_format_args(args...));
+                vformat_static_to(os, fmt, make_format_args(args...));
 
                 if (trailing_str_size)
                 {
@@ -354,7 +362,7 @@ namespace lib2
                     fmt.remove_suffix(trailing_str_size);
                 }
 
-                vformat_to(loc, os, fmt, make_format_args(args...));
+                vformat_static_to(loc, os, fmt, make_format_args(args...));
 
                 if (trailing_str_size)
                 {
@@ -384,6 +392,38 @@ namespace lib2
     template<std::size_t N, class... Args>
     format_string(const char(&)[N]) -> format_string<Args...>;
 
+    // Literals at least this long make a format worth gathering
+    constexpr std::size_t gather_literal_threshold {64};
+
+    // Strings whose default format is just their characters
+    template<class T>
+    struct is_gatherable_string : std::false_type {};
+
+    template<>
+    struct is_gatherable_string<std::string_view> : std::true_type {};
+
+    template<class Allocator>
+    struct is_gatherable_string<std::basic_string<char, std::char_traits<char>, Allocator>> : std::true_type {};
+
+    template<>
+    struct is_gatherable_string<const char*> : std::true_type {};
+
+    template<>
+    struct is_gatherable_string<char*> : std::true_type {};
+
+    template<std::size_t N>
+    struct is_gatherable_string<char[N]> : std::true_type {};
+
+    template<std::size_t N>
+    struct is_gatherable_string<const char[N]> : std::true_type {};
+
+    // Upper bound of T's default format, or 0 when it has none
+    template<class T>
+    constexpr std::size_t max_default_size {0};
+
+    template<bounded_default_formattable T>
+    constexpr std::size_t max_default_size<T> {formatter<T>::max_default_size};
+
     export
     template<string_literal Fmt, class... Args>
     class cp_format_string
@@ -395,12 +435,99 @@ namespace lib2
             do_format(parse_context, collector);
             return collector;
         }()};
+
+        // Formats made up of only literals and default formatted strings
+        // are emitted as a single ostream::writev instead of one write
+        // per piece, provided there is a string argument or a long literal
+        // that is worth not copying.
+        static constexpr bool gather {[] {
+            if constexpr (collector.num_instructions < 2)
+            {
+                return false;
+            }
+            else
+            {
+                constexpr std::array<bool, sizeof...(Args)> string_args {is_gatherable_string<std::remove_cvref_t<Args>>::value...};
+                bool worthwhile {false};
+                for (const auto& instr : collector.instructions)
+                {
+                    if (instr.type == instruction::t_::literal)
+                    {
+                        worthwhile |= instr.size >= gather_literal_threshold;
+                    }
+                    else if (!instr.default_fmt || !string_args[instr.idx])
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        worthwhile = true;
+                    }
+                }
+                return worthwhile;
+            }
+        }()};
+
+        // When every argument is default formatted with a bounded size the
+        // whole output has a worst case size. Once that much room is
+        // available it is written with a single produce and unchecked
+        // stores, instead of a capacity check per literal and argument.
+        static constexpr std::size_t fused_max_size {[] {
+            if constexpr (collector.all_literals())
+            {
+                return std::size_t{0};
+            }
+            else
+            {
+                constexpr std::array<std::size_t, sizeof...(Args)> arg_sizes {max_default_size<std::remove_cvref_t<Args>>...};
+                std::size_t size {0};
+                for (const auto& instr : collector.instructions)
+                {
+                    if (instr.type == instruction::t_::literal)
+                    {
+                        size += instr.size;
+                    }
+                    else if (!instr.default_fmt || arg_sizes[instr.idx] == 0)
+                    {
+                        return std::size_t{0};
+                    }
+                    else
+                    {
+                        size += arg_sizes[instr.idx];
+                    }
+                }
+                return size;
+            }
+        }()};
+
+        static constexpr bool fused {fused_max_size != 0 && !gather};
     public:
         consteval cp_format_string() noexcept {}
 
+        [[nodiscard]] static constexpr std::size_t estimated_str_size() noexcept
+        {
+            return fused ? fused_max_size : collector.estimated_str_size;
+        }
+
         static inline void format(text_ostream os, const Args&... args)
         {
-            if constexpr (collector.all_literals())
+            if constexpr (gather)
+            {
+                do_gather(os, std::forward_as_tuple(args...));
+            }
+            else if constexpr (fused)
+            {
+                if (os.stream.write_available() >= fused_max_size)
+                {
+                    do_fused(os, std::forward_as_tuple(args...));
+                }
+                else
+                {
+                    format_context ctx {os, {}};
+                    do_format<0>(ctx, std::forward_as_tuple(args...));
+                }
+            }
+            else if constexpr (collector.all_literals())
             {
                 do_format<0>(os);
             }
@@ -419,7 +546,16 @@ namespace lib2
 
         static inline void format(const std::locale& loc, text_ostream os, const Args&... args)
         {
-            if constexpr (collector.all_literals())
+            if constexpr (gather)
+            {
+                do_gather(os, std::forward_as_tuple(args...));
+            }
+            else if constexpr (fused)
+            {
+                // Default formats do not depend on the locale
+                format(os, args...);
+            }
+            else if constexpr (collector.all_literals())
             {
                 do_format<0>(os);
             }
@@ -435,6 +571,58 @@ namespace lib2
                 do_format<0>(ctx, std::forward_as_tuple(args...));
             }
         }
+    private:
+        template<std::size_t I, class ArgTuple>
+        static inline std::span<const std::byte> fragment(const ArgTuple& args) noexcept
+        {
+            constexpr auto& instr {std::get<I>(collector.instructions)};
+            if constexpr (instr.type == instruction::t_::literal)
+            {
+                return std::as_bytes(std::span{Fmt.data() + instr.idx, instr.size});
+            }
+            else
+            {
+                const std::string_view str {std::get<instr.idx>(args)};
+                return std::as_bytes(std::span{str});
+            }
+        }
+
+        template<class ArgTuple>
+        static inline void do_gather(text_ostream os, const ArgTuple& args)
+        {
+            const auto fragments {[&]<std::size_t... I>(std::index_sequence<I...>) {
+                return std::array<std::span<const std::byte>, sizeof...(I)>{fragment<I>(args)...};
+            }(std::make_index_sequence<collector.num_instructions>{})};
+
+            os.stream.writev(fragments);
+        }
+
+        template<class ArgTuple>
+        static inline void do_fused(text_ostream os, const ArgTuple& args) noexcept
+        {
+            os.produce([&](char* out, char*) noexcept {
+                [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    ((out = fused_fragment<I>(out, args)), ...);
+                }(std::make_index_sequence<collector.num_instructions>{});
+                return out;
+            });
+        }
+
+        template<std::size_t I, class ArgTuple>
+        static inline char* fused_fragment(char* const out, const ArgTuple& args) noexcept
+        {
+            constexpr auto& instr {std::get<I>(collector.instructions)};
+            if constexpr (instr.type == instruction::t_::literal)
+            {
+                return std::copy_n(Fmt.data() + instr.idx, instr.size, out);
+            }
+            else
+            {
+                using T = std::remove_cvref_t<std::tuple_element_t<instr.idx, ArgTuple>>;
+                return formatter<T>::default_format_to(out, std::get<instr.idx>(args));
+            }
+        }
+
     private:
         template<std::size_t I>
         static inline void do_format(text_ostream os)
@@ -494,6 +682,7 @@ namespace lib2
     {
         constexpr cp_format_string<Fmt, Args...> fmt_str;
         fmt_str.format(os, args...);
+        os.stream.end_record();
         return os;
     }
 
@@ -503,41 +692,66 @@ namespace lib2
     {
         constexpr cp_format_string<Fmt, Args...> fmt_str;
         fmt_str.format(loc, os, args...);
+        os.stream.end_record();
         return os;
     }
 
+    // Formats short strings into the inline buffer of a string_builder,
+    // so the result is allocated once at its final size. Strings expected
+    // to outgrow that buffer are formatted straight into their own
+    // storage, reserved from size_hint.
+    template<class Allocator, class F>
+    constexpr std::basic_string<char, std::char_traits<char>, Allocator> format_to_string(const std::size_t size_hint, const Allocator& alloc, F&& f)
+    {
+        if !consteval
+        {
+            if (size_hint <= string_builder::inline_size)
+            {
+                string_builder builder;
+                std::invoke(std::forward<F>(f), builder);
+                return builder.str(alloc);
+            }
+        }
+
+        std::basic_string<char, std::char_traits<char>, Allocator> str {alloc};
+        str.reserve(size_hint);
+        basic_ostringstream<Allocator> ss {std::move(str)};
+        std::invoke(std::forward<F>(f), ss);
+        return std::move(ss).str();
+    }
+
     export
     template<string_literal Fmt, class... Args>
     constexpr std::string format(const Args&... args)
     {
-        ostringstream ss;
-        format_to<Fmt>(ss, args...);
-        return std::move(ss).str();
+        return format_to_string(cp_format_string<Fmt, Args...>::estimated_str_size(), std::allocator<char>{}, [&](ostream& os) {
+            format_to<Fmt>(os, args...);
+        });
     }
 
     export
     template<string_literal Fmt, class... Args>
     inline std::string format(const std::locale& loc, const Args&... args)
     {
-        ostringstream ss;
-        format_to<Fmt>(loc, ss, args...);
-        return std::move(ss).str();
+        return format_to_string(cp_format_string<Fmt, Args...>::estimated_str_size(), std::allocator<char>{}, [&](ostream& os) {
+            format_to<Fmt>(loc, os, args...);
+        });
     }
 
     export
     inline std::string vformat(const std::string_view fmt, const format_args args)
     {
-        ostringstream ss;
-        vformat_to(ss, fmt, args);
-        return std::move(ss).str();
+        return format_to_string(fmt.size(), std::allocator<char>{}, [&](ostream& os) {
+            vformat_to(os, fmt, args);
+        });
     }
 
     export
     inline std::string vformat(const std::locale& loc, const std::string_view fmt, const format_args args)
     {
-        ostringstream ss;
-        vformat_to(loc, ss, fmt, args);
-        return std::move(ss).str();
+        return format_to_string(fmt.size(), std::allocator<char>{}, [&](ostream& os) {
+            vformat_to(loc, os, fmt, args);
+        });
     }
 
     export
@@ -545,6 +759,7 @@ namespace lib2
     inline text_ostream format_to(text_ostream os, const format_string<std::type_identity_t<Args>...> fmt, const Args&... args)
     {
         fmt.format(os, args...);
+        os.stream.end_record();
         return os;
     }
 
@@ -553,6 +768,7 @@ namespace lib2
     inline text_ostream format_to(const std::locale& loc, text_ostream os, const format_string<std::type_identity_t<Args>...> fmt, const Args&... args)
     {
         fmt.format(loc, os, args...);
+        os.stream.end_record();
         return os;
     }
 
@@ -560,22 +776,38 @@ namespace lib2
     template<class... Args>
     inline std::string format(const format_string<std::type_identity_t<Args>...> fmt, const Args&... args)
     {
-        std::string str;
-        str.reserve(fmt.estimated_str_size());
-        ostringstream ss {std::move(str)};
-        format_to(ss, fmt, args...);
-        return std::move(ss).str();
+        return format_to_string(fmt.estimated_str_size(), std::allocator<char>{}, [&](ostream& os) {
+            format_to(os, fmt, args...);
+        });
     }
 
     export
     template<class... Args>
     inline std::string format(const std::locale& loc, const format_string<std::type_identity_t<Args>...> fmt, const Args&... args)
     {
-        std::string str;
-        str.reserve(fmt.estimated_str_size());
-        ostringstream ss {std::move(str)};
-        format_to(loc, ss, fmt, args...);
-        return std::move(ss).str();
+        return format_to_string(fmt.estimated_str_size(), std::allocator<char>{}, [&](ostream& os) {
+            format_to(loc, os, fmt, args...);
+        });
+    }
+
+    // Formats into a string that allocates from alloc, such as an
+    // arena_allocator, instead of the global heap
+    export
+    template<string_literal Fmt, class Allocator, class... Args>
+    constexpr std::basic_string<char, std::char_traits<char>, Allocator> format(std::allocator_arg_t, const Allocator& alloc, const Args&... args)
+    {
+        return format_to_string(cp_format_string<Fmt, Args...>::estimated_str_size(), alloc, [&](ostream& os) {
+            format_to<Fmt>(os, args...);
+        });
+    }
+
+    export
+    template<class Allocator, class... Args>
+    inline std::basic_string<char, std::char_traits<char>, Allocator> format(std::allocator_arg_t, const Allocator& alloc, const format_string<std::type_identity_t<Args>...> fmt, const Args&... args)
+    {
+        return format_to_string(fmt.estimated_str_size(), alloc, [&](ostream& os) {
+            format_to(os, fmt, args...);
+        });
     }
 
     export
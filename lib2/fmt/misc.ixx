@@ -134,6 +134,17 @@ namespace lib2
                 ctx.stream.write("false");
             }
         }
+
+        static constexpr std::size_t max_default_size {5};
+
+        static char* default_format_to(char* const out, const bool value) noexcept
+        {
+            if (value)
+            {
+                return std::copy_n("true", 4, out);
+            }
+            return std::copy_n("false", 5, out);
+        }
     };
 
     export
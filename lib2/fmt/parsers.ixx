@@ -5,6 +5,7 @@ import std;
 import lib2.utility;
 import lib2.compact_optional;
 import lib2.strings;
+import lib2.io;
 
 import :context;
 import :formatter;
@@ -77,6 +78,78 @@ namespace lib2
         }
     };
 
+    // Counts the code points written to it, which is what widths are
+    // measured in
+    class width_ostream final : public ostream
+    {
+    public:
+        [[nodiscard]] constexpr std::size_t width() const noexcept
+        {
+            return width_;
+        }
+
+        constexpr void write(const std::byte* const vals, const size_type count) noexcept override
+        {
+            width_ += static_cast<std::size_t>(std::ranges::count_if(vals, vals + count, starts_code_point));
+        }
+
+        constexpr void fill(const std::byte val, const size_type count) noexcept override
+        {
+            width_ += starts_code_point(val) ? count : 0;
+        }
+    protected:
+        constexpr void overflow(const std::byte val) override
+        {
+            width_ += starts_code_point(val);
+        }
+    private:
+        std::size_t width_ {0};
+
+        static constexpr bool starts_code_point(const std::byte b) noexcept
+        {
+            return (b & std::byte{0xC0}) != std::byte{0x80};
+        }
+    };
+
+    // Calls write twice, first to measure it and then to pad it to width,
+    // so padded output needs no buffer
+    template<std::invocable<format_context&> F>
+    void format_padded(format_context& ctx, const char fill, const fill_align_parser::align_type align, const std::size_t width, F write)
+    {
+        width_ostream measure;
+        format_context measure_ctx {ctx, measure};
+        write(measure_ctx);
+
+        if (width <= measure.width())
+        {
+            write(ctx);
+            return;
+        }
+
+        const auto padding {width - measure.width()};
+        switch (align)
+        {
+        case fill_align_parser::align_type::left:
+            write(ctx);
+            ctx.stream.fill(fill, padding);
+            break;
+        case fill_align_parser::align_type::right:
+            ctx.stream.fill(fill, padding);
+            write(ctx);
+            break;
+        case fill_align_parser::align_type::center:
+            {
+                const auto left_pad {padding / 2};
+                const auto right_pad {padding - left_pad};
+
+                ctx.stream.fill(fill, left_pad);
+                write(ctx);
+                ctx.stream.fill(fill, right_pad);
+            }
+            break;
+        }
+    }
+
     export
     struct width_parser : format_parser
     {
@@ -48,6 +48,24 @@ namespace lib2
         }
     };
 
+    // Formats value as "{}" would, into the context it is given rather
+    // than through format_to, which would copy the locale per element
+    template<class T>
+    void format_element(const T& value, format_context& ctx)
+    {
+        if constexpr (default_formattable<T>)
+        {
+            formatter<T>::default_format(value, ctx);
+        }
+        else
+        {
+            formatter<T> fmtr;
+            format_parse_context parse_ctx {{}, 0};
+            parse_ctx.begin = fmtr.parse(parse_ctx);
+            fmtr.format(value, ctx);
+        }
+    }
+
     template<class T>
     struct pair_like : std::false_type {};
 
@@ -139,58 +157,27 @@ namespace lib2
         void format(R&& r, format_context& ctx) const
         {
             const auto width {this->get_width(ctx)};
-            lib2::ostringstream ss;
-            format_context other_context {ctx, width ? ss : ctx.stream};
-
-            const auto format_range {[&] {
-                auto it {std::ranges::begin(r)};
-                const auto end {std::ranges::end(r)};
-                if (it != end)
-                {
-                    underlying.format(*it, other_context);
-                    ++it;
-
-                    for (; it != end; ++it)
-                    {
-                        other_context.stream.write(separator);
-                        underlying.format(*it, other_context);
-                    }
-                }
-            }};
-            
-            switch (type)
+            if (width == 0)
             {
-            case range_format::sequence:
-                other_context.stream.write(opening_bracket);
-                format_range();
-                other_context.stream.write(closing_bracket);
-                break;
-            case range_format::disabled:
-                format_range();
-                break;
-            case range_format::map:
-            case range_format::set:
-                other_context.stream.put('{');
-                format_range();
-                other_context.stream.put('}');
-                break;
-            case range_format::string:
-            case range_format::escaped_string:
-                if constexpr (std::same_as<T, std::string>)
-                {
-                    underlying.format(std::string(std::from_range, r), other_context);
-                }
-                break;
+                format_unpadded(r, ctx);
             }
-
-            if (width)
+            else if constexpr (std::ranges::forward_range<R>)
             {
-                formatter<std::string_view> str_fmt;
-                str_fmt.fill  = fill;
-                str_fmt.align = align;
-                str_fmt.set_width(width);
-
-                str_fmt.format(ss.view(), ctx);
+                format_padded(ctx, fill, align, width, [&](format_context& out) {
+                    format_unpadded(r, out);
+                });
+            }
+            else
+            {
+                // A single pass range can't be measured before it is
+                // written, so it is buffered instead
+                lib2::ostringstream ss;
+                format_context buffer_ctx {ctx, ss};
+                format_unpadded(r, buffer_ctx);
+
+                format_padded(ctx, fill, align, width, [&](format_context& out) {
+                    out.stream.write(ss.view());
+                });
             }
         }
 
@@ -204,13 +191,13 @@ namespace lib2
             const auto end {std::ranges::end(r)};
             if (it != end)
             {
-                format_to<"{}">(ctx.locale(), ctx.stream, *it);
+                format_element<T>(*it, ctx);
                 ++it;
 
                 for (; it != end; ++it)
                 {
                     ctx.stream.write(", ");
-                    format_to<"{}">(ctx.locale(), ctx.stream, *it);
+                    format_element<T>(*it, ctx);
                 }
             }
 
@@ -257,6 +244,51 @@ namespace lib2
 
     private:
         range_format type {range_format::sequence};
+
+        template<class R>
+        void format_unpadded(R&& r, format_context& ctx) const
+        {
+            const auto format_range {[&] {
+                auto it {std::ranges::begin(r)};
+                const auto end {std::ranges::end(r)};
+                if (it != end)
+                {
+                    underlying.format(*it, ctx);
+                    ++it;
+
+                    for (; it != end; ++it)
+                    {
+                        ctx.stream.write(separator);
+                        underlying.format(*it, ctx);
+                    }
+                }
+            }};
+
+            switch (type)
+            {
+            case range_format::sequence:
+                ctx.stream.write(opening_bracket);
+                format_range();
+                ctx.stream.write(closing_bracket);
+                break;
+            case range_format::disabled:
+                format_range();
+                break;
+            case range_format::map:
+            case range_format::set:
+                ctx.stream.put('{');
+                format_range();
+                ctx.stream.put('}');
+                break;
+            case range_format::string:
+            case range_format::debug_string:
+                if constexpr (std::same_as<T, std::string>)
+                {
+                    underlying.format(std::string(std::from_range, r), ctx);
+                }
+                break;
+            }
+        }
     };
 
     template<class R>
@@ -496,32 +528,29 @@ namespace lib2
 
         void format(const std::tuple<Ts...>& value, format_context& ctx) const
         {
-            const auto width {this->get_width(ctx)};
-            lib2::ostringstream ss;
-            format_context other_context {ctx, width ? ss : ctx.stream};
+            const auto format_tuple {[&](format_context& out) {
+                out.stream.write(opening_bracket);
 
-            other_context.stream.write(opening_bracket);
+                if constexpr (sizeof...(Ts) > 0)
+                {
+                    std::apply(
+                        [&](const auto& v1, const auto&... vs) {
+                            format_element(v1, out);
+                            ((out.stream.write(separator), format_element(vs, out)), ...);
+                        }
+                    , value);
+                }
 
-            if constexpr (sizeof...(Ts) > 0)
+                out.stream.write(closing_bracket);
+            }};
+
+            if (const auto width {this->get_width(ctx)})
             {
-                std::apply(
-                    [&](const auto& v1, const auto&... vs) {
-                        format_to<"{}">(other_context.locale(), other_context.stream, v1);
-                        ((other_context.stream.write(separator), format_to<"{}">(other_context.locale(), other_context.stream, vs)), ...);
-                    }
-                , value);
+                format_padded(ctx, fill, align, width, format_tuple);
             }
-
-            other_context.stream.write(closing_bracket);
-
-            if (width)
+            else
             {
-                formatter<std::string_view> str_fmt;
-                str_fmt.fill  = fill;
-                str_fmt.align = align;
-                str_fmt.set_width(width);
-
-                str_fmt.format(ss.view(), ctx);
+                format_tuple(ctx);
             }
         }
 
@@ -533,8 +562,8 @@ namespace lib2
             {
                 std::apply(
                     [&](const auto& v1, const auto&... vs) {
-                        format_to<"{}">(ctx.locale(), ctx.stream, v1);
-                        ((ctx.stream.write(", "), format_to<"{}">(ctx.locale(), ctx.stream, vs)), ...);
+                        format_element(v1, ctx);
+                        ((ctx.stream.write(", "), format_element(vs, ctx)), ...);
                     }
                 , value);
             }
@@ -6,60 +6,87 @@ import :format;
 
 namespace lib2
 {
-    void formatter<std::string_view>::format(std::string_view str, format_context& ctx) const
+    // Writes the output of write, taking size columns, padded to width
+    template<std::invocable F>
+    static void write_padded(format_context& ctx, const char fill, const fill_align_parser::align_type align, const std::size_t width, const std::size_t size, F write)
     {
-        const auto width {this->get_width(ctx)};
-        const auto precision {this->get_precision(ctx)};
-
-        auto utf_view {views::utf_codepoints(str)};
-
-        if (precision)
+        if (width <= size)
         {
-            auto utf_it {utf_view.begin()};
-            std::ranges::advance(utf_it, *precision, utf_view.end());
-            const auto leftover {utf_it.leftover()};
-            str.remove_prefix(str.size() - std::string_view{leftover.begin(), leftover.end()}.size());
+            write();
+            return;
         }
 
-        std::string debug_str;
-        if (debug)
+        const auto padding {width - size};
+        switch (align)
         {
-            debug_str = lib2::format<"{}">(escaped(str));
-            str = debug_str;
-        }
+        case fill_align_parser::align_type::left:
+            write();
+            ctx.stream.fill(fill, padding);
+            break;
+        case fill_align_parser::align_type::right:
+            ctx.stream.fill(fill, padding);
+            write();
+            break;
+        case fill_align_parser::align_type::center:
+            {
+                const auto left_pad {padding / 2};
+                const auto right_pad {padding - left_pad};
 
-        utf_view = views::utf_codepoints(str);
+                ctx.stream.fill(fill, left_pad);
+                write();
+                ctx.stream.fill(fill, right_pad);
+            }
+            break;
+        }
+    }
 
-        const auto size {std::ranges::distance(utf_view)};
+    void formatter<std::string_view>::format(std::string_view str, format_context& ctx) const
+    {
+        const auto width {this->get_width(ctx)};
+        const auto precision {this->get_precision(ctx)};
 
-        if (width > size)
+        // Width and precision count code points, which for ASCII are bytes.
+        // Only what they need is checked for ASCII, and only when given.
+        if (precision && *precision < str.size())
         {
-            const auto padding {width - size};
-            switch (align)
+            std::size_t end {0};
+            if (is_ascii(str.substr(0, *precision)))
             {
-            case fill_align_parser::align_type::left:
-                ctx.stream.write(str);
-                ctx.stream.fill(fill, padding);
-                break;
-            case fill_align_parser::align_type::right:
-                ctx.stream.fill(fill, padding);
-                ctx.stream.write(str);
-                break;
-            case fill_align_parser::align_type::center:
+                end = *precision;
+            }
+            else
+            {
+                // Stops at the first lead byte past precision code points
+                for (std::size_t count {0}; end < str.size(); ++end)
                 {
-                    const auto left_pad {padding / 2};
-                    const auto right_pad {padding - left_pad};
-
-                    ctx.stream.fill(fill, left_pad);
-                    ctx.stream.write(str);
-                    ctx.stream.fill(fill, right_pad);
+                    if ((static_cast<unsigned char>(str[end]) & 0xC0) != 0x80 && count++ == *precision)
+                    {
+                        break;
+                    }
                 }
-                break;
             }
+            str = str.substr(0, end);
         }
-        else
+
+        if (debug)
+        {
+            // Escaped text is all ASCII, so its width is its size. It is
+            // only measured when there is padding to work out.
+            const auto size {width == 0 ? 0 : formatted_size<"{}">(escaped(str))};
+            write_padded(ctx, fill, align, width, size, [&] {
+                format_to<"{}">(ctx.stream, escaped(str));
+            });
+        }
+        else if (width == 0)
         {
             ctx.stream.write(str);
         }
+        else
+        {
+            const auto size {is_ascii(str) ? str.size() : static_cast<std::size_t>(std::ranges::distance(views::utf_codepoints(str)))};
+            write_padded(ctx, fill, align, width, size, [&] {
+                ctx.stream.write(str);
+            });
+        }
     }
 }
\ No newline at end of file
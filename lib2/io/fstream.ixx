@@ -173,6 +173,7 @@ namespace lib2
         void flush() override;
 
         void write(const std::byte* s, size_type count) override;
+        void writev(std::span<const std::span<const std::byte>> fragments) override;
         void fill(const std::byte b, size_type count) override;
     protected:
         void overflow(std::byte) override;
@@ -293,6 +294,201 @@ namespace lib2
         void* handle;
     };
 
+    export
+    enum class mmap_hint : int
+    {
+        none        = 0x0,
+        sequential  = 0x1,
+        willneed    = 0x2
+    };
+
+    export
+    constexpr bool operator&(const mmap_hint lhs, const mmap_hint rhs) noexcept
+    {
+        return std::to_underlying(lhs) & std::to_underlying(rhs);
+    }
+
+    export
+    constexpr mmap_hint operator|(const mmap_hint lhs, const mmap_hint rhs) noexcept
+    {
+        return static_cast<mmap_hint>(std::to_underlying(lhs) | std::to_underlying(rhs));
+    }
+
+    // Read-only stream over a memory-mapped file. The get area points
+    // straight into the mapping, so reads never copy into an intermediate
+    // buffer. With a window size of 0 the whole file is mapped at once and
+    // underflow never fires; otherwise the file is mapped in windows of
+    // (at least) that many bytes that slide forward as the stream is read.
+    export
+    class mmap_istream final : public istream
+    {
+    public:
+        using size_type  = istream::size_type;
+        using ssize_type = istream::ssize_type;
+        using opt_type   = istream::opt_type;
+
+        mmap_istream() noexcept
+            : handle{nullptr}
+            , mapping{nullptr}
+            , map_base{nullptr}
+            , map_size{0}
+            , map_offset{0}
+            , file_size{0}
+            , window{0}
+            , hints{mmap_hint::none} {}
+
+        explicit mmap_istream(const std::filesystem::path::string_type::value_type* const filename, const mmap_hint hints = mmap_hint::none, const size_type window = 0)
+            : mmap_istream{}
+        {
+            open(filename, hints, window);
+        }
+
+        explicit mmap_istream(const std::filesystem::path::string_type& filename, const mmap_hint hints = mmap_hint::none, const size_type window = 0)
+            : mmap_istream{filename.c_str(), hints, window} {}
+
+        explicit mmap_istream(const std::filesystem::path& filename, const mmap_hint hints = mmap_hint::none, const size_type window = 0)
+            : mmap_istream{filename.native(), hints, window} {}
+
+        mmap_istream(const mmap_istream&) = delete;
+        mmap_istream(mmap_istream&& other) noexcept
+            : istream{std::move(other)}
+            , handle{std::exchange(other.handle, nullptr)}
+            , mapping{std::exchange(other.mapping, nullptr)}
+            , map_base{std::exchange(other.map_base, nullptr)}
+            , map_size{std::exchange(other.map_size, 0)}
+            , map_offset{std::exchange(other.map_offset, 0)}
+            , file_size{std::exchange(other.file_size, 0)}
+            , window{other.window}
+            , hints{other.hints}
+        {
+            other.setg(nullptr, nullptr, nullptr);
+        }
+
+        mmap_istream& operator=(const mmap_istream&) = delete;
+        mmap_istream& operator=(mmap_istream&& other) noexcept
+        {
+            if (this != std::addressof(other))
+            {
+                try
+                {
+                    close();
+                }
+                catch (...) {}
+
+                istream::operator=(std::move(other));
+                handle = std::exchange(other.handle, nullptr);
+                mapping = std::exchange(other.mapping, nullptr);
+                map_base = std::exchange(other.map_base, nullptr);
+                map_size = std::exchange(other.map_size, 0);
+                map_offset = std::exchange(other.map_offset, 0);
+                file_size = std::exchange(other.file_size, 0);
+                window = other.window;
+                hints = other.hints;
+                other.setg(nullptr, nullptr, nullptr);
+            }
+            return *this;
+        }
+
+        virtual ~mmap_istream() noexcept
+        {
+            try
+            {
+                close();
+            }
+            catch (...) {}
+        }
+
+        void swap(mmap_istream& other) noexcept
+        {
+            using std::swap;
+
+            istream::swap(other);
+            swap(handle, other.handle);
+            swap(mapping, other.mapping);
+            swap(map_base, other.map_base);
+            swap(map_size, other.map_size);
+            swap(map_offset, other.map_offset);
+            swap(file_size, other.file_size);
+            swap(window, other.window);
+            swap(hints, other.hints);
+        }
+
+        [[nodiscard]] bool is_open() const noexcept
+        {
+            return static_cast<bool>(handle);
+        }
+
+        void open(const std::filesystem::path::string_type::value_type* const filename, const mmap_hint hints = mmap_hint::none, const size_type window = 0);
+
+        void open(const std::filesystem::path::string_type& filename, const mmap_hint hints = mmap_hint::none, const size_type window = 0)
+        {
+            open(filename.c_str(), hints, window);
+        }
+
+        void open(const std::filesystem::path& path, const mmap_hint hints = mmap_hint::none, const size_type window = 0)
+        {
+            open(path.native(), hints, window);
+        }
+
+        void close();
+
+        [[nodiscard]] std::uint64_t size() const noexcept
+        {
+            return file_size;
+        }
+
+        [[nodiscard]] std::uint64_t tell() const noexcept
+        {
+            return map_offset + static_cast<std::uint64_t>(this->gcur() - this->gbeg());
+        }
+
+        void seek(const std::int64_t offset, const seek_mode origin)
+        {
+            std::int64_t base {0};
+            switch (origin)
+            {
+            case seek_mode::cur:
+                base = static_cast<std::int64_t>(tell());
+                break;
+            case seek_mode::end:
+                base = static_cast<std::int64_t>(file_size);
+                break;
+            default:
+                break;
+            }
+
+            const auto pos {base + offset};
+            if (pos < 0 || static_cast<std::uint64_t>(pos) > file_size)
+            {
+                throw std::out_of_range{"mmap_istream::seek"};
+            }
+
+            const auto upos {static_cast<std::uint64_t>(pos)};
+            if (upos >= map_offset && upos <= map_offset + map_size)
+            {
+                this->setg(this->gbeg(), this->gbeg() + (upos - map_offset), this->gend());
+            }
+            else
+            {
+                map_view(upos);
+            }
+        }
+    protected:
+        opt_type underflow() override;
+    private:
+        void* handle;
+        void* mapping;
+        std::byte* map_base;
+        size_type map_size;
+        std::uint64_t map_offset;
+        std::uint64_t file_size;
+        size_type window;
+        mmap_hint hints;
+
+        void map_view(std::uint64_t offset);
+        void unmap_view() noexcept;
+    };
+
     struct async_io;
 
     export
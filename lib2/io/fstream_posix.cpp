@@ -0,0 +1,1697 @@
+module;
+
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+module lib2.io;
+
+import std;
+
+import lib2.utility;
+import lib2.err;
+
+namespace lib2
+{
+    constexpr std::size_t default_buffer_size {8192};
+
+    // Each read/write syscall is capped by the kernel at roughly 2 GiB,
+    // so larger requests are split into multiple calls.
+    constexpr std::size_t max_io_chunk {0x7ffff000};
+
+    struct async_io
+    {
+    private:
+        async_io(const std::size_t buf_size) noexcept
+            : next{nullptr}, capacity{buf_size} {}
+    public:
+        static constexpr unsigned unregistered {~0u};
+
+        async_io* next;
+        std::size_t capacity;
+        std::size_t offset {0};
+        std::size_t size {0};
+        std::int64_t result {0};
+        unsigned buf_index {unregistered};
+        bool in_flight {false};
+        std::byte buffer[1];
+
+        static async_io* create(const std::size_t buf_size)
+        {
+            const auto total_size {sizeof(async_io) + (buf_size - 1)};
+            async_io* mem {static_cast<async_io*>(::operator new(total_size))};
+            return new (mem) async_io{buf_size};
+        }
+
+        static void destroy(async_io* const aio) noexcept
+        {
+            if (aio)
+            {
+                destroy(aio->next);
+                aio->~async_io();
+                ::operator delete(aio);
+            }
+        }
+    };
+
+    // Handles are stored as fd + 1 so that a null handle means "not open"
+    // while still allowing descriptor 0.
+    [[nodiscard]] static int to_fd(void* const handle) noexcept
+    {
+        return static_cast<int>(reinterpret_cast<std::intptr_t>(handle) - 1);
+    }
+
+    [[nodiscard]] static void* to_handle(const int fd) noexcept
+    {
+        return reinterpret_cast<void*>(static_cast<std::intptr_t>(fd) + 1);
+    }
+
+    static void io_write(const int fd, const std::byte* data, std::size_t size)
+    {
+        while (size)
+        {
+            const auto chunk {std::min(size, max_io_chunk)};
+            const auto written {::write(fd, data, chunk)};
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                throw os_error{"Write failed"};
+            }
+
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+
+    // Writes every range, issuing as few writev calls as possible.
+    // Partial writes advance through `iov` in place.
+    static void io_writev(const int fd, iovec* iov, std::size_t count)
+    {
+        while (count)
+        {
+            if (!iov->iov_len)
+            {
+                ++iov;
+                --count;
+                continue;
+            }
+
+            const auto written {::writev(fd, iov, static_cast<int>(std::min<std::size_t>(count, IOV_MAX)))};
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                throw os_error{"Write failed"};
+            }
+
+            auto amount {static_cast<std::size_t>(written)};
+            while (count && amount >= iov->iov_len)
+            {
+                amount -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+
+            if (amount)
+            {
+                iov->iov_base = static_cast<std::byte*>(iov->iov_base) + amount;
+                iov->iov_len -= amount;
+            }
+        }
+    }
+
+    static void io_pwrite(const int fd, const std::byte* data, std::size_t size, std::size_t offset)
+    {
+        while (size)
+        {
+            const auto chunk {std::min(size, max_io_chunk)};
+            const auto written {::pwrite(fd, data, chunk, static_cast<off_t>(offset))};
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                throw os_error{"Write failed"};
+            }
+
+            data += written;
+            size -= static_cast<std::size_t>(written);
+            offset += static_cast<std::size_t>(written);
+        }
+    }
+
+    static std::size_t io_read(const int fd, std::byte* data, std::size_t size)
+    {
+        std::size_t total_read {0};
+        while (size)
+        {
+            const auto chunk {std::min(size, max_io_chunk)};
+            const auto amount {::read(fd, data, chunk)};
+            if (amount < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                throw os_error{"Read failed"};
+            }
+
+            if (!amount)
+            {
+                break;
+            }
+
+            data += amount;
+            size -= static_cast<std::size_t>(amount);
+            total_read += static_cast<std::size_t>(amount);
+        }
+
+        return total_read;
+    }
+
+    // Reads `size` bytes into `data` and opportunistically fills `extra`
+    // with whatever follows, all in one readv call. Returns the number of
+    // bytes placed in `data` and `extra` respectively.
+    static std::pair<std::size_t, std::size_t> io_readv(const int fd, std::byte* const data, const std::size_t size, std::byte* const extra, const std::size_t extra_size)
+    {
+        if (size + extra_size > max_io_chunk)
+        {
+            return {io_read(fd, data, size), 0};
+        }
+
+        iovec iov[2] {
+            {data, size},
+            {extra, extra_size}
+        };
+
+        ssize_t amount;
+        do
+        {
+            amount = ::readv(fd, iov, 2);
+        }
+        while (amount < 0 && errno == EINTR);
+
+        if (amount < 0)
+        {
+            throw os_error{"Read failed"};
+        }
+
+        const auto total {static_cast<std::size_t>(amount)};
+        if (total < size)
+        {
+            if (!total)
+            {
+                return {0, 0};
+            }
+
+            // Short read; keep going for the remainder of the caller's
+            // request, but don't bother filling the extra buffer.
+            return {total + io_read(fd, data + total, size - total), 0};
+        }
+
+        return {size, total - size};
+    }
+
+    static void io_seek(const int fd, const std::int64_t offset, const seek_mode origin)
+    {
+        if (::lseek(fd, static_cast<off_t>(offset), static_cast<int>(origin)) == static_cast<off_t>(-1))
+        {
+            throw os_error{"Seek failed"};
+        }
+    }
+
+    static int io_open(const std::filesystem::path::string_type::value_type* const filename, const int flags)
+    {
+        int fd;
+        do
+        {
+            fd = ::open(filename, flags | O_CLOEXEC, 0666);
+        }
+        while (fd < 0 && errno == EINTR);
+
+        if (fd < 0)
+        {
+            throw os_error{"Open failed"};
+        }
+
+        return fd;
+    }
+
+    static void io_close(const int fd)
+    {
+        // The descriptor is released even when close reports EINTR,
+        // so retrying would risk closing an unrelated descriptor.
+        if (::close(fd) < 0 && errno != EINTR)
+        {
+            throw os_error{"Close failed"};
+        }
+    }
+
+#if defined(__linux__)
+    // Minimal io_uring wrapper for async_ofstream. Writes are queued with
+    // a single non-blocking io_uring_enter; completions are only waited
+    // on from flush/close. Buffers are registered as fixed buffers where
+    // the kernel supports sparse registration, and the slots of released
+    // buffers are handed out again.
+    class io_ring
+    {
+    public:
+        static constexpr unsigned queue_depth {64};
+        static constexpr unsigned fixed_buffer_slots {64};
+
+        io_ring() noexcept = default;
+
+        io_ring(const io_ring&) = delete;
+        io_ring& operator=(const io_ring&) = delete;
+
+        ~io_ring() noexcept
+        {
+            if (ring_fd >= 0)
+            {
+                try
+                {
+                    wait_all();
+                }
+                catch (...) {}
+
+                ::munmap(sqes, sqes_len);
+                if (cq_ptr != sq_ptr)
+                {
+                    ::munmap(cq_ptr, cq_len);
+                }
+                ::munmap(sq_ptr, sq_len);
+                ::close(ring_fd);
+            }
+        }
+
+        // Returns false if io_uring is unavailable (old kernel, seccomp, ...)
+        // in which case the caller falls back to synchronous writes.
+        bool init() noexcept
+        {
+            io_uring_params params {};
+            const auto fd {static_cast<int>(::syscall(__NR_io_uring_setup, queue_depth, &params))};
+            if (fd < 0)
+            {
+                return false;
+            }
+
+            sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_len = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single_mmap {(params.features & IORING_FEAT_SINGLE_MMAP) != 0};
+            if (single_mmap)
+            {
+                sq_len = cq_len = std::max(sq_len, cq_len);
+            }
+
+            sq_ptr = ::mmap(nullptr, sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (sq_ptr == MAP_FAILED)
+            {
+                ::close(fd);
+                return false;
+            }
+
+            cq_ptr = single_mmap ? sq_ptr : ::mmap(nullptr, cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cq_ptr == MAP_FAILED)
+            {
+                ::munmap(sq_ptr, sq_len);
+                ::close(fd);
+                return false;
+            }
+
+            sqes_len = params.sq_entries * sizeof(io_uring_sqe);
+            const auto sqes_ptr {::mmap(nullptr, sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES)};
+            if (sqes_ptr == MAP_FAILED)
+            {
+                if (cq_ptr != sq_ptr)
+                {
+                    ::munmap(cq_ptr, cq_len);
+                }
+                ::munmap(sq_ptr, sq_len);
+                ::close(fd);
+                return false;
+            }
+
+            const auto sq_base {static_cast<std::byte*>(sq_ptr)};
+            sq_head  = reinterpret_cast<unsigned*>(sq_base + params.sq_off.head);
+            sq_tail  = reinterpret_cast<unsigned*>(sq_base + params.sq_off.tail);
+            sq_mask  = *reinterpret_cast<unsigned*>(sq_base + params.sq_off.ring_mask);
+            sq_array = reinterpret_cast<unsigned*>(sq_base + params.sq_off.array);
+            sqes     = static_cast<io_uring_sqe*>(sqes_ptr);
+
+            const auto cq_base {static_cast<std::byte*>(cq_ptr)};
+            cq_head  = reinterpret_cast<unsigned*>(cq_base + params.cq_off.head);
+            cq_tail  = reinterpret_cast<unsigned*>(cq_base + params.cq_off.tail);
+            cq_mask  = *reinterpret_cast<unsigned*>(cq_base + params.cq_off.ring_mask);
+            cqes     = reinterpret_cast<io_uring_cqe*>(cq_base + params.cq_off.cqes);
+            cq_entries = params.cq_entries;
+
+            ring_fd = fd;
+
+            io_uring_rsrc_register reg {};
+            reg.nr = fixed_buffer_slots;
+            reg.flags = IORING_RSRC_REGISTER_SPARSE;
+            fixed_buffers = ::syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_BUFFERS2, &reg, sizeof(reg)) == 0;
+
+            return true;
+        }
+
+        [[nodiscard]] bool valid() const noexcept
+        {
+            return ring_fd >= 0;
+        }
+
+        // Registers the block's buffer so writes can use IORING_OP_WRITE_FIXED.
+        // Failure is not an error; the block is simply written unregistered.
+        void register_buffer(async_io& aio) noexcept
+        {
+            aio.buf_index = async_io::unregistered;
+            if (!fixed_buffers || aio.capacity > max_io_chunk)
+            {
+                return;
+            }
+
+            unsigned slot;
+            if (free_slot_count)
+            {
+                slot = free_slots[--free_slot_count];
+            }
+            else if (next_slot != fixed_buffer_slots)
+            {
+                slot = next_slot++;
+            }
+            else
+            {
+                return;
+            }
+
+            if (update_slot(slot, aio.buffer, aio.capacity))
+            {
+                aio.buf_index = slot;
+            }
+            else
+            {
+                free_slots[free_slot_count++] = slot;
+            }
+        }
+
+        // Releases the block's fixed buffer slot before the block is
+        // freed. The block must not be in flight.
+        void unregister_buffer(async_io& aio) noexcept
+        {
+            if (aio.buf_index == async_io::unregistered)
+            {
+                return;
+            }
+
+            // A slot the kernel still maps is never reused
+            if (update_slot(aio.buf_index, nullptr, 0))
+            {
+                free_slots[free_slot_count++] = aio.buf_index;
+            }
+            aio.buf_index = async_io::unregistered;
+        }
+
+        // Returns false if the kernel can't take the write right now and
+        // nothing is in flight to wait on; the caller writes it
+        // synchronously instead.
+        [[nodiscard]] bool submit_write(const int fd, async_io& aio)
+        {
+            // Keep the completion queue from overflowing
+            if (in_flight == cq_entries)
+            {
+                wait(1);
+            }
+
+            const auto tail {*sq_tail};
+            const auto idx {tail & sq_mask};
+            auto& sqe {sqes[idx]};
+            sqe = {};
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<std::uintptr_t>(aio.buffer);
+            sqe.len = static_cast<std::uint32_t>(aio.size);
+            sqe.off = aio.offset;
+            sqe.user_data = reinterpret_cast<std::uintptr_t>(&aio);
+            if (aio.buf_index != async_io::unregistered)
+            {
+                sqe.opcode = IORING_OP_WRITE_FIXED;
+                sqe.buf_index = static_cast<std::uint16_t>(aio.buf_index);
+            }
+            else
+            {
+                sqe.opcode = IORING_OP_WRITE;
+            }
+            sq_array[idx] = idx;
+            std::atomic_ref{*sq_tail}.store(tail + 1, std::memory_order_release);
+
+            try
+            {
+                while (true)
+                {
+                    const auto submitted {enter(1, 0, 0)};
+                    if (submitted > 0)
+                    {
+                        break;
+                    }
+
+                    if (submitted == 0 || errno == EAGAIN || errno == EBUSY)
+                    {
+                        // Out of kernel resources; block until another
+                        // write completes to make room, or let the caller
+                        // write synchronously if none is outstanding
+                        if (!in_flight)
+                        {
+                            std::atomic_ref{*sq_tail}.store(tail, std::memory_order_release);
+                            return false;
+                        }
+                        wait(1);
+                        continue;
+                    }
+
+                    if (errno != EINTR)
+                    {
+                        throw os_error{"Write async failed"};
+                    }
+                }
+            }
+            catch (...)
+            {
+                // The kernel never took the entry, so take it back rather
+                // than leave it to be submitted by a later write
+                std::atomic_ref{*sq_tail}.store(tail, std::memory_order_release);
+                throw;
+            }
+
+            // Only counted once submitted, or wait_all would wait for a
+            // completion that never comes
+            aio.in_flight = true;
+            ++in_flight;
+            return true;
+        }
+
+        // Drains whatever completions are already posted without a syscall.
+        void peek() noexcept
+        {
+            auto head {*cq_head};
+            const auto tail {std::atomic_ref{*cq_tail}.load(std::memory_order_acquire)};
+
+            for (; head != tail; ++head)
+            {
+                const auto& cqe {cqes[head & cq_mask]};
+                const auto aio {reinterpret_cast<async_io*>(static_cast<std::uintptr_t>(cqe.user_data))};
+                aio->result = cqe.res;
+                aio->in_flight = false;
+                --in_flight;
+            }
+
+            std::atomic_ref{*cq_head}.store(head, std::memory_order_release);
+        }
+
+        void wait_all()
+        {
+            peek();
+            while (in_flight)
+            {
+                wait(in_flight);
+            }
+        }
+    private:
+        int ring_fd {-1};
+        bool fixed_buffers {false};
+        unsigned next_slot {0};
+        std::array<unsigned, fixed_buffer_slots> free_slots {};
+        unsigned free_slot_count {0};
+        unsigned in_flight {0};
+
+        void* sq_ptr {nullptr};
+        void* cq_ptr {nullptr};
+        std::size_t sq_len {0};
+        std::size_t cq_len {0};
+        std::size_t sqes_len {0};
+
+        unsigned* sq_head {nullptr};
+        unsigned* sq_tail {nullptr};
+        unsigned* sq_array {nullptr};
+        unsigned sq_mask {0};
+        io_uring_sqe* sqes {nullptr};
+
+        unsigned* cq_head {nullptr};
+        unsigned* cq_tail {nullptr};
+        unsigned cq_mask {0};
+        unsigned cq_entries {0};
+        io_uring_cqe* cqes {nullptr};
+
+        bool update_slot(const unsigned slot, void* const buffer, const std::size_t size) noexcept
+        {
+            iovec iov {buffer, size};
+            io_uring_rsrc_update2 update {};
+            update.offset = slot;
+            update.data = reinterpret_cast<std::uintptr_t>(&iov);
+            update.nr = 1;
+            return ::syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_BUFFERS_UPDATE, &update, sizeof(update)) == 1;
+        }
+
+        int enter(const unsigned to_submit, const unsigned min_complete, const unsigned flags) noexcept
+        {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        void wait(const unsigned min_complete)
+        {
+            while (enter(0, min_complete, IORING_ENTER_GETEVENTS) < 0)
+            {
+                if (errno != EINTR)
+                {
+                    throw os_error{"Write async failed"};
+                }
+            }
+            peek();
+        }
+    };
+#else
+    // No native async file API; writes complete synchronously.
+    class io_ring
+    {
+    public:
+        bool init() noexcept { return false; }
+        [[nodiscard]] bool valid() const noexcept { return false; }
+        void register_buffer(async_io&) noexcept {}
+        void unregister_buffer(async_io&) noexcept {}
+        bool submit_write(int, async_io&) { return false; }
+        void peek() noexcept {}
+        void wait_all() {}
+    };
+#endif
+
+    // What async_ofstream's handle points to on POSIX
+    struct async_file
+    {
+        int fd;
+        io_ring ring;
+    };
+
+    [[nodiscard]] static async_file& to_file(void* const handle) noexcept
+    {
+        return *static_cast<async_file*>(handle);
+    }
+
+    static void io_async_add_pending(async_io*& free_ios, async_io*& pending_ios) noexcept
+    {
+        const auto temp {std::exchange(free_ios, free_ios->next)};
+        temp->next = pending_ios;
+        pending_ios = temp;
+    }
+
+    static void io_async_write(async_file& file, async_io& aio, const std::size_t size, const std::size_t offset)
+    {
+        aio.size = size;
+        aio.offset = offset;
+        aio.result = 0;
+
+        if (!file.ring.valid() || size > max_io_chunk || !file.ring.submit_write(file.fd, aio))
+        {
+            io_pwrite(file.fd, aio.buffer, size, offset);
+            aio.result = static_cast<std::int64_t>(size);
+        }
+    }
+
+    // Checks the outcome of a completed write, finishing short writes
+    // synchronously.
+    static void io_async_check(async_file& file, async_io& aio)
+    {
+        if (aio.result < 0)
+        {
+            errno = static_cast<int>(-aio.result);
+            throw os_error{"Write async failed"};
+        }
+
+        if (const auto written {static_cast<std::size_t>(aio.result)}; written < aio.size)
+        {
+            io_pwrite(file.fd, aio.buffer + written, aio.size - written, aio.offset + written);
+        }
+    }
+
+    // Moves completed IOs from the pending list to the free list.
+    // Only waits for outstanding writes if `wait` is set.
+    static void io_async_reap(async_file& file, async_io*& free_ios, async_io*& pending_ios, const bool wait)
+    {
+        if (wait)
+        {
+            file.ring.wait_all();
+        }
+        else
+        {
+            file.ring.peek();
+        }
+
+        for (auto it {pending_ios}, prev {(async_io*) nullptr}; it;)
+        {
+            const auto next {it->next};
+            if (!it->in_flight)
+            {
+                if (prev) prev->next = next;
+                else      pending_ios = next;
+
+                it->next = free_ios;
+                free_ios = it;
+
+                io_async_check(file, *it);
+            }
+            else
+            {
+                prev = it;
+            }
+            it = next;
+        }
+    }
+
+    // Returns a free IO of at least `size` bytes. Every request is at least
+    // `min_size`, so free IOs smaller than that are released rather than
+    // kept around along with their fixed buffer slots.
+    static async_io& io_async_get(async_file& file, const std::size_t size, const std::size_t min_size, async_io*& free_ios, async_io*& pending_ios)
+    {
+        // First, clean up any completed IOs
+        io_async_reap(file, free_ios, pending_ios, false);
+
+        // Next, see if we have a free IO that is large enough
+        for (auto it {free_ios}, prev {(async_io*) nullptr}; it; prev = it, it = it->next)
+        {
+            if (it->capacity >= size)
+            {
+                if (prev)
+                {
+                    prev->next = it->next;
+                    it->next = free_ios;
+                    free_ios = it;
+                }
+                return *free_ios;
+            }
+        }
+
+        // Finally, allocate a new IO, dropping the ones that are too
+        // small to ever be picked again. The first one is kept since it
+        // may still back an empty put area.
+        if (free_ios)
+        {
+            for (auto it {free_ios->next}, prev {free_ios}; it;)
+            {
+                const auto next {it->next};
+                if (it->capacity < min_size)
+                {
+                    prev->next = next;
+                    file.ring.unregister_buffer(*it);
+                    it->next = nullptr;
+                    async_io::destroy(it);
+                }
+                else
+                {
+                    prev = it;
+                }
+                it = next;
+            }
+        }
+
+        const auto aio {async_io::create(size)};
+        aio->next = free_ios;
+        free_ios = aio;
+        file.ring.register_buffer(*aio);
+        return *aio;
+    }
+
+    [[nodiscard]] static int out_flags(const openmode mode) noexcept
+    {
+        int flags {O_WRONLY | O_CREAT};
+
+        if (mode & openmode::app)
+        {
+            flags |= O_APPEND;
+        }
+        else if (mode & openmode::noreplace)
+        {
+            flags |= O_EXCL;
+        }
+        else
+        {
+            flags |= O_TRUNC;
+        }
+
+        return flags;
+    }
+
+    void ofstream::open(const std::filesystem::path::string_type::value_type* const filename, const openmode mode)
+    {
+        close();
+
+        if (mode & openmode::in)
+        {
+            throw std::invalid_argument{"File must be opened with out mode"};
+        }
+
+        handle = to_handle(io_open(filename, out_flags(mode)));
+    }
+
+    void ofstream::close()
+    {
+        if (is_open())
+        {
+            flush();
+            io_close(to_fd(handle));
+            handle = nullptr;
+        }
+    }
+
+    void ofstream::flush()
+    {
+        if (is_open())
+        {
+            if (const auto written {this->amount_written()})
+            {
+                io_write(to_fd(handle), this->pbeg(), written);
+                this->setp(this->pbeg(), this->pend());
+            }
+        }
+    }
+
+    void ofstream::write(const std::byte* s, size_type count)
+    {
+        if (!is_open())
+        {
+            throw std::logic_error{"File not open"};
+        }
+
+        if (!buf.tag())
+        {
+            setbuf(nullptr, default_buffer_size);
+        }
+
+        if (this->is_buffered())
+        {
+            const auto capacity {static_cast<size_type>(this->pend() - this->pbeg())};
+
+            // Data that would not fit even an empty buffer goes out
+            // together with what is already buffered in one writev.
+            if (const auto written {this->amount_written()};
+                written && count > capacity)
+            {
+                iovec iov[2] {
+                    {this->pbeg(), written},
+                    {const_cast<std::byte*>(s), count}
+                };
+                io_writev(to_fd(handle), iov, std::size(iov));
+                this->setp(this->pbeg(), this->pend());
+                return;
+            }
+
+            // If we have stuff in our buffer, write
+            // what we can to that buffer and flush.
+            if (this->amount_written())
+            {
+                const auto amount {std::min(count, this->write_available())};
+                std::copy_n(s, amount, this->pcur());
+                this->pbump(amount);
+                count -= amount;
+                s += amount;
+                if (count)
+                {
+                    flush();
+                }
+            }
+
+            // Check to see if remaining data can fit in the buffer.
+            if (count && count <= this->write_available())
+            {
+                std::copy_n(s, count, this->pcur());
+                this->pbump(count);
+                return;
+            }
+        }
+
+        if (count)
+        {
+            io_write(to_fd(handle), s, count);
+        }
+    }
+
+    void ofstream::writev(const std::span<const std::span<const std::byte>> fragments)
+    {
+        if (!is_open())
+        {
+            throw std::logic_error{"File not open"};
+        }
+
+        if (!buf.tag())
+        {
+            setbuf(nullptr, default_buffer_size);
+        }
+
+        size_type total {0};
+        for (const auto fragment : fragments)
+        {
+            total += fragment.size();
+        }
+
+        // Small enough to just buffer
+        if (total <= this->write_available())
+        {
+            for (const auto fragment : fragments)
+            {
+                std::copy_n(fragment.data(), fragment.size(), this->pcur());
+                this->pbump(fragment.size());
+            }
+            return;
+        }
+
+        // Otherwise hand the pending buffer and every fragment to the
+        // kernel together, batching the iovecs on the stack.
+        constexpr std::size_t batch_size {16};
+        iovec iov[batch_size];
+        std::size_t n {0};
+
+        if (const auto written {this->amount_written()})
+        {
+            iov[n++] = {this->pbeg(), written};
+        }
+
+        for (const auto fragment : fragments)
+        {
+            if (n == batch_size)
+            {
+                io_writev(to_fd(handle), iov, n);
+                n = 0;
+            }
+            iov[n++] = {const_cast<std::byte*>(fragment.data()), fragment.size()};
+        }
+
+        io_writev(to_fd(handle), iov, n);
+        this->setp(this->pbeg(), this->pend());
+    }
+
+    void ofstream::fill(const std::byte b, size_type count)
+    {
+        if (!is_open())
+        {
+            throw std::logic_error{"File not open"};
+        }
+
+        if (!buf.tag())
+        {
+            setbuf(nullptr, default_buffer_size);
+        }
+
+        if (this->is_buffered())
+        {
+            while (count)
+            {
+                // If we have stuff in our buffer, write
+                // what we can to that buffer and flush.
+                if (auto amount {this->write_available()}; amount)
+                {
+                    amount = std::min(count, amount);
+                    std::fill_n(this->pcur(), amount, b);
+                    this->pbump(amount);
+                    count -= amount;
+                }
+
+                if (count)
+                {
+                    flush();
+                }
+            }
+        }
+        else
+        {
+            std::byte block[256];
+            std::fill_n(block, std::size(block), b);
+            while (count)
+            {
+                const auto amount {std::min(count, std::size(block))};
+                io_write(to_fd(handle), block, amount);
+                count -= amount;
+            }
+        }
+    }
+
+    void ofstream::overflow(const std::byte b)
+    {
+        if (!is_open())
+        {
+            throw std::logic_error{"File not open"};
+        }
+
+        if (!buf.tag())
+        {
+            setbuf(nullptr, default_buffer_size);
+        }
+
+        if (this->is_buffered())
+        {
+            if (!this->write_available())
+            {
+                flush();
+            }
+
+            *this->pcur() = b;
+            this->pbump(1);
+        }
+        else
+        {
+            io_write(to_fd(handle), &b, 1);
+        }
+    }
+
+    void ifstream::open(const std::filesystem::path::string_type::value_type* const filename, const openmode mode)
+    {
+        if (mode & openmode::out)
+        {
+            throw std::invalid_argument{"File must be opened with in mode"};
+        }
+
+        close();
+
+        handle = to_handle(io_open(filename, O_RDONLY));
+    }
+
+    void ifstream::close()
+    {
+        if (is_open())
+        {
+            io_close(to_fd(handle));
+            handle = nullptr;
+            this->setg(this->gbeg(), this->gbeg(), this->gbeg());
+        }
+    }
+
+    void ifstream::seek(const std::int64_t offset, const seek_mode origin)
+    {
+        io_seek(to_fd(handle), offset, origin);
+    }
+
+    ifstream::size_type ifstream::read(ostream& os, size_type count)
+    {
+        if (!is_open())
+        {
+            throw std::logic_error{"File not open"};
+        }
+
+        if (!buf_capacity)
+        {
+            setbuf(nullptr, default_buffer_size);
+        }
+
+        std::size_t read_count {std::min(count, this->read_available())};
+
+        if (read_count)
+        {
+            os.write(this->gcur(), read_count);
+            this->gbump(read_count);
+            count -= read_count;
+        }
+
+        while (count)
+        {
+            // Use our own buffer if we have room
+            if (*buf_capacity >= count)
+            {
+                if (underflow())
+                {
+                    const auto amount_read {std::min(count, this->read_available())};
+                    os.write(this->gcur(), amount_read);
+                    this->gbump(amount_read);
+                    read_count += amount_read;
+                }
+                break;
+            }
+
+            // Read directly into the ostream, refilling our
+            // own buffer with what follows in the same call.
+            if (os.write_available() >= count)
+            {
+                std::size_t extra_read {0};
+                const auto amount_read {os.produce([&](const auto beg, const auto) {
+                    const auto [direct, extra] {io_readv(to_fd(handle), beg, count, this->gbeg(), *buf_capacity)};
+                    extra_read = extra;
+                    return beg + direct;
+                })};
+                this->setg(this->gbeg(), this->gbeg(), this->gbeg() + extra_read);
+                read_count += amount_read;
+                break;
+            }
+            // Loop on our own buffer
+            else if (underflow())
+            {
+                const auto amount_read {std::min(count, this->read_available())};
+                os.write(this->gcur(), amount_read);
+                this->gbump(amount_read);
+                count -= amount_read;
+                read_count += amount_read;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        return read_count;
+    }
+
+    ifstream::opt_type ifstream::underflow()
+    {
+        if (!buf_capacity)
+        {
+            setbuf(nullptr, default_buffer_size);
+        }
+
+        const auto amt_read {io_read(to_fd(handle), this->gbeg(), *buf_capacity)};
+        this->setg(this->gbeg(), this->gbeg(), this->gbeg() + amt_read);
+        if (amt_read)
+        {
+            return *(this->gcur());
+        }
+
+        return {};
+    }
+
+    async_ofstream::async_ofstream() noexcept
+        : free_ios{nullptr}, pending_ios{nullptr}, offset{0}, default_buf_cap{default_buffer_size}, handle{nullptr} {}
+
+    async_ofstream::~async_ofstream() noexcept
+    {
+        try
+        {
+            close();
+        }
+        catch (...) {}
+
+        async_io::destroy(pending_ios);
+        async_io::destroy(free_ios);
+    }
+
+    void async_ofstream::open(const std::filesystem::path::string_type::value_type* const filename, const openmode mode)
+    {
+        close();
+
+        if (mode & openmode::in)
+        {
+            throw std::invalid_argument{"File must be opened with out mode"};
+        }
+
+        int flags {O_WRONLY | O_CREAT | O_EXCL};
+
+        if (mode & openmode::trunc)
+        {
+            flags = O_WRONLY | O_CREAT | O_TRUNC;
+        }
+
+        auto file {std::make_unique<async_file>()};
+        file->fd = io_open(filename, flags);
+
+        if (file->ring.init())
+        {
+            for (auto aio {free_ios}; aio; aio = aio->next)
+            {
+                file->ring.register_buffer(*aio);
+            }
+        }
+
+        handle = file.release();
+        offset = 0;
+    }
+
+    void async_ofstream::close()
+    {
+        if (is_open())
+        {
+            std::exception_ptr err;
+            try
+            {
+                flush();
+            }
+            catch (...)
+            {
+                err = std::current_exception();
+            }
+
+            const auto file {&to_file(std::exchange(handle, nullptr))};
+            const auto fd {file->fd};
+
+            // Tearing down the ring waits on anything still in flight,
+            // so the IO buffers are safe to reuse afterwards.
+            delete file;
+
+            while (pending_ios)
+            {
+                const auto temp {std::exchange(pending_ios, pending_ios->next)};
+                temp->next = free_ios;
+                free_ios = temp;
+            }
+
+            for (auto aio {free_ios}; aio; aio = aio->next)
+            {
+                aio->in_flight = false;
+                aio->buf_index = async_io::unregistered;
+            }
+
+            io_close(fd);
+
+            if (err)
+            {
+                std::rethrow_exception(err);
+            }
+        }
+    }
+
+    void async_ofstream::flush()
+    {
+        if (is_open())
+        {
+            auto& file {to_file(handle)};
+            if (const auto written {this->amount_written()}; written)
+            {
+                io_async_add_pending(free_ios, pending_ios);
+                io_async_write(file, *pending_ios, written, offset);
+                offset += written;
+                this->setp(nullptr, nullptr);
+            }
+            io_async_reap(file, free_ios, pending_ios, true);
+        }
+    }
+
+    void async_ofstream::write(const std::byte* s, size_type count)
+    {
+        if (!is_open())
+        {
+            throw std::logic_error{"File not open"};
+        }
+
+        // If we have stuff in our buffer, write
+        // what we can to that buffer and flush.
+        if (this->amount_written())
+        {
+            const auto amount {std::min(count, this->write_available())};
+            std::copy_n(s, amount, this->pcur());
+            this->pbump(amount);
+            count -= amount;
+            s += amount;
+            if (count)
+            {
+                io_async_add_pending(free_ios, pending_ios);
+                io_async_write(to_file(handle), *pending_ios, pending_ios->capacity, offset);
+                offset += pending_ios->capacity;
+                this->setp(nullptr, nullptr);
+            }
+            else
+            {
+                return;
+            }
+        }
+
+        auto& aio {io_async_get(to_file(handle), std::max(default_buf_cap, count), default_buf_cap, free_ios, pending_ios)};
+
+        // Check to see if remaining data can fit in the buffer.
+        if (count != aio.capacity)
+        {
+            this->setp(aio.buffer, aio.buffer + aio.capacity);
+            std::copy_n(s, count, this->pcur());
+            this->pbump(count);
+        }
+        else
+        {
+            std::copy_n(s, aio.capacity, aio.buffer);
+            io_async_add_pending(free_ios, pending_ios);
+            io_async_write(to_file(handle), aio, aio.capacity, offset);
+            offset += aio.capacity;
+        }
+    }
+
+    void async_ofstream::fill(const std::byte b, size_type count)
+    {
+        if (!is_open())
+        {
+            throw std::logic_error{"File not open"};
+        }
+
+        // If we have stuff in our buffer, write
+        // what we can to that buffer and flush.
+        if (this->amount_written())
+        {
+            const auto amount {std::min(count, this->write_available())};
+            std::fill_n(this->pcur(), amount, b);
+            this->pbump(amount);
+            count -= amount;
+            if (count)
+            {
+                io_async_add_pending(free_ios, pending_ios);
+                io_async_write(to_file(handle), *pending_ios, pending_ios->capacity, offset);
+                offset += pending_ios->capacity;
+                this->setp(nullptr, nullptr);
+            }
+            else
+            {
+                return;
+            }
+        }
+
+        auto& aio {io_async_get(to_file(handle), std::max(default_buf_cap, count), default_buf_cap, free_ios, pending_ios)};
+
+        // Check to see if remaining data can fit in the buffer.
+        if (count != aio.capacity)
+        {
+            this->setp(aio.buffer, aio.buffer + aio.capacity);
+            std::fill_n(this->pcur(), count, b);
+            this->pbump(count);
+        }
+        else
+        {
+            std::fill_n(aio.buffer, count, b);
+            io_async_add_pending(free_ios, pending_ios);
+            io_async_write(to_file(handle), aio, aio.capacity, offset);
+            offset += aio.capacity;
+        }
+    }
+
+    void async_ofstream::overflow(const std::byte b)
+    {
+        if (!this->write_available())
+        {
+            if (this->amount_written())
+            {
+                io_async_add_pending(free_ios, pending_ios);
+                io_async_write(to_file(handle), *pending_ios, pending_ios->capacity, offset);
+                offset += pending_ios->capacity;
+                this->setp(nullptr, nullptr);
+            }
+
+            auto& aio {io_async_get(to_file(handle), default_buf_cap, default_buf_cap, free_ios, pending_ios)};
+            this->setp(aio.buffer, aio.buffer + aio.capacity);
+        }
+
+        *this->pcur() = b;
+        this->pbump(1);
+    }
+
+    void mmap_istream::open(const std::filesystem::path::string_type::value_type* const filename, const mmap_hint hints, const size_type window)
+    {
+        close();
+
+        const auto fd {io_open(filename, O_RDONLY)};
+
+        struct stat st;
+        if (::fstat(fd, &st) < 0)
+        {
+            const auto err {errno};
+            ::close(fd);
+            errno = err;
+            throw os_error{"Stat failed"};
+        }
+
+        handle = to_handle(fd);
+        file_size = static_cast<std::uint64_t>(st.st_size);
+        this->hints = hints;
+        this->window = window;
+
+        try
+        {
+            map_view(0);
+        }
+        catch (...)
+        {
+            handle = nullptr;
+            ::close(fd);
+            throw;
+        }
+    }
+
+    void mmap_istream::close()
+    {
+        if (is_open())
+        {
+            unmap_view();
+            io_close(to_fd(std::exchange(handle, nullptr)));
+            file_size = 0;
+        }
+    }
+
+    void mmap_istream::map_view(const std::uint64_t offset)
+    {
+        unmap_view();
+
+        if (offset >= file_size)
+        {
+            map_offset = offset;
+            return;
+        }
+
+        static const auto granularity {static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE))};
+
+        const auto aligned {offset & ~(granularity - 1)};
+        auto length {file_size - aligned};
+        if (window)
+        {
+            const auto window_size {std::max<std::uint64_t>((window + granularity - 1) & ~(granularity - 1), granularity)};
+            length = std::min(length, window_size);
+        }
+
+        const auto base {::mmap(nullptr, static_cast<std::size_t>(length), PROT_READ, MAP_PRIVATE, to_fd(handle), static_cast<off_t>(aligned))};
+        if (base == MAP_FAILED)
+        {
+            throw os_error{"Map failed"};
+        }
+
+        // Advice is only a hint; failures are not worth reporting.
+        if (hints & mmap_hint::sequential)
+        {
+            ::madvise(base, static_cast<std::size_t>(length), MADV_SEQUENTIAL);
+        }
+
+        if (hints & mmap_hint::willneed)
+        {
+            ::madvise(base, static_cast<std::size_t>(length), MADV_WILLNEED);
+        }
+
+        map_base = static_cast<std::byte*>(base);
+        map_size = static_cast<size_type>(length);
+        map_offset = aligned;
+        this->setg(map_base, map_base + (offset - aligned), map_base + map_size);
+    }
+
+    void mmap_istream::unmap_view() noexcept
+    {
+        if (map_base)
+        {
+            ::munmap(map_base, map_size);
+            map_base = nullptr;
+            map_size = 0;
+        }
+        this->setg(nullptr, nullptr, nullptr);
+    }
+
+    mmap_istream::opt_type mmap_istream::underflow()
+    {
+        if (!window || !is_open())
+        {
+            return {};
+        }
+
+        map_view(map_offset + map_size);
+        if (this->read_available())
+        {
+            return *(this->gcur());
+        }
+
+        return {};
+    }
+
+    class fd_out_stream final : public ostream
+    {
+    public:
+        using size_type = typename ostream::size_type;
+
+        fd_out_stream(const int fd) noexcept
+            : fd{fd}, line_buffered{::isatty(fd) != 0}
+        {
+            this->setp(buf, buf + sizeof(buf));
+        }
+
+        ~fd_out_stream() noexcept
+        {
+            try
+            {
+                flush();
+            }
+            catch (...) {}
+        }
+
+        void flush() override
+        {
+            if (const auto written {this->amount_written()})
+            {
+                io_write(fd, this->pbeg(), written);
+                this->setp(buf, buf + sizeof(buf));
+            }
+        }
+
+        void write(const std::byte* s, size_type count) override
+        {
+            const bool needs_flushing {line_buffered && std::find(s, s + count, std::byte{'\n'}) != s + count};
+
+            // If we have stuff in our buffer, write
+            // what we can to that buffer and flush.
+            if (this->amount_written())
+            {
+                const auto amount {std::min(count, this->write_available())};
+                std::copy_n(s, amount, this->pcur());
+                this->pbump(amount);
+                count -= amount;
+                s += amount;
+                if (count)
+                {
+                    flush();
+                }
+            }
+
+            if (count)
+            {
+                if (count <= this->write_available())
+                {
+                    std::copy_n(s, count, this->pcur());
+                    this->pbump(count);
+                }
+                else
+                {
+                    io_write(fd, s, count);
+                }
+            }
+
+            if (needs_flushing)
+            {
+                flush();
+            }
+        }
+
+        void fill(const std::byte b, size_type count) override
+        {
+            const bool needs_flushing {line_buffered && count && b == std::byte{'\n'}};
+
+            while (count)
+            {
+                // If we have stuff in our buffer, write
+                // what we can to that buffer and flush.
+                if (auto amount {this->write_available()})
+                {
+                    amount = std::min(count, amount);
+                    std::fill_n(this->pcur(), amount, b);
+                    this->pbump(amount);
+                    count -= amount;
+                }
+
+                if (count)
+                {
+                    flush();
+                }
+            }
+
+            if (needs_flushing)
+            {
+                flush();
+            }
+        }
+    protected:
+        void overflow(const std::byte ch) override
+        {
+            flush();
+            *this->pcur() = ch;
+            this->pbump(1);
+        }
+    private:
+        int fd;
+        bool line_buffered;
+        std::byte buf[4096];
+    };
+
+    class fd_in_stream final : public istream
+    {
+    public:
+        using opt_type = typename istream::opt_type;
+
+        fd_in_stream(const int fd) noexcept
+            : fd{fd} {}
+
+        std::size_t read(ostream& os, std::size_t count) override
+        {
+            std::size_t read_count {std::min(count, this->read_available())};
+
+            if (read_count)
+            {
+                os.write(this->gcur(), read_count);
+                this->gbump(read_count);
+                count -= read_count;
+            }
+
+            while (count)
+            {
+                if (sizeof(buf) >= count)
+                {
+                    if (underflow())
+                    {
+                        const auto amount_read {std::min(count, this->read_available())};
+                        os.write(this->gcur(), amount_read);
+                        this->gbump(amount_read);
+                        read_count += amount_read;
+                    }
+                    break;
+                }
+
+                if (os.write_available() >= count)
+                {
+                    const auto amount_read {os.produce([&](const auto beg, const auto) {
+                        return beg + io_read(fd, beg, count);
+                    })};
+                    count -= amount_read;
+                    read_count += amount_read;
+                    if (!amount_read)
+                    {
+                        break;
+                    }
+                }
+                else if (underflow())
+                {
+                    const auto amount_read {std::min(count, this->read_available())};
+                    os.write(this->gcur(), amount_read);
+                    this->gbump(amount_read);
+                    count -= amount_read;
+                    read_count += amount_read;
+                }
+                else
+                {
+                    break;
+                }
+            }
+
+            return read_count;
+        }
+    protected:
+        opt_type underflow() override
+        {
+            // A single read so that interactive input returns per line
+            ssize_t amount;
+            do
+            {
+                amount = ::read(fd, buf, sizeof(buf));
+            }
+            while (amount < 0 && errno == EINTR);
+
+            if (amount < 0)
+            {
+                throw os_error{"Read failed"};
+            }
+
+            if (amount)
+            {
+                this->setg(buf, buf, buf + amount);
+                return buf[0];
+            }
+
+            return {};
+        }
+    private:
+        std::byte buf[4096];
+        int fd;
+    };
+
+    // For when a standard descriptor is closed at startup
+    class null_stdostream final : public ostream
+    {
+    public:
+        null_stdostream(std::error_code ec) noexcept
+            : ec{std::move(ec)} {}
+    protected:
+        void overflow(const std::byte) override
+        {
+            throw std::system_error{ec};
+        }
+    private:
+        std::error_code ec;
+    };
+
+    class null_stdistream final : public istream
+    {
+    public:
+        using opt_type = istream::opt_type;
+
+        null_stdistream(std::error_code ec) noexcept
+            : ec{std::move(ec)} {}
+    protected:
+        opt_type underflow() override
+        {
+            throw std::system_error{ec};
+        }
+    private:
+        std::error_code ec;
+    };
+
+    [[nodiscard]] static std::error_code check_fd(const int fd) noexcept
+    {
+        if (::fcntl(fd, F_GETFD) < 0)
+        {
+            return {errno, std::system_category()};
+        }
+
+        return {};
+    }
+
+    text_ostream init_cout() noexcept
+    {
+        if (const auto err {check_fd(STDOUT_FILENO)})
+        {
+            static null_stdostream null_cout {err};
+            return null_cout;
+        }
+
+        static fd_out_stream f_cout {STDOUT_FILENO};
+        return f_cout;
+    }
+
+    text_ostream init_cerr() noexcept
+    {
+        if (const auto err {check_fd(STDERR_FILENO)})
+        {
+            static null_stdostream null_cerr {err};
+            return null_cerr;
+        }
+
+        static fd_out_stream f_cerr {STDERR_FILENO};
+        return f_cerr;
+    }
+
+    text_istream init_cin() noexcept
+    {
+        if (const auto err {check_fd(STDIN_FILENO)})
+        {
+            static null_stdistream null_cin {err};
+            return null_cin;
+        }
+
+        static fd_in_stream f_cin {STDIN_FILENO};
+        return f_cin;
+    }
+}
\ No newline at end of file
@@ -348,6 +348,16 @@ namespace lib2
         }
     }
 
+    void ofstream::writev(const std::span<const std::span<const std::byte>> fragments)
+    {
+        // WriteFileGather requires unbuffered, page aligned IO, so
+        // fragments go through the regular buffered path instead.
+        for (const auto fragment : fragments)
+        {
+            write(fragment.data(), fragment.size());
+        }
+    }
+
     void ofstream::fill(const std::byte b, size_type count)
     {
         if (!is_open())
@@ -697,6 +707,147 @@ namespace lib2
         this->pbump(1);
     }
 
+    void mmap_istream::open(const std::filesystem::path::string_type::value_type* const filename, const mmap_hint hints, const size_type window)
+    {
+        close();
+
+        const auto file {io_open(filename, GENERIC_READ, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | ((hints & mmap_hint::sequential) ? FILE_FLAG_SEQUENTIAL_SCAN : 0))};
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size))
+        {
+            const auto err {GetLastError()};
+            CloseHandle(file);
+            SetLastError(err);
+            throw os_error{"Stat failed"};
+        }
+
+        // Empty files cannot be mapped, so leave the mapping null.
+        HANDLE file_mapping {nullptr};
+        if (size.QuadPart)
+        {
+            file_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!file_mapping)
+            {
+                const auto err {GetLastError()};
+                CloseHandle(file);
+                SetLastError(err);
+                throw os_error{"Map failed"};
+            }
+        }
+
+        handle = file;
+        mapping = file_mapping;
+        file_size = static_cast<std::uint64_t>(size.QuadPart);
+        this->hints = hints;
+        this->window = window;
+
+        try
+        {
+            map_view(0);
+        }
+        catch (...)
+        {
+            if (mapping)
+            {
+                CloseHandle(std::exchange(mapping, nullptr));
+            }
+            CloseHandle(std::exchange(handle, nullptr));
+            throw;
+        }
+    }
+
+    void mmap_istream::close()
+    {
+        if (is_open())
+        {
+            unmap_view();
+            if (mapping)
+            {
+                io_close(std::exchange(mapping, nullptr));
+            }
+            io_close(std::exchange(handle, nullptr));
+            file_size = 0;
+        }
+    }
+
+    void mmap_istream::map_view(const std::uint64_t offset)
+    {
+        unmap_view();
+
+        if (offset >= file_size)
+        {
+            map_offset = offset;
+            return;
+        }
+
+        static const auto granularity {[] {
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return static_cast<std::uint64_t>(info.dwAllocationGranularity);
+        }()};
+
+        const auto aligned {offset & ~(granularity - 1)};
+        auto length {file_size - aligned};
+        if (window)
+        {
+            const auto window_size {std::max<std::uint64_t>((window + granularity - 1) & ~(granularity - 1), granularity)};
+            length = std::min(length, window_size);
+        }
+
+        const auto base {MapViewOfFile(
+            mapping,
+            FILE_MAP_READ,
+            static_cast<DWORD>(aligned >> 32),
+            static_cast<DWORD>(aligned & std::numeric_limits<DWORD>::max()),
+            static_cast<SIZE_T>(length)
+        )};
+
+        if (!base)
+        {
+            throw os_error{"Map failed"};
+        }
+
+        // Prefetching is only a hint; failures are not worth reporting.
+        if (hints & mmap_hint::willneed)
+        {
+            WIN32_MEMORY_RANGE_ENTRY entry {base, static_cast<SIZE_T>(length)};
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0);
+        }
+
+        map_base = static_cast<std::byte*>(base);
+        map_size = static_cast<size_type>(length);
+        map_offset = aligned;
+        this->setg(map_base, map_base + (offset - aligned), map_base + map_size);
+    }
+
+    void mmap_istream::unmap_view() noexcept
+    {
+        if (map_base)
+        {
+            UnmapViewOfFile(map_base);
+            map_base = nullptr;
+            map_size = 0;
+        }
+        this->setg(nullptr, nullptr, nullptr);
+    }
+
+    mmap_istream::opt_type mmap_istream::underflow()
+    {
+        if (!window || !is_open())
+        {
+            return {};
+        }
+
+        map_view(map_offset + map_size);
+        if (this->read_available())
+        {
+            return *(this->gcur());
+        }
+
+        return {};
+    }
+
     class whandle_out_stream final : public ostream
     {
     public:
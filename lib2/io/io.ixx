@@ -4,5 +4,7 @@ export import :ostream;
 export import :istream;
 export import :iostream;
 export import :stringstream;
+export import :string_builder;
 export import :spanstream;
-export import :fstream;
\ No newline at end of file
+export import :fstream;
+export import :syncstream;
\ No newline at end of file
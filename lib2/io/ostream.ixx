@@ -61,6 +61,17 @@ namespace lib2
             }
         }
 
+        // Gather write. Streams backed by a file descriptor override this
+        // to hand large fragments to the OS without copying them into the
+        // put area first.
+        virtual constexpr void writev(const std::span<const std::span<const std::byte>> fragments)
+        {
+            for (const auto fragment : fragments)
+            {
+                write(fragment.data(), fragment.size());
+            }
+        }
+
         virtual constexpr void fill(const std::byte val, size_type count)
         {
             while (count)
@@ -87,11 +98,23 @@ namespace lib2
             const auto old_pcur {std::exchange(pcur_, std::invoke(std::forward<F>(f), pcur_, pend_))};
             return static_cast<size_type>(pcur_ - old_pcur);
         }
+
+        // Marks the end of a formatted record. A line buffered stream is
+        // told when the record ended a line, since the newline may have
+        // gone through the put area without reaching it.
+        constexpr void end_record()
+        {
+            if (line_buffered_ && pcur_ != pbeg_ && pcur_[-1] == std::byte{'\n'})
+            {
+                end_line();
+            }
+        }
     protected:
         constexpr ostream() noexcept
             : pbeg_{nullptr}
             , pcur_{nullptr}
-            , pend_{nullptr} {}
+            , pend_{nullptr}
+            , line_buffered_{false} {}
 
         constexpr ostream(const ostream&) noexcept = default;
 
@@ -128,6 +151,11 @@ namespace lib2
             pend_ = pe;
         }
 
+        constexpr void set_line_buffered(const bool line_buffered) noexcept
+        {
+            line_buffered_ = line_buffered;
+        }
+
         constexpr void swap(ostream& other) noexcept
         {
             std::swap(pbeg_, other.pbeg_);
@@ -139,10 +167,13 @@ namespace lib2
         {
             throw std::logic_error{"Overflow not supported"};
         }
+
+        virtual void end_line() {}
     private:
         std::byte* pbeg_;
         std::byte* pcur_;
         std::byte* pend_;
+        bool line_buffered_;
     };
 
     export
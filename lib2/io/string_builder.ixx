@@ -0,0 +1,236 @@
+export module lib2.io:string_builder;
+
+import std;
+
+import :ostream;
+
+namespace lib2
+{
+    // How a buffer grows when it runs out of room: by numerator /
+    // denominator of its capacity, or to what is needed if that is more
+    export
+    struct growth_policy
+    {
+        std::size_t numerator {2};
+        std::size_t denominator {1};
+
+        [[nodiscard]] constexpr std::size_t next_capacity(const std::size_t capacity, const std::size_t required) const noexcept
+        {
+            const auto grown {capacity <= std::numeric_limits<std::size_t>::max() / std::max(numerator, std::size_t{1})
+                ? capacity * numerator / std::max(denominator, std::size_t{1})
+                : std::numeric_limits<std::size_t>::max()
+            };
+            return std::max(grown, required);
+        }
+    };
+
+    // Output stream into memory, starting in an inline buffer of
+    // InlineSize bytes and moving to the heap when that runs out. Unlike
+    // an ostringstream, whose string is moved out by str() &&, the buffer
+    // stays with the builder and clear() keeps its capacity, so a builder
+    // reused for every message stops allocating once it has grown to fit.
+    // lib2::format formats short strings through one.
+    export
+    template<std::size_t InlineSize = 500, class Allocator = std::allocator<char>>
+    class basic_string_builder : public ostream
+    {
+        using alloc_traits = std::allocator_traits<Allocator>;
+    public:
+        using value_type     = ostream::value_type;
+        using size_type      = ostream::size_type;
+        using ssize_type     = ostream::ssize_type;
+        using char_type      = char;
+        using traits_type    = std::char_traits<char>;
+        using allocator_type = Allocator;
+
+        static constexpr size_type inline_size {InlineSize};
+
+        basic_string_builder() noexcept(std::is_nothrow_default_constructible_v<Allocator>)
+            : basic_string_builder{growth_policy{}, Allocator{}} {}
+
+        explicit basic_string_builder(const growth_policy growth, const Allocator& alloc = Allocator{}) noexcept
+            : alloc_{alloc}
+            , growth_{growth}
+        {
+            this->setp(bytes(inline_.data()), bytes(inline_.data()) + inline_.size());
+        }
+
+        explicit basic_string_builder(const Allocator& alloc) noexcept
+            : basic_string_builder{growth_policy{}, alloc} {}
+
+        basic_string_builder(basic_string_builder&& other) noexcept
+            : alloc_{other.alloc_}
+            , growth_{other.growth_}
+        {
+            const auto size {other.size()};
+            if (other.on_heap())
+            {
+                this->setp(other.pbeg(), other.pend());
+                other.setp(bytes(other.inline_.data()), bytes(other.inline_.data()) + other.inline_.size());
+            }
+            else
+            {
+                std::copy_n(other.inline_.data(), size, inline_.data());
+                this->setp(bytes(inline_.data()), bytes(inline_.data()) + inline_.size());
+                other.clear();
+            }
+            this->pbump(static_cast<ssize_type>(size));
+        }
+
+        basic_string_builder(const basic_string_builder&) = delete;
+        basic_string_builder& operator=(const basic_string_builder&) = delete;
+
+        ~basic_string_builder() noexcept override
+        {
+            deallocate();
+        }
+
+        [[nodiscard]] std::string_view view() const noexcept
+        {
+            return {data(), size()};
+        }
+
+        [[nodiscard]] const char* data() const noexcept
+        {
+            return reinterpret_cast<const char*>(this->pbeg());
+        }
+
+        [[nodiscard]] size_type size() const noexcept
+        {
+            return this->amount_written();
+        }
+
+        [[nodiscard]] size_type capacity() const noexcept
+        {
+            return static_cast<size_type>(this->pend() - this->pbeg());
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        [[nodiscard]] std::basic_string<char_type, traits_type, Allocator> str() const
+        {
+            return std::basic_string<char_type, traits_type, Allocator>{view(), alloc_};
+        }
+
+        template<class SAlloc>
+        [[nodiscard]] std::basic_string<char_type, traits_type, SAlloc> str(const SAlloc& a) const
+        {
+            return std::basic_string<char_type, traits_type, SAlloc>{view(), a};
+        }
+
+        // Empties the builder, keeping its capacity
+        void clear() noexcept
+        {
+            this->setp(this->pbeg(), this->pend());
+        }
+
+        void reserve(const size_type new_capacity)
+        {
+            if (new_capacity > capacity())
+            {
+                reallocate(new_capacity);
+            }
+        }
+
+        [[nodiscard]] const growth_policy& growth() const noexcept
+        {
+            return growth_;
+        }
+
+        void growth(const growth_policy policy) noexcept
+        {
+            growth_ = policy;
+        }
+
+        void put(const char ch)
+        {
+            ostream::put(std::byte(ch));
+        }
+
+        void write(const std::byte* const s, const size_type count) override
+        {
+            if (count > this->write_available())
+            {
+                grow(count);
+            }
+
+            std::copy_n(s, count, this->pcur());
+            this->pbump(static_cast<ssize_type>(count));
+        }
+
+        void write(const char_type* const s, const size_type count)
+        {
+            write(reinterpret_cast<const std::byte*>(s), count);
+        }
+
+        void write(const std::string_view str)
+        {
+            write(reinterpret_cast<const std::byte*>(str.data()), str.size());
+        }
+
+        void fill(const std::byte ch, const size_type count) override
+        {
+            if (count > this->write_available())
+            {
+                grow(count);
+            }
+
+            std::fill_n(this->pcur(), count, ch);
+            this->pbump(static_cast<ssize_type>(count));
+        }
+
+        void fill(const char_type ch, const size_type count)
+        {
+            fill(std::byte(ch), count);
+        }
+    protected:
+        void overflow(const std::byte ch) override
+        {
+            write(&ch, 1);
+        }
+    private:
+        [[msvc::no_unique_address]] Allocator alloc_;
+        growth_policy growth_;
+        std::array<char, InlineSize> inline_;
+
+        static std::byte* bytes(char* const p) noexcept
+        {
+            return reinterpret_cast<std::byte*>(p);
+        }
+
+        [[nodiscard]] bool on_heap() const noexcept
+        {
+            return this->pbeg() != bytes(const_cast<char*>(inline_.data()));
+        }
+
+        void grow(const size_type count)
+        {
+            reallocate(growth_.next_capacity(capacity(), size() + count));
+        }
+
+        void reallocate(const size_type new_capacity)
+        {
+            const auto size {this->size()};
+            char* const mem {alloc_traits::allocate(alloc_, new_capacity)};
+            std::copy_n(data(), size, mem);
+            deallocate();
+
+            this->setp(bytes(mem), bytes(mem) + new_capacity);
+            this->pbump(static_cast<ssize_type>(size));
+        }
+
+        void deallocate() noexcept
+        {
+            if (on_heap())
+            {
+                alloc_traits::deallocate(alloc_, reinterpret_cast<char*>(this->pbeg()), capacity());
+            }
+        }
+    };
+
+    export
+    using string_builder = basic_string_builder<>;
+}
\ No newline at end of file
@@ -294,7 +294,7 @@ namespace lib2
 
         constexpr std::basic_string<char_type, traits_type, Allocator> str() const&
         {
-            return std::basic_string<char_type, traits_type, Allocator>{view()};
+            return std::basic_string<char_type, traits_type, Allocator>{view(), buf.get_allocator()};
         }
 
         template<class SAlloc>
@@ -344,6 +344,14 @@ namespace lib2
             init_buf_ptrs();
         }
 
+        // Empties the stream, keeping the string's capacity for what is
+        // written next
+        constexpr void clear() noexcept
+        {
+            buf.clear();
+            init_buf_ptrs();
+        }
+
         constexpr void put(const char ch)
         {
             ostream::put(std::byte(ch));
@@ -532,7 +540,7 @@ namespace lib2
 
         constexpr std::basic_string<char_type, traits_type, Allocator> str() const&
         {
-            return std::basic_string<char_type, traits_type, Allocator>{view()};
+            return std::basic_string<char_type, traits_type, Allocator>{view(), buf.get_allocator()};
         }
 
         template<class SAlloc>
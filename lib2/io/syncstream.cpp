@@ -0,0 +1,395 @@
+module lib2.io;
+
+import std;
+
+namespace lib2
+{
+    constexpr std::size_t default_record_size {1024};
+
+    // Records larger than this are committed even without a newline
+    constexpr std::size_t max_record_size {64 * 1024};
+
+    struct sync_record
+    {
+    private:
+        sync_record(const std::size_t buf_size) noexcept
+            : next{nullptr}, size{0}, capacity{buf_size} {}
+    public:
+        std::atomic<sync_record*> next;
+        std::size_t size;
+        std::size_t capacity;
+        std::byte buffer[1];
+
+        static sync_record* create(const std::size_t buf_size)
+        {
+            const auto total_size {sizeof(sync_record) + (buf_size - 1)};
+            sync_record* mem {static_cast<sync_record*>(::operator new(total_size))};
+            return new (mem) sync_record{buf_size};
+        }
+
+        static void destroy(sync_record* const rec) noexcept
+        {
+            if (rec)
+            {
+                rec->~sync_record();
+                ::operator delete(rec);
+            }
+        }
+    };
+
+    sync_writer::sync_writer(sync_ostream& owner) noexcept
+        : owner{&owner}
+    {
+        this->set_line_buffered(true);
+    }
+
+    sync_writer::~sync_writer() noexcept
+    {
+        sync_record::destroy(rec);
+    }
+
+    void sync_writer::write(const std::byte* const s, const size_type count)
+    {
+        if (!count)
+        {
+            return;
+        }
+
+        if (count > this->write_available())
+        {
+            reserve(count);
+        }
+
+        std::copy_n(s, count, this->pcur());
+        this->pbump(static_cast<ssize_type>(count));
+
+        if (s[count - 1] == std::byte{'\n'})
+        {
+            commit();
+        }
+    }
+
+    void sync_writer::fill(const std::byte b, const size_type count)
+    {
+        if (!count)
+        {
+            return;
+        }
+
+        if (count > this->write_available())
+        {
+            reserve(count);
+        }
+
+        std::fill_n(this->pcur(), count, b);
+        this->pbump(static_cast<ssize_type>(count));
+
+        if (b == std::byte{'\n'})
+        {
+            commit();
+        }
+    }
+
+    void sync_writer::flush()
+    {
+        owner->flush();
+    }
+
+    void sync_writer::commit()
+    {
+        if (rec && this->amount_written())
+        {
+            rec->size = this->amount_written();
+            this->setp(nullptr, nullptr);
+            owner->commit(std::exchange(rec, nullptr));
+        }
+    }
+
+    void sync_writer::overflow(const std::byte b)
+    {
+        write(&b, 1);
+    }
+
+    void sync_writer::end_line()
+    {
+        commit();
+    }
+
+    // Makes room for count more bytes. Lines that went through the put
+    // area are committed first, and what follows the last of them starts
+    // the next record; otherwise the record grows, or is committed once
+    // it would grow past max_record_size.
+    void sync_writer::reserve(const size_type count)
+    {
+        auto size {this->amount_written()};
+
+        const auto last_newline {std::find(std::make_reverse_iterator(this->pcur()), std::make_reverse_iterator(this->pbeg()), std::byte{'\n'})};
+
+        if (!rec)
+        {
+            rec = sync_record::create(std::max(default_record_size, count));
+        }
+        else if (last_newline.base() != this->pbeg())
+        {
+            const auto line_end {last_newline.base()};
+            const auto tail {static_cast<size_type>(this->pcur() - line_end)};
+            const auto next {sync_record::create(std::max(default_record_size, tail + count))};
+            std::copy_n(line_end, tail, next->buffer);
+
+            const auto full {std::exchange(rec, next)};
+            full->size = static_cast<size_type>(line_end - this->pbeg());
+            this->setp(rec->buffer, rec->buffer + rec->capacity);
+            this->pbump(static_cast<ssize_type>(tail));
+            owner->commit(full);
+            return;
+        }
+        else if (size + count > max_record_size)
+        {
+            commit();
+            size = 0;
+            if (!rec)
+            {
+                rec = sync_record::create(std::max(default_record_size, count));
+            }
+            else if (rec->capacity < count)
+            {
+                sync_record::destroy(std::exchange(rec, sync_record::create(std::max(default_record_size, count))));
+            }
+        }
+        else
+        {
+            const auto bigger {sync_record::create(std::max(rec->capacity * 2, size + count))};
+            std::copy_n(rec->buffer, size, bigger->buffer);
+            sync_record::destroy(std::exchange(rec, bigger));
+        }
+
+        this->setp(rec->buffer, rec->buffer + rec->capacity);
+        this->pbump(static_cast<ssize_type>(size));
+    }
+
+    // The calling thread's writers, one for each sync_ostream it has
+    // written to. They commit what is pending when the thread exits.
+    struct sync_thread_state
+    {
+        std::vector<std::unique_ptr<sync_writer>> writers;
+
+        ~sync_thread_state() noexcept
+        {
+            for (const auto& writer : writers)
+            {
+                try
+                {
+                    writer->commit();
+                }
+                catch (...) {}
+            }
+        }
+
+        [[nodiscard]] sync_writer* find(const sync_ostream& stream) const noexcept
+        {
+            for (const auto& writer : writers)
+            {
+                if (writer->owner == &stream)
+                {
+                    return writer.get();
+                }
+            }
+            return nullptr;
+        }
+
+        sync_writer& get(sync_ostream& stream)
+        {
+            if (const auto writer {find(stream)})
+            {
+                return *writer;
+            }
+
+            writers.reserve(writers.size() + 1);
+            return *writers.emplace_back(std::make_unique<sync_writer>(stream));
+        }
+
+        void remove(const sync_ostream& stream) noexcept
+        {
+            std::erase_if(writers, [&](const auto& writer) { return writer->owner == &stream; });
+        }
+    };
+
+    thread_local sync_thread_state sync_state;
+
+    sync_ostream::sync_ostream(ostream& sink)
+        : sink{sink}
+        , stub{sync_record::create(1)}
+        , head{stub}
+        , tail{stub} {}
+
+    sync_ostream::~sync_ostream() noexcept
+    {
+        if (const auto writer {sync_state.find(*this)})
+        {
+            try
+            {
+                writer->commit();
+            }
+            catch (...) {}
+            sync_state.remove(*this);
+        }
+
+        try
+        {
+            flush_requested.store(true, std::memory_order_release);
+            drain();
+        }
+        catch (...) {}
+
+        while (const auto rec {pop()})
+        {
+            sync_record::destroy(rec);
+        }
+        sync_record::destroy(stub);
+    }
+
+    sync_writer& sync_ostream::local()
+    {
+        return sync_state.get(*this);
+    }
+
+    void sync_ostream::write(const std::byte* const s, const size_type count)
+    {
+        sync_state.get(*this).write(s, count);
+    }
+
+    void sync_ostream::fill(const std::byte b, const size_type count)
+    {
+        sync_state.get(*this).fill(b, count);
+    }
+
+    void sync_ostream::overflow(const std::byte b)
+    {
+        sync_state.get(*this).put(b);
+    }
+
+    void sync_ostream::flush()
+    {
+        if (const auto writer {sync_state.find(*this)})
+        {
+            writer->commit();
+        }
+
+        flush_requested.store(true, std::memory_order_release);
+        drain();
+    }
+
+    void sync_ostream::commit(sync_record* const rec)
+    {
+        // Vyukov intrusive MPSC push
+        rec->next.store(nullptr, std::memory_order_relaxed);
+        const auto prev {head.exchange(rec, std::memory_order_acq_rel)};
+        prev->next.store(rec, std::memory_order_release);
+
+        drain();
+    }
+
+    // Only called by the thread holding `draining`
+    sync_record* sync_ostream::pop() noexcept
+    {
+        auto t {tail};
+        auto next {t->next.load(std::memory_order_acquire)};
+
+        if (t == stub)
+        {
+            if (!next)
+            {
+                return nullptr;
+            }
+
+            tail = next;
+            t = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next)
+        {
+            tail = next;
+            return t;
+        }
+
+        // A producer is between its exchange and its link; try again later
+        if (t != head.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+
+        stub->next.store(nullptr, std::memory_order_relaxed);
+        const auto prev {head.exchange(stub, std::memory_order_acq_rel)};
+        prev->next.store(stub, std::memory_order_release);
+
+        next = t->next.load(std::memory_order_acquire);
+        if (next)
+        {
+            tail = next;
+            return t;
+        }
+
+        return nullptr;
+    }
+
+    void sync_ostream::drain()
+    {
+        // Once the queue is fully drained head points back at the stub,
+        // so anything else means a record arrived while we were writing.
+        // A flush asked for meanwhile is likewise left to us.
+        do
+        {
+            if (draining.test_and_set(std::memory_order_acquire))
+            {
+                // Whoever holds it will see our record
+                return;
+            }
+
+            try
+            {
+                while (const auto rec {pop()})
+                {
+                    // Freed even when the sink throws
+                    struct record_guard
+                    {
+                        sync_record* rec;
+
+                        ~record_guard() noexcept
+                        {
+                            sync_record::destroy(rec);
+                        }
+                    } guard {rec};
+
+                    sink.write(rec->buffer, rec->size);
+                }
+
+                // Only the draining thread may touch the sink
+                if (flush_requested.exchange(false, std::memory_order_acq_rel))
+                {
+                    sink.flush();
+                }
+            }
+            catch (...)
+            {
+                draining.clear(std::memory_order_release);
+                throw;
+            }
+
+            draining.clear(std::memory_order_release);
+        }
+        while (head.load(std::memory_order_acquire) != stub || flush_requested.load(std::memory_order_acquire));
+    }
+
+    text_ostream init_sync_cout()
+    {
+        static sync_ostream s_cout {cout.stream};
+        return s_cout;
+    }
+
+    text_ostream init_sync_cerr()
+    {
+        static sync_ostream s_cerr {cerr.stream};
+        return s_cerr;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+export module lib2.io:syncstream;
+
+import std;
+
+import :ostream;
+import :fstream;
+
+namespace lib2
+{
+    struct sync_record;
+    struct sync_thread_state;
+
+    export
+    class sync_ostream;
+
+    // The calling thread's writer to one sync_ostream, as given by its
+    // local(). Its put area is the free space of the record it is
+    // building, so puts and small writes go straight into the record.
+    export
+    class sync_writer final : public ostream
+    {
+        friend class sync_ostream;
+        friend struct sync_thread_state;
+    public:
+        using size_type  = ostream::size_type;
+        using ssize_type = ostream::ssize_type;
+
+        explicit sync_writer(sync_ostream& owner) noexcept;
+
+        sync_writer(const sync_writer&) = delete;
+        sync_writer& operator=(const sync_writer&) = delete;
+
+        ~sync_writer() noexcept override;
+
+        // Commits the record once b ends a line
+        void put(const std::byte b)
+        {
+            ostream::put(b);
+            if (b == std::byte{'\n'})
+            {
+                commit();
+            }
+        }
+
+        void write(const std::byte* s, size_type count) override;
+        void fill(std::byte b, size_type count) override;
+        void flush() override;
+
+        void commit();
+    protected:
+        void overflow(std::byte b) override;
+        void end_line() override;
+    private:
+        sync_ostream* owner;
+        sync_record* rec {nullptr};
+
+        void reserve(size_type count);
+    };
+
+    // An ostream that can be written to from many threads at once. Each
+    // thread formats into its own thread-local record; a record is
+    // committed when it ends a line, when it grows past 64K or on
+    // flush(), and committed records are handed to the sink through a
+    // lock-free MPSC queue. Whichever thread commits drains the queue if
+    // nobody else is, so the sink only ever sees whole records. The sink
+    // is flushed by flush() and on destruction, not by every drain, so a
+    // buffered sink still batches many records into one write.
+    //
+    // Writing to the sync_ostream itself looks up the calling thread's
+    // record on every call. local() gives the thread's writer, whose put
+    // area is the free space of its record, for many small writes.
+    //
+    // The sink is never locked, so it must not be written to directly
+    // while a sync_ostream is in use. A sync_ostream must outlive every
+    // thread that writes to it.
+    export
+    class sync_ostream final : public ostream
+    {
+        friend class sync_writer;
+        friend struct sync_thread_state;
+    public:
+        using size_type  = ostream::size_type;
+        using ssize_type = ostream::ssize_type;
+
+        explicit sync_ostream(ostream& sink);
+
+        sync_ostream(const sync_ostream&) = delete;
+        sync_ostream& operator=(const sync_ostream&) = delete;
+
+        ~sync_ostream() noexcept;
+
+        // The calling thread's writer to this stream
+        [[nodiscard]] sync_writer& local();
+
+        void write(const std::byte* s, size_type count) override;
+        void fill(std::byte b, size_type count) override;
+
+        // Commits the calling thread's pending record, drains the queue and
+        // flushes the sink.
+        void flush() override;
+    protected:
+        void overflow(std::byte b) override;
+    private:
+        ostream& sink;
+        sync_record* stub;
+        std::atomic<sync_record*> head;
+        sync_record* tail;
+        std::atomic_flag draining;
+        std::atomic<bool> flush_requested {false};
+
+        void commit(sync_record* rec);
+        sync_record* pop() noexcept;
+        void drain();
+    };
+
+    text_ostream init_sync_cout();
+    text_ostream init_sync_cerr();
+
+    export
+    text_ostream sync_cout {init_sync_cout()};
+
+    export
+    text_ostream sync_cerr {init_sync_cerr()};
+}
\ No newline at end of file
@@ -12,5 +12,7 @@ export import lib2.err;
 export import lib2.shared;
 export import lib2.io;
 export import lib2.fmt;
+export import lib2.scan;
+export import lib2.log;
 export import lib2.test;
 export import lib2.benchmarking;
\ No newline at end of file
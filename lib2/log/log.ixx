@@ -0,0 +1,3 @@
+export module lib2.log;
+export import :log_queue;
+export import :logger;
\ No newline at end of file
@@ -0,0 +1,121 @@
+export module lib2.log:log_queue;
+
+import std;
+
+import lib2.io;
+
+namespace lib2
+{
+    // Every record starts on this boundary
+    export
+    constexpr std::size_t log_record_alignment {alignof(std::max_align_t)};
+
+    constexpr std::size_t log_cache_line_size {64};
+
+    export
+    [[nodiscard]] constexpr std::size_t log_align_up(const std::size_t n, const std::size_t alignment) noexcept
+    {
+        return (n + alignment - 1) & ~(alignment - 1);
+    }
+
+    // Header of a record in a log_queue. The arguments follow it in the
+    // queue and are read, formatted and destroyed by `format`. A record
+    // without a `format` is padding up to the end of the buffer.
+    export
+    struct log_record
+    {
+        void (*format)(text_ostream, std::byte*);
+        std::size_t size;
+    };
+
+    // Single producer, single consumer ring of variable sized records.
+    // Records never wrap around the end of the buffer; if one would, the
+    // rest of the buffer is filled with padding and the record starts
+    // over at the beginning.
+    export
+    class log_queue
+    {
+    public:
+        explicit log_queue(std::size_t capacity);
+
+        log_queue(const log_queue&) = delete;
+        log_queue& operator=(const log_queue&) = delete;
+
+        ~log_queue() noexcept;
+
+        [[nodiscard]] std::size_t capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+        // Producer side. Returns space for a record of `size` bytes,
+        // waiting for the consumer if the queue is full. `size` must be a
+        // multiple of log_record_alignment.
+        [[nodiscard]] std::byte* reserve(const std::size_t size)
+        {
+            if (size > capacity_)
+            {
+                throw std::length_error{"Log record is larger than the log queue"};
+            }
+
+            auto offset {head & (capacity_ - 1)};
+            const auto contiguous {capacity_ - offset};
+            if (size > contiguous)
+            {
+                wait_for_space(contiguous);
+                new (buffer + offset) log_record{nullptr, contiguous};
+                commit(contiguous);
+                offset = 0;
+            }
+
+            wait_for_space(size);
+            return buffer + offset;
+        }
+
+        // Producer side. Publishes the record returned by reserve(). The
+        // store is sequentially consistent so that a backend going idle
+        // either sees the record or is seen idle by the producer.
+        void commit(const std::size_t size) noexcept
+        {
+            head += size;
+            write_pos.store(head, std::memory_order_seq_cst);
+        }
+
+        // Consumer side. Formats every record published so far into `os`.
+        // Returns the number of records consumed.
+        std::size_t consume(text_ostream os);
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return read_pos.load(std::memory_order_acquire) == write_pos.load(std::memory_order_acquire);
+        }
+
+        // Set by the producer once it will never write again
+        std::atomic<bool> abandoned {false};
+
+        // Set by the logger once it is destroyed, so that the producer
+        // can let go of the queue
+        std::atomic<bool> closed {false};
+    private:
+        std::byte* buffer;
+        std::size_t capacity_;
+
+        // Producer owned
+        alignas(log_cache_line_size) std::size_t head {0};
+        std::size_t cached_tail {0};
+        std::atomic<std::size_t> write_pos {0};
+
+        // Consumer owned
+        alignas(log_cache_line_size) std::atomic<std::size_t> read_pos {0};
+
+        void wait_for_space(const std::size_t size)
+        {
+            if (capacity_ - (head - cached_tail) < size) [[unlikely]]
+            {
+                wait_for_consumer(size);
+            }
+        }
+
+        void wait_for_consumer(std::size_t size) noexcept;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,304 @@
+module lib2.log;
+
+import std;
+
+import lib2.io;
+
+namespace lib2
+{
+    // The backend polls for a few rounds after running out of work, so
+    // that bursts of logging don't each pay for a wake-up, then blocks
+    // until a producer or flush() wakes it
+    constexpr std::chrono::microseconds backend_idle_sleep {50};
+    constexpr int backend_idle_rounds {20};
+
+    std::atomic<std::uint64_t> next_logger_id {0};
+
+    log_queue::log_queue(const std::size_t capacity)
+        : buffer{nullptr}
+        , capacity_{std::bit_ceil(std::max(capacity, std::size_t{4096}))}
+    {
+        buffer = static_cast<std::byte*>(::operator new(capacity_, std::align_val_t{log_cache_line_size}));
+    }
+
+    log_queue::~log_queue() noexcept
+    {
+        // Destroy the arguments of anything never formatted
+        auto pos {read_pos.load(std::memory_order_relaxed)};
+        const auto end {write_pos.load(std::memory_order_relaxed)};
+        while (pos != end)
+        {
+            const auto record {std::launder(reinterpret_cast<log_record*>(buffer + (pos & (capacity_ - 1))))};
+            if (record->format)
+            {
+                size_ostream discard;
+                try
+                {
+                    record->format(discard, reinterpret_cast<std::byte*>(record));
+                }
+                catch (...) {}
+            }
+            pos += record->size;
+        }
+
+        ::operator delete(buffer, capacity_, std::align_val_t{log_cache_line_size});
+    }
+
+    void log_queue::wait_for_consumer(const std::size_t size) noexcept
+    {
+        while (true)
+        {
+            cached_tail = read_pos.load(std::memory_order_acquire);
+            if (capacity_ - (head - cached_tail) >= size)
+            {
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    std::size_t log_queue::consume(text_ostream os)
+    {
+        auto pos {read_pos.load(std::memory_order_relaxed)};
+        const auto end {write_pos.load(std::memory_order_acquire)};
+        std::size_t count {0};
+
+        while (pos != end)
+        {
+            const auto record {std::launder(reinterpret_cast<log_record*>(buffer + (pos & (capacity_ - 1))))};
+            const auto size {record->size};
+
+            // The record is released even if formatting it fails
+            struct release_guard
+            {
+                std::atomic<std::size_t>& read_pos;
+                std::size_t next;
+
+                ~release_guard() noexcept
+                {
+                    read_pos.store(next, std::memory_order_release);
+                }
+            } guard {read_pos, pos + size};
+
+            if (record->format)
+            {
+                record->format(os, reinterpret_cast<std::byte*>(record));
+                ++count;
+            }
+            pos += size;
+        }
+
+        return count;
+    }
+
+    // The queues the calling thread has registered with each logger. A
+    // thread normally logs to a single logger, so the last one is kept
+    // aside to skip the search. Queues of destroyed loggers are dropped
+    // the next time the thread registers a queue.
+    struct log_thread_state
+    {
+        std::uint64_t last_id {~std::uint64_t{0}};
+        log_queue* last_queue {nullptr};
+        std::vector<std::pair<std::uint64_t, std::shared_ptr<log_queue>>> queues;
+
+        ~log_thread_state() noexcept
+        {
+            for (const auto& [id, queue] : queues)
+            {
+                queue->abandoned.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    thread_local log_thread_state log_state;
+
+    async_logger::async_logger(ostream& sink, const std::size_t queue_capacity)
+        : sink{sink}
+        , queue_capacity{queue_capacity}
+        , id{next_logger_id.fetch_add(1, std::memory_order_relaxed)}
+        , backend{[this](const std::stop_token stop) { run(stop); }} {}
+
+    async_logger::~async_logger() noexcept
+    {
+        backend.request_stop();
+        backend.join();
+
+        for (const auto& queue : queues)
+        {
+            queue->closed.store(true, std::memory_order_release);
+        }
+    }
+
+    log_queue& async_logger::local_queue()
+    {
+        if (log_state.last_id == id) [[likely]]
+        {
+            return *log_state.last_queue;
+        }
+
+        const auto it {std::ranges::find(log_state.queues, id, [](const auto& entry) { return entry.first; })};
+        if (it != log_state.queues.end())
+        {
+            log_state.last_id = id;
+            log_state.last_queue = it->second.get();
+            return *it->second;
+        }
+
+        // Let go of the queues of loggers that are gone before adding one
+        std::erase_if(log_state.queues, [](const auto& entry) { return entry.second->closed.load(std::memory_order_acquire); });
+
+        auto queue {std::make_shared<log_queue>(queue_capacity)};
+        {
+            const std::scoped_lock lock {queues_mutex};
+            queues.push_back(queue);
+        }
+        queues_changed.store(true, std::memory_order_release);
+
+        log_state.last_id = id;
+        log_state.last_queue = queue.get();
+        log_state.queues.emplace_back(id, std::move(queue));
+        return *log_state.last_queue;
+    }
+
+    void async_logger::flush()
+    {
+        const auto ticket {flush_requested.fetch_add(1, std::memory_order_seq_cst) + 1};
+        wake_backend();
+
+        auto done {flush_done.load(std::memory_order_acquire)};
+        while (done < ticket)
+        {
+            flush_done.wait(done, std::memory_order_acquire);
+            done = flush_done.load(std::memory_order_acquire);
+        }
+
+        const std::scoped_lock lock {error_mutex};
+        if (error)
+        {
+            std::rethrow_exception(std::exchange(error, nullptr));
+        }
+    }
+
+    void async_logger::notify_backend() noexcept
+    {
+        backend_idle.store(false, std::memory_order_seq_cst);
+        backend_idle.notify_one();
+    }
+
+    bool async_logger::pending(const std::span<const std::shared_ptr<log_queue>> active, const std::stop_token stop) const noexcept
+    {
+        return stop.stop_requested()
+            || queues_changed.load(std::memory_order_acquire)
+            || flush_requested.load(std::memory_order_acquire) != flush_done.load(std::memory_order_relaxed)
+            || !std::ranges::all_of(active, [](const auto& queue) { return queue->empty(); });
+    }
+
+    std::size_t async_logger::drain(const std::span<const std::shared_ptr<log_queue>> active)
+    {
+        text_ostream os {sink};
+        std::size_t count {0};
+
+        for (const auto& queue : active)
+        {
+            try
+            {
+                count += queue->consume(os);
+            }
+            catch (...)
+            {
+                const std::scoped_lock lock {error_mutex};
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    void async_logger::run(const std::stop_token stop)
+    {
+        std::vector<std::shared_ptr<log_queue>> active;
+        bool unflushed {false};
+        int idle_rounds {0};
+
+        const std::stop_callback wake_on_stop {stop, [this]() noexcept { notify_backend(); }};
+
+        while (true)
+        {
+            // Read before picking up new queues and draining so that
+            // everything logged before a flush() was requested is written
+            // before it is acknowledged
+            const auto requested {flush_requested.load(std::memory_order_acquire)};
+            const auto stopping {stop.stop_requested()};
+
+            if (queues_changed.exchange(false, std::memory_order_acq_rel))
+            {
+                const std::scoped_lock lock {queues_mutex};
+                active = queues;
+            }
+
+            const auto count {drain(active)};
+            unflushed |= count != 0;
+
+            if (unflushed && (count == 0 || requested != flush_done.load(std::memory_order_relaxed)))
+            {
+                try
+                {
+                    sink.flush();
+                }
+                catch (...)
+                {
+                    const std::scoped_lock lock {error_mutex};
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+                unflushed = false;
+            }
+
+            if (requested != flush_done.load(std::memory_order_relaxed))
+            {
+                flush_done.store(requested, std::memory_order_release);
+                flush_done.notify_all();
+            }
+
+            if (count == 0)
+            {
+                if (std::ranges::any_of(active, [](const auto& queue) { return queue->abandoned.load(std::memory_order_acquire) && queue->empty(); }))
+                {
+                    const std::scoped_lock lock {queues_mutex};
+                    std::erase_if(queues, [](const auto& queue) { return queue->abandoned.load(std::memory_order_acquire) && queue->empty(); });
+                    active = queues;
+                }
+
+                if (stopping)
+                {
+                    break;
+                }
+
+                if (++idle_rounds < backend_idle_rounds)
+                {
+                    std::this_thread::sleep_for(backend_idle_sleep);
+                    continue;
+                }
+
+                // Producers check backend_idle after publishing a record;
+                // the fence makes sure that either they see it set or the
+                // queues are seen non-empty here
+                backend_idle.store(true, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!pending(active, stop))
+                {
+                    backend_idle.wait(true, std::memory_order_acquire);
+                }
+                backend_idle.store(false, std::memory_order_relaxed);
+            }
+
+            idle_rounds = 0;
+        }
+    }
+}
\ No newline at end of file
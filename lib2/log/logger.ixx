@@ -0,0 +1,190 @@
+export module lib2.log:logger;
+
+import std;
+
+import lib2.strings;
+import lib2.io;
+import lib2.fmt;
+
+import :log_queue;
+
+namespace lib2
+{
+    // How an argument is copied into a log record. Most arguments are
+    // stored as a copy of themselves; strings have their characters copied
+    // after the arguments and are handed back to the formatter as a
+    // std::string_view, since the caller's storage is long gone by the time
+    // the backend formats them.
+    template<class T>
+    struct log_arg
+    {
+        using stored_type = T;
+
+        [[nodiscard]] static constexpr std::size_t extra_size(const T&) noexcept
+        {
+            return 0;
+        }
+
+        [[nodiscard]] static const T& store(const T& value, const std::byte*, std::byte*&) noexcept
+        {
+            return value;
+        }
+
+        [[nodiscard]] static const T& load(const T& value, const std::byte*) noexcept
+        {
+            return value;
+        }
+    };
+
+    struct log_string
+    {
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    struct log_string_arg
+    {
+        using stored_type = log_string;
+
+        [[nodiscard]] static std::size_t extra_size(const std::string_view str) noexcept
+        {
+            return str.size();
+        }
+
+        [[nodiscard]] static log_string store(const std::string_view str, const std::byte* const payload, std::byte*& strings) noexcept
+        {
+            const log_string stored {static_cast<std::size_t>(strings - payload), str.size()};
+            strings = std::copy_n(reinterpret_cast<const std::byte*>(str.data()), str.size(), strings);
+            return stored;
+        }
+
+        [[nodiscard]] static std::string_view load(const log_string str, const std::byte* const payload) noexcept
+        {
+            return {reinterpret_cast<const char*>(payload + str.offset), str.size};
+        }
+    };
+
+    template<>
+    struct log_arg<std::string_view> : log_string_arg {};
+
+    template<class Allocator>
+    struct log_arg<std::basic_string<char, std::char_traits<char>, Allocator>> : log_string_arg {};
+
+    template<>
+    struct log_arg<const char*> : log_string_arg {};
+
+    template<>
+    struct log_arg<char*> : log_string_arg {};
+
+    template<std::size_t N>
+    struct log_arg<char[N]> : log_string_arg {};
+
+    template<class... Args>
+    using log_payload = std::tuple<typename log_arg<Args>::stored_type...>;
+
+    template<class Payload>
+    constexpr std::size_t log_payload_offset {log_align_up(sizeof(log_record), alignof(Payload))};
+
+    template<string_literal Fmt, class... Args>
+    void format_log_record(text_ostream os, std::byte* const record)
+    {
+        using payload_t = log_payload<Args...>;
+        const auto payload {record + log_payload_offset<payload_t>};
+        auto& stored {*std::launder(reinterpret_cast<payload_t*>(payload))};
+
+        struct destroy_guard
+        {
+            payload_t& stored;
+
+            ~destroy_guard() noexcept
+            {
+                std::destroy_at(&stored);
+            }
+        } guard {stored};
+
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            format_to<Fmt>(os, log_arg<Args>::load(std::get<I>(stored), payload)...);
+        }(std::index_sequence_for<Args...>{});
+    }
+
+    // Logger that keeps formatting and I/O off the calling thread. Each
+    // thread that logs gets its own preallocated log_queue; log() only
+    // copies the arguments into it, and a backend thread runs the compiled
+    // format for each record and writes the result to the sink.
+    //
+    // The sink belongs to the backend thread while the logger is alive and
+    // must not be written to directly.
+    export
+    class async_logger
+    {
+    public:
+        static constexpr std::size_t default_queue_capacity {1024 * 1024};
+
+        explicit async_logger(ostream& sink, std::size_t queue_capacity = default_queue_capacity);
+
+        async_logger(const async_logger&) = delete;
+        async_logger& operator=(const async_logger&) = delete;
+
+        // Formats everything still queued before returning
+        ~async_logger() noexcept;
+
+        template<string_literal Fmt, class... Args>
+        void log(const Args&... args)
+        {
+            using payload_t = log_payload<std::remove_cv_t<Args>...>;
+            static_assert(alignof(payload_t) <= log_record_alignment, "Over-aligned log arguments are not supported");
+
+            constexpr auto payload_offset {log_payload_offset<payload_t>};
+            const auto strings_size {(std::size_t{0} + ... + log_arg<std::remove_cv_t<Args>>::extra_size(args))};
+            const auto size {log_align_up(payload_offset + sizeof(payload_t) + strings_size, log_record_alignment)};
+
+            auto& queue {local_queue()};
+            const auto record {queue.reserve(size)};
+            const auto payload {record + payload_offset};
+            auto strings {payload + sizeof(payload_t)};
+
+            new (payload) payload_t{log_arg<std::remove_cv_t<Args>>::store(args, payload, strings)...};
+            new (record) log_record{&format_log_record<Fmt, std::remove_cv_t<Args>...>, size};
+            queue.commit(size);
+            wake_backend();
+        }
+
+        // Waits until everything the calling thread has logged is written
+        // and the sink flushed. Rethrows the first error the backend hit.
+        void flush();
+    private:
+        ostream& sink;
+        std::size_t queue_capacity;
+        std::uint64_t id;
+
+        std::mutex queues_mutex;
+        std::vector<std::shared_ptr<log_queue>> queues;
+        std::atomic<bool> queues_changed {false};
+
+        std::atomic<std::uint64_t> flush_requested {0};
+        std::atomic<std::uint64_t> flush_done {0};
+
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+        // Set while the backend is blocked waiting for something to do
+        std::atomic<bool> backend_idle {false};
+
+        std::jthread backend;
+
+        void wake_backend() noexcept
+        {
+            if (backend_idle.load(std::memory_order_seq_cst)) [[unlikely]]
+            {
+                notify_backend();
+            }
+        }
+
+        void notify_backend() noexcept;
+        [[nodiscard]] bool pending(std::span<const std::shared_ptr<log_queue>> active, std::stop_token stop) const noexcept;
+
+        log_queue& local_queue();
+        void run(std::stop_token stop);
+        std::size_t drain(std::span<const std::shared_ptr<log_queue>> active);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,308 @@
+module lib2.memory;
+
+import std;
+
+import :arena;
+
+namespace lib2
+{
+    static std::byte* align_up(std::byte* const p, const std::size_t alignment) noexcept
+    {
+        const auto address {reinterpret_cast<std::uintptr_t>(p)};
+        return p + (((address + alignment - 1) & ~(alignment - 1)) - address);
+    }
+
+    void* monotonic_arena::do_allocate(const std::size_t bytes, const std::size_t alignment)
+    {
+        auto p {align_up(cur_, alignment)};
+        if (cur_ == nullptr || p > end_ || bytes > static_cast<std::size_t>(end_ - p))
+        {
+            add_block(bytes + alignment);
+            p = align_up(cur_, alignment);
+        }
+
+        cur_ = p + bytes;
+        return p;
+    }
+
+    void monotonic_arena::do_deallocate(void* const p, const std::size_t bytes, std::size_t) noexcept
+    {
+        if (static_cast<std::byte*>(p) + bytes == cur_)
+        {
+            cur_ = static_cast<std::byte*>(p);
+        }
+    }
+
+    void monotonic_arena::add_block(const std::size_t min_size)
+    {
+        const auto size {std::max(next_size_, min_size + sizeof(block_header))};
+        auto* const block {static_cast<block_header*>(upstream_->allocate(size, alignof(std::max_align_t)))};
+        block->next = blocks_;
+        block->size = size;
+        blocks_ = block;
+
+        cur_ = reinterpret_cast<std::byte*>(block) + sizeof(block_header);
+        end_ = reinterpret_cast<std::byte*>(block) + size;
+        next_size_ = size * 2;
+    }
+
+    void monotonic_arena::reset() noexcept
+    {
+        if (blocks_ == nullptr)
+        {
+            cur_ = buffer_.data();
+            return;
+        }
+
+        // Blocks grow, so the newest is the largest
+        auto* block {blocks_->next};
+        while (block != nullptr)
+        {
+            const auto next {block->next};
+            upstream_->deallocate(block, block->size, alignof(std::max_align_t));
+            block = next;
+        }
+        blocks_->next = nullptr;
+
+        cur_ = reinterpret_cast<std::byte*>(blocks_) + sizeof(block_header);
+        end_ = reinterpret_cast<std::byte*>(blocks_) + blocks_->size;
+    }
+
+    void monotonic_arena::release() noexcept
+    {
+        while (blocks_ != nullptr)
+        {
+            const auto next {blocks_->next};
+            upstream_->deallocate(blocks_, blocks_->size, alignof(std::max_align_t));
+            blocks_ = next;
+        }
+
+        cur_ = buffer_.data();
+        end_ = buffer_.data() + buffer_.size();
+        next_size_ = buffer_.empty() ? initial_size_ : initial_size_ * 2;
+    }
+
+    fixed_pool::fixed_pool(const std::size_t block_size, const std::size_t blocks_per_chunk, std::pmr::memory_resource* const upstream)
+        : upstream_{upstream}
+        , block_size_{std::max((block_size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1), sizeof(free_block))}
+        , blocks_per_chunk_{std::max(blocks_per_chunk, std::size_t{1})} {}
+
+    fixed_pool::~fixed_pool() noexcept
+    {
+        for (auto* const chunk : chunks_)
+        {
+            upstream_->deallocate(chunk, block_size_ * blocks_per_chunk_, alignof(std::max_align_t));
+        }
+    }
+
+    void* fixed_pool::do_allocate(const std::size_t bytes, const std::size_t alignment)
+    {
+        if (bytes > block_size_ || alignment > alignof(std::max_align_t))
+        {
+            return upstream_->allocate(bytes, alignment);
+        }
+
+        if (free_ == nullptr)
+        {
+            chunks_.reserve(chunks_.size() + 1);
+            auto* const chunk {static_cast<std::byte*>(upstream_->allocate(block_size_ * blocks_per_chunk_, alignof(std::max_align_t)))};
+            chunks_.push_back(chunk);
+
+            for (auto i {blocks_per_chunk_}; i-- > 0;)
+            {
+                free_ = ::new (chunk + i * block_size_) free_block{free_};
+            }
+        }
+
+        return std::exchange(free_, free_->next);
+    }
+
+    void fixed_pool::do_deallocate(void* const p, const std::size_t bytes, const std::size_t alignment) noexcept
+    {
+        if (bytes > block_size_ || alignment > alignof(std::max_align_t))
+        {
+            upstream_->deallocate(p, bytes, alignment);
+            return;
+        }
+
+        free_ = ::new (p) free_block{free_};
+    }
+
+    constexpr auto num_size_classes {static_cast<std::size_t>(std::bit_width(thread_caching_pool::max_block_size / thread_caching_pool::min_block_size))};
+
+    // Blocks a thread caches per class before spilling half of them to
+    // the shared list, and how many it takes from there at a time
+    constexpr std::size_t max_cached_blocks {64};
+    constexpr std::size_t refill_batch {max_cached_blocks / 2};
+
+    constexpr std::size_t chunk_size {64 * 1024};
+
+    struct pool_block
+    {
+        pool_block* next;
+    };
+
+    struct block_list
+    {
+        pool_block* head {nullptr};
+        std::size_t size {0};
+
+        void push(pool_block* const block) noexcept
+        {
+            block->next = head;
+            head = block;
+            ++size;
+        }
+
+        pool_block* pop() noexcept
+        {
+            --size;
+            return std::exchange(head, head->next);
+        }
+    };
+
+    static std::size_t size_class(const std::size_t bytes) noexcept
+    {
+        return static_cast<std::size_t>(std::bit_width((std::max(bytes, thread_caching_pool::min_block_size) - 1) / thread_caching_pool::min_block_size));
+    }
+
+    static std::size_t class_size(const std::size_t size_class) noexcept
+    {
+        return thread_caching_pool::min_block_size << size_class;
+    }
+
+    // The free lists shared between threads and the chunks they are carved
+    // from. Threads hold it by weak_ptr, and as it is made by make_shared
+    // that also keeps its address from being reused while a thread still
+    // caches blocks from it.
+    struct pool_central
+    {
+        explicit pool_central(std::pmr::memory_resource* const upstream) noexcept
+            : upstream{upstream} {}
+
+        ~pool_central() noexcept
+        {
+            for (auto* const chunk : chunks)
+            {
+                upstream->deallocate(chunk, chunk_size, alignof(std::max_align_t));
+            }
+        }
+
+        // Moves up to count blocks of size_class into list
+        void take(const std::size_t size_class, block_list& list, const std::size_t count)
+        {
+            std::scoped_lock lock {mutex};
+
+            auto& shared {free[size_class]};
+            if (shared.head == nullptr)
+            {
+                chunks.reserve(chunks.size() + 1);
+                auto* const chunk {static_cast<std::byte*>(upstream->allocate(chunk_size, alignof(std::max_align_t)))};
+                chunks.push_back(chunk);
+
+                const auto block_size {class_size(size_class)};
+                for (std::size_t offset {0}; offset + block_size <= chunk_size; offset += block_size)
+                {
+                    shared.push(::new (chunk + offset) pool_block{});
+                }
+            }
+
+            for (std::size_t i {0}; i < count && shared.head != nullptr; ++i)
+            {
+                list.push(shared.pop());
+            }
+        }
+
+        // Moves count blocks of list back to the shared list
+        void give(const std::size_t size_class, block_list& list, const std::size_t count) noexcept
+        {
+            std::scoped_lock lock {mutex};
+            for (std::size_t i {0}; i < count && list.head != nullptr; ++i)
+            {
+                free[size_class].push(list.pop());
+            }
+        }
+
+        std::pmr::memory_resource* upstream;
+        std::mutex mutex;
+        std::array<block_list, num_size_classes> free;
+        std::vector<void*> chunks;
+    };
+
+    // The calling thread's cached blocks. A thread caches for one pool at
+    // a time; using another pool hands the cache back to the previous one.
+    struct pool_thread_state
+    {
+        std::weak_ptr<pool_central> owner;
+        pool_central* owner_ptr {nullptr};
+        std::array<block_list, num_size_classes> cache;
+
+        ~pool_thread_state() noexcept
+        {
+            flush();
+        }
+
+        void flush() noexcept
+        {
+            // The blocks went with the pool if it no longer exists
+            if (const auto central {owner.lock()})
+            {
+                for (std::size_t i {0}; i < cache.size(); ++i)
+                {
+                    central->give(i, cache[i], cache[i].size);
+                }
+            }
+            cache = {};
+        }
+
+        std::array<block_list, num_size_classes>& get(const std::shared_ptr<pool_central>& central) noexcept
+        {
+            if (owner_ptr != central.get())
+            {
+                flush();
+                owner = central;
+                owner_ptr = central.get();
+            }
+            return cache;
+        }
+    };
+
+    thread_local pool_thread_state pool_state;
+
+    thread_caching_pool::thread_caching_pool(std::pmr::memory_resource* const upstream)
+        : upstream_{upstream}
+        , central_{std::make_shared<pool_central>(upstream)} {}
+
+    void* thread_caching_pool::do_allocate(const std::size_t bytes, const std::size_t alignment)
+    {
+        if (bytes > max_block_size || alignment > alignof(std::max_align_t))
+        {
+            return upstream_->allocate(bytes, alignment);
+        }
+
+        const auto index {size_class(bytes)};
+        auto& list {pool_state.get(central_)[index]};
+        if (list.head == nullptr)
+        {
+            central_->take(index, list, refill_batch);
+        }
+        return list.pop();
+    }
+
+    void thread_caching_pool::do_deallocate(void* const p, const std::size_t bytes, const std::size_t alignment) noexcept
+    {
+        if (bytes > max_block_size || alignment > alignof(std::max_align_t))
+        {
+            upstream_->deallocate(p, bytes, alignment);
+            return;
+        }
+
+        const auto index {size_class(bytes)};
+        auto& list {pool_state.get(central_)[index]};
+        list.push(::new (p) pool_block{});
+        if (list.size > max_cached_blocks)
+        {
+            central_->give(index, list, max_cached_blocks / 2);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+export module lib2.memory:arena;
+
+import std;
+
+namespace lib2
+{
+    // Hands out memory by bumping a pointer through blocks taken from
+    // upstream. Deallocation only gives back the most recent allocation, so
+    // a string growing at the end of the arena reuses its space. reset()
+    // frees everything at once and keeps the largest block for the next
+    // round, so an arena reset per request stops allocating once it has
+    // grown to the size of a request.
+    export
+    class monotonic_arena : public std::pmr::memory_resource
+    {
+    public:
+        explicit monotonic_arena(const std::size_t initial_size = 4096, std::pmr::memory_resource* const upstream = std::pmr::new_delete_resource()) noexcept
+            : upstream_{upstream}
+            , initial_size_{std::max(initial_size, std::size_t{64})}
+            , next_size_{initial_size_} {}
+
+        // Uses buffer before going upstream. buffer is not freed and must
+        // outlive the arena.
+        explicit monotonic_arena(const std::span<std::byte> buffer, std::pmr::memory_resource* const upstream = std::pmr::new_delete_resource()) noexcept
+            : upstream_{upstream}
+            , buffer_{buffer}
+            , cur_{buffer.data()}
+            , end_{buffer.data() + buffer.size()}
+            , initial_size_{std::max(buffer.size(), std::size_t{64})}
+            , next_size_{initial_size_ * 2} {}
+
+        monotonic_arena(const monotonic_arena&) = delete;
+        monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+        ~monotonic_arena() noexcept override
+        {
+            release();
+        }
+
+        // Frees every allocation, keeping the largest block
+        void reset() noexcept;
+
+        // Frees every allocation and returns all blocks upstream
+        void release() noexcept;
+
+        [[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept
+        {
+            return upstream_;
+        }
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept override;
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    private:
+        struct block_header
+        {
+            block_header* next;
+            std::size_t size;
+        };
+
+        std::pmr::memory_resource* upstream_;
+        std::span<std::byte> buffer_;
+        block_header* blocks_ {nullptr};
+        std::byte* cur_ {nullptr};
+        std::byte* end_ {nullptr};
+        std::size_t initial_size_;
+        std::size_t next_size_;
+
+        void add_block(std::size_t min_size);
+    };
+
+    // Allocations of up to block_size bytes come from a free list of
+    // equally sized blocks, carved out of chunks taken from upstream.
+    // Larger or over-aligned allocations go straight upstream. Not thread
+    // safe.
+    export
+    class fixed_pool : public std::pmr::memory_resource
+    {
+    public:
+        explicit fixed_pool(std::size_t block_size, std::size_t blocks_per_chunk = 64, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+        fixed_pool(const fixed_pool&) = delete;
+        fixed_pool& operator=(const fixed_pool&) = delete;
+
+        ~fixed_pool() noexcept override;
+
+        [[nodiscard]] std::size_t block_size() const noexcept
+        {
+            return block_size_;
+        }
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept override;
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    private:
+        struct free_block
+        {
+            free_block* next;
+        };
+
+        std::pmr::memory_resource* upstream_;
+        std::size_t block_size_;
+        std::size_t blocks_per_chunk_;
+        free_block* free_ {nullptr};
+        std::vector<void*> chunks_;
+    };
+
+    struct pool_central;
+
+    // Size-class pool where each thread keeps a small cache of free blocks
+    // per class, so allocating and freeing on one thread takes no lock.
+    // Caches spill to and refill from a shared free list in batches.
+    // Allocations over max_block_size or over-aligned go straight
+    // upstream, which must be thread safe.
+    export
+    class thread_caching_pool : public std::pmr::memory_resource
+    {
+    public:
+        static constexpr std::size_t min_block_size {16};
+        static constexpr std::size_t max_block_size {2048};
+
+        explicit thread_caching_pool(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+        thread_caching_pool(const thread_caching_pool&) = delete;
+        thread_caching_pool& operator=(const thread_caching_pool&) = delete;
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept override;
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    private:
+        std::pmr::memory_resource* upstream_;
+        std::shared_ptr<pool_central> central_;
+    };
+
+    // Allocator over a memory_resource, like std::pmr::polymorphic_allocator
+    // except that it follows the container on copy, move and swap. A copy
+    // of an arena-backed string stays in the arena rather than falling back
+    // to the default resource.
+    export
+    template<class T>
+    class arena_allocator
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap            = std::true_type;
+
+        arena_allocator() noexcept
+            : resource_{std::pmr::get_default_resource()} {}
+
+        arena_allocator(std::pmr::memory_resource* const resource) noexcept
+            : resource_{resource} {}
+
+        template<class U>
+        arena_allocator(const arena_allocator<U>& other) noexcept
+            : resource_{other.resource()} {}
+
+        [[nodiscard]] T* allocate(const std::size_t n)
+        {
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            {
+                throw std::bad_array_new_length{};
+            }
+            return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* const p, const std::size_t n) noexcept
+        {
+            resource_->deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        [[nodiscard]] arena_allocator select_on_container_copy_construction() const noexcept
+        {
+            return *this;
+        }
+
+        [[nodiscard]] std::pmr::memory_resource* resource() const noexcept
+        {
+            return resource_;
+        }
+    private:
+        std::pmr::memory_resource* resource_;
+    };
+
+    export
+    template<class T, class U>
+    [[nodiscard]] bool operator==(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) noexcept
+    {
+        return *lhs.resource() == *rhs.resource();
+    }
+
+    export
+    using arena_string = std::basic_string<char, std::char_traits<char>, arena_allocator<char>>;
+}
\ No newline at end of file
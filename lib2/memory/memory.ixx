@@ -1,3 +1,4 @@
 export module lib2.memory;
 export import :tagged_pointer;
-export import :locatable_object;
\ No newline at end of file
+export import :locatable_object;
+export import :arena;
\ No newline at end of file
@@ -162,4 +162,12 @@ namespace lib2
 	template<class T>
 		requires(std::is_arithmetic_v<T>)
 	using least_float_type = least_value_float<static_cast<long double>(std::numeric_limits<T>::max())>;
+
+	export
+	template<std::unsigned_integral T>
+	[[nodiscard]] constexpr int log2_floor(const T val) noexcept
+	{
+		// Zero is treated as one so the result is always a valid index
+		return static_cast<int>(bits_in_type<T>) - 1 - std::countl_zero(static_cast<T>(val | 1));
+	}
 }
\ No newline at end of file
@@ -0,0 +1,55 @@
+module;
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+export module lib2.platform:cpu_features;
+
+namespace lib2
+{
+	// Instruction set extensions usable on the running machine, for picking
+	// between kernels compiled for several targets
+	export
+	struct cpu_features
+	{
+		bool sse41 {false};
+		bool avx2 {false};
+		bool neon {false};
+	};
+
+	static cpu_features detect_cpu_features() noexcept
+	{
+		cpu_features features;
+	#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		__builtin_cpu_init();
+		features.sse41 = __builtin_cpu_supports("sse4.1");
+		features.avx2 = __builtin_cpu_supports("avx2");
+	#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		int regs[4];
+		__cpuid(regs, 0);
+		const int max_leaf {regs[0]};
+
+		__cpuid(regs, 1);
+		features.sse41 = (regs[2] & (1 << 19)) != 0;
+
+		// AVX2 also needs the OS to save the upper halves of the registers
+		const bool os_avx {(regs[2] & (1 << 27)) != 0 && (regs[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6};
+		if (os_avx && max_leaf >= 7)
+		{
+			__cpuidex(regs, 7, 0);
+			features.avx2 = (regs[1] & (1 << 5)) != 0;
+		}
+	#elif defined(__ARM_NEON) || defined(_M_ARM64)
+		features.neon = true;
+	#endif
+		return features;
+	}
+
+	export
+	[[nodiscard]] const cpu_features& host_cpu_features() noexcept
+	{
+		static const cpu_features features {detect_cpu_features()};
+		return features;
+	}
+}
\ No newline at end of file
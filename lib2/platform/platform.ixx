@@ -3,4 +3,6 @@ export module lib2.platform;
 export import :architecture;
 export import :operating_system;
 export import :compiler;
-export import :cpp_version;
\ No newline at end of file
+export import :cpp_version;
+export import :bits;
+export import :cpu_features;
\ No newline at end of file
@@ -0,0 +1,144 @@
+module;
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIB2_SCAN_SSE2
+#endif
+
+export module lib2.scan:ascii;
+
+import std;
+
+import lib2.strings;
+
+// Locale-free helpers for scanning contiguous char input
+namespace lib2
+{
+    // Skips ' ' and '\t' through '\r'. Single spaces are the common case
+    // so the first character is checked on its own before going wide.
+    [[nodiscard]] inline const char* skip_space_ascii(const char* it, const char* const end) noexcept
+    {
+        if (it == end || !isspace_ascii(*it))
+        {
+            return it;
+        }
+        ++it;
+
+#ifdef LIB2_SCAN_SSE2
+        const auto space {_mm_set1_epi8(' ')};
+        const auto tab {_mm_set1_epi8('\t')};
+        const auto ctrl_range {_mm_set1_epi8('\r' - '\t')};
+
+        while (end - it >= 16)
+        {
+            const auto chars {_mm_loadu_si128(reinterpret_cast<const __m128i*>(it))};
+
+            // c - '\t' <= '\r' - '\t' as unsigned bytes
+            const auto offset {_mm_sub_epi8(chars, tab)};
+            const auto is_ctrl {_mm_cmpeq_epi8(_mm_min_epu8(offset, ctrl_range), offset)};
+            const auto is_space {_mm_or_si128(is_ctrl, _mm_cmpeq_epi8(chars, space))};
+
+            const auto mask {static_cast<unsigned int>(_mm_movemask_epi8(is_space)) ^ 0xFFFFu};
+            if (mask)
+            {
+                return it + std::countr_zero(mask);
+            }
+            it += 16;
+        }
+#endif
+
+        while (it != end && isspace_ascii(*it))
+        {
+            ++it;
+        }
+        return it;
+    }
+
+    [[nodiscard]] inline std::uint64_t load_8_chars(const char* const p) noexcept
+    {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, p, sizeof(chunk));
+        if constexpr (std::endian::native == std::endian::big)
+        {
+            chunk = std::byteswap(chunk);
+        }
+        return chunk;
+    }
+
+    // Number of leading decimal digits in 8 characters loaded little endian
+    [[nodiscard]] inline int leading_digits_8(const std::uint64_t chunk) noexcept
+    {
+        // A byte is a digit when its high nibble is 3 and adding 6 does not
+        // carry into the high nibble
+        const auto high {chunk & 0xF0F0F0F0F0F0F0F0};
+        const auto carried {(chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0};
+        const auto non_digit {(high ^ 0x3030303030303030) | (carried ^ 0x3030303030303030)};
+        return std::countr_zero(non_digit) / 8;
+    }
+
+    // Value of 8 digits loaded little endian, with the first digit in the
+    // lowest byte
+    [[nodiscard]] inline std::uint32_t parse_8_digits(std::uint64_t chunk) noexcept
+    {
+        chunk -= 0x3030303030303030;
+        chunk = (chunk * 10) + (chunk >> 8);
+        chunk = (((chunk & 0x000000FF000000FF) * (100 + (1000000ull << 32))) +
+                 (((chunk >> 16) & 0x000000FF000000FF) * (1 + (10000ull << 32)))) >> 32;
+        return static_cast<std::uint32_t>(chunk);
+    }
+
+    struct parse_digits_result
+    {
+        const char* ptr;
+        bool overflow;
+    };
+
+    // Parses the digits at `it` into `value`, at most `limit`. Digits are
+    // always consumed, even when the value overflows, like std::from_chars.
+    // Up to 16 digits are read 8 at a time, the rest one by one.
+    [[nodiscard]] inline parse_digits_result parse_digits_ascii(const char* it, const char* const end, const std::uint64_t limit, std::uint64_t& value) noexcept
+    {
+        constexpr std::uint64_t pow10[] {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
+        while (it != end && *it == '0')
+        {
+            ++it;
+        }
+
+        value = 0;
+        for (int chunks {0}; chunks < 2 && end - it >= 8; ++chunks)
+        {
+            const auto chunk {load_8_chars(it)};
+            const auto count {leading_digits_8(chunk)};
+            if (count == 0)
+            {
+                break;
+            }
+
+            // Shifting the digits up leaves zero bytes in front, which parse
+            // as leading zeros once '0' has been added back
+            const auto shifted {count == 8 ? chunk : (chunk << (8 * (8 - count))) | (0x3030303030303030 >> (8 * count))};
+            value = value * pow10[count] + parse_8_digits(shifted);
+            it += count;
+            if (count != 8)
+            {
+                return {it, value > limit};
+            }
+        }
+
+        bool overflow {value > limit};
+        for (; it != end && isdigit_ascii(*it); ++it)
+        {
+            const auto digit {static_cast<std::uint64_t>(*it - '0')};
+            if (overflow || value > (limit - digit) / 10)
+            {
+                overflow = true;
+            }
+            else
+            {
+                value = value * 10 + digit;
+            }
+        }
+        return {it, overflow};
+    }
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+export module lib2.scan:basic_scan_arg;
+
+import std;
+
+import :scanner;
+import :scan_error;
+import :basic_scan_parse_context;
+
+namespace lib2
+{
+    export
+    template<class Context>
+    class basic_scan_arg
+    {
+    public:
+        constexpr basic_scan_arg() noexcept
+            : obj{nullptr}, func{nullptr} {}
+
+        template<class T>
+        explicit basic_scan_arg(T& obj) noexcept
+            : obj{std::addressof(obj)}
+            , func{[](basic_scan_parse_context<typename Context::char_type>& parse_ctx, Context& ctx, void* const obj) {
+                scanner<T, typename Context::char_type> s;
+                parse_ctx.advance_to(s.parse(parse_ctx));
+                return s.scan(*static_cast<T*>(obj), ctx);
+            }} {}
+
+        // Parses the scanner's specification from parse_ctx and scans into
+        // the argument, returning where the input was consumed up to
+        typename Context::iterator scan(basic_scan_parse_context<typename Context::char_type>& parse_ctx, Context& ctx) const
+        {
+            return func(parse_ctx, ctx, obj);
+        }
+    private:
+        void* obj;
+        typename Context::iterator(*func)(basic_scan_parse_context<typename Context::char_type>&, Context&, void*);
+    };
+
+    export
+    template<class Context, class... Args>
+    struct scan_arg_store
+    {
+        std::array<basic_scan_arg<Context>, sizeof...(Args)> args;
+    };
+
+    export
+    template<class Context>
+    class basic_scan_args
+    {
+    public:
+        template<class... Args>
+        constexpr basic_scan_args(const scan_arg_store<Context, Args...>& store) noexcept
+            : args_{store.args.data()}, num_args{store.args.size()} {}
+
+        [[nodiscard]] constexpr basic_scan_arg<Context> get(const std::size_t i) const
+        {
+            if (i >= num_args)
+            {
+                throw scan_parse_error{"Argument out of bounds"};
+            }
+
+            return args_[i];
+        }
+
+        [[nodiscard]] constexpr std::size_t size() const noexcept
+        {
+            return num_args;
+        }
+    private:
+        const basic_scan_arg<Context>* args_;
+        std::size_t num_args;
+    };
+
+    export
+    template<class Context, class... Args>
+    scan_arg_store<Context, Args...> make_scan_args(Args&... args) noexcept
+    {
+        return {{basic_scan_arg<Context>{args}...}};
+    }
+}
\ No newline at end of file
@@ -16,7 +16,7 @@ namespace lib2
         using iterator  = I;
         using sentinel  = S;
 
-        basic_scan_context(I begin_, S end_, basic_scan_args<basic_scan_context>& args, const std::locale l = {}) noexcept(std::is_nothrow_move_constructible_v<I> && std::is_nothrow_move_constructible_v<S>)
+        basic_scan_context(I begin_, S end_, basic_scan_args<basic_scan_context>& args, const std::locale* const l = nullptr) noexcept(std::is_nothrow_move_constructible_v<I> && std::is_nothrow_move_constructible_v<S>)
             : begin_{std::move(begin_)}, end_{std::move(end_)}, args_{std::addressof(args)}, locale_{l} {}
 
         basic_scan_context(const basic_scan_context&) = delete;
@@ -28,7 +28,18 @@ namespace lib2
 
         std::locale locale() const noexcept
         {
-            return locale_;
+            if (locale_)
+            {
+                return *locale_;
+            }
+
+            return {};
+        }
+
+        // Without a locale characters are classified as ASCII
+        [[nodiscard]] bool has_locale() const noexcept
+        {
+            return locale_ != nullptr;
         }
 
         I begin() const noexcept
@@ -49,6 +60,6 @@ namespace lib2
         I begin_;
         S end_;
         basic_scan_args<basic_scan_context>* args_;
-        std::locale locale_;
+        const std::locale* locale_;
     };
 }
\ No newline at end of file
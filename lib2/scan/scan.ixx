@@ -7,12 +7,84 @@ export import :basic_scan_context;
 
 import std;
 
+import lib2.strings;
+
+import :ascii;
+
 namespace lib2
 {
+    // Input that can be classified with the ASCII helpers a block at a time
+    template<class I, class S, class CharT>
+    concept contiguous_ascii_input = std::same_as<CharT, char> && std::contiguous_iterator<I> && std::sized_sentinel_for<S, I>;
+
+    // Without a facet, as when no locale was given, characters are
+    // classified as ASCII
+    template<class CharT>
+    [[nodiscard]] constexpr bool is_space(const std::ctype<CharT>* const facet, const CharT ch)
+    {
+        if (facet)
+        {
+            return facet->is(std::ctype_base::space, ch);
+        }
+
+        if constexpr (std::same_as<CharT, char>)
+        {
+            return isspace_ascii(ch);
+        }
+        else
+        {
+            return ch >= 0 && ch < 0x80 && isspace_ascii(static_cast<char>(ch));
+        }
+    }
+
+    template<class CharT, std::input_iterator I, std::sentinel_for<I> S>
+    [[nodiscard]] I skip_space(const std::ctype<CharT>* const facet, I it, const S end)
+    {
+        if constexpr (contiguous_ascii_input<I, S, CharT>)
+        {
+            if (!facet)
+            {
+                const auto first {std::to_address(it)};
+                return it + (skip_space_ascii(first, first + (end - it)) - first);
+            }
+        }
+
+        while (it != end && is_space(facet, *it))
+        {
+            ++it;
+        }
+        return it;
+    }
+
+    template<class CharT>
+    [[nodiscard]] const std::ctype<CharT>* scan_facet(const std::locale* const loc)
+    {
+        return loc ? std::addressof(std::use_facet<std::ctype<CharT>>(*loc)) : nullptr;
+    }
+
+    template<class ScanCtx>
+    [[nodiscard]] const std::ctype<typename ScanCtx::char_type>* scan_facet(const ScanCtx& ctx)
+    {
+        if (ctx.has_locale())
+        {
+            return std::addressof(std::use_facet<std::ctype<typename ScanCtx::char_type>>(ctx.locale()));
+        }
+        return nullptr;
+    }
+
+    // Kept out of line so building the message stays off the matching loop
+    template<class CharT>
+    [[noreturn]] void throw_pattern_not_matched(const CharT actual, const CharT expected)
+    {
+        throw scan_pattern_not_matched{std::format("Pattern not matched: '{}' != '{}'", actual, expected)};
+    }
+
+    // loc is null when no locale was given, in which case whitespace is
+    // ASCII and contiguous char input is skipped a block at a time
     template<std::input_iterator I, std::sentinel_for<I> S, class CharT, class... Args>
-    I do_scan(const std::locale& loc, I begin, const S end, const std::basic_string_view<CharT> fmt, Args&... args)
+    I do_scan(const std::locale* const loc, I begin, const S end, const std::basic_string_view<CharT> fmt, Args&... args)
     {
-        const auto& facet {std::use_facet<std::ctype<CharT>>(loc)};
+        const auto facet {scan_facet<CharT>(loc)};
 
         using ctx_t = basic_scan_context<I, S, CharT>;
 
@@ -26,20 +98,12 @@ namespace lib2
         {
             if (*fmt_it != '{')
             {
-                if (facet.is(std::ctype_base::space, *begin) && facet.is(std::ctype_base::space, *fmt_it))
+                if (is_space(facet, *begin) && is_space(facet, *fmt_it))
                 {
-                    ++begin;
-                    while (begin != end)
-                    {
-                        if (!facet.is(std::ctype_base::space, *begin))
-                        {
-                            break;
-                        }
-                        ++begin;
-                    }
+                    begin = skip_space(facet, std::move(begin), end);
                     while (fmt_it != fmt.end())
                     {
-                        if (!facet.is(std::ctype_base::space, *fmt_it))
+                        if (!is_space(facet, *fmt_it))
                         {
                             break;
                         }
@@ -50,7 +114,7 @@ namespace lib2
 
                 if (*begin != *fmt_it)
                 {
-                    throw scan_pattern_not_matched{std::format("Pattern not matched: '{}' != '{}'", *begin, *fmt_it)};
+                    throw_pattern_not_matched(static_cast<CharT>(*begin), *fmt_it);
                 }
 
                 ++begin;
@@ -63,7 +127,7 @@ namespace lib2
             {
                 if (*begin != '{')
                 {
-                    throw scan_pattern_not_matched{std::format("Pattern not matched: '{}' != '{{'", *begin)};
+                    throw_pattern_not_matched(static_cast<CharT>(*begin), CharT{'{'});
                 }
 
                 ++begin;
@@ -125,7 +189,7 @@ namespace lib2
 
             parse_ctx.advance_to(fmt_it);
 
-            basic_scan_context<I, S, CharT> ctx {begin, end, scan_args, loc};
+            ctx_t ctx {begin, end, scan_args, loc};
             auto arg {ctx.arg(arg_idx)};
             begin = arg.scan(parse_ctx, ctx);
             fmt_it = end_curly;
@@ -144,14 +208,14 @@ namespace lib2
     template<std::input_iterator I, std::sentinel_for<I> S, class... Args>
     auto scan(const std::locale& loc, I begin, S end, const std::string_view fmt, Args&... args)
     {
-        return do_scan(loc, std::move(begin), std::move(end), fmt, args...);
+        return do_scan(std::addressof(loc), std::move(begin), std::move(end), fmt, args...);
     }
 
     export
     template<std::input_iterator I, std::sentinel_for<I> S, class... Args>
     auto scan(const std::locale& loc, I begin, S end, const std::wstring_view fmt, Args&... args)
     {
-        return do_scan(loc, std::move(begin), std::move(end), fmt, args...);
+        return do_scan(std::addressof(loc), std::move(begin), std::move(end), fmt, args...);
     }
 
     export
@@ -172,14 +236,14 @@ namespace lib2
     template<std::input_iterator I, std::sentinel_for<I> S, class... Args>
     auto scan(I begin, S end, const std::string_view fmt, Args&... args)
     {
-        return scan({}, std::move(begin), std::move(end), fmt, args...);
+        return do_scan(nullptr, std::move(begin), std::move(end), fmt, args...);
     }
 
     export
     template<std::input_iterator I, std::sentinel_for<I> S, class... Args>
     auto scan(I begin, S end, const std::wstring_view fmt, Args&... args)
     {
-        return scan({}, std::move(begin), std::move(end), fmt, args...);
+        return do_scan(nullptr, std::move(begin), std::move(end), fmt, args...);
     }
 
     export
@@ -197,7 +261,7 @@ namespace lib2
     }
 
     template<class CharT>
-    struct base_parser
+    struct scan_base_parser
     {
     public:
         template<class ParseCtx>
@@ -209,24 +273,12 @@ namespace lib2
         template<class ScanCtx>
         auto skipws(ScanCtx& ctx) const
         {
-            const auto& facet {std::use_facet<std::ctype<CharT>>(ctx.locale())};
-
-            auto it {ctx.begin()};
-            while (it != ctx.end())
-            {
-                if (!facet.is(std::ctype_base::space, *it))
-                {
-                    break;
-                }
-                ++it;
-            }
-
-            return it;
+            return skip_space(scan_facet(ctx), ctx.begin(), ctx.end());
         }
     };
 
     template<class CharT>
-    struct locale_parser : base_parser<CharT>
+    struct scan_locale_parser : scan_base_parser<CharT>
     {
     public:
         template<class ParseCtx>
@@ -249,7 +301,7 @@ namespace lib2
     };
 
     template<class CharT>
-    struct width_parser : base_parser<CharT>
+    struct scan_width_parser : scan_base_parser<CharT>
     {
     public:
         template<class ParseCtx>
@@ -308,13 +360,13 @@ namespace lib2
     };
 
     template<class CharT>
-    struct string_parser : width_parser<CharT>
+    struct scan_string_parser : scan_width_parser<CharT>
     {
     public:
         template<class ParseCtx>
-        auto parse(ParseCtx& ctx)
+        constexpr auto parse(ParseCtx& ctx)
         {
-            auto it {width_parser<CharT>::parse(ctx)};
+            auto it {scan_width_parser<CharT>::parse(ctx)};
 
             if (it != ctx.end())
             {
@@ -338,7 +390,7 @@ namespace lib2
 
     export
     template<class CharT>
-    struct scanner<CharT, CharT> : base_parser<CharT>
+    struct scanner<CharT, CharT> : scan_base_parser<CharT>
     {
         template<class ScanCtx>
         auto scan(CharT& val, ScanCtx& ctx) const
@@ -355,14 +407,101 @@ namespace lib2
         }
     };
 
+    template<class CharT>
+    [[nodiscard]] constexpr bool is_digit(const CharT ch) noexcept
+    {
+        return ch >= CharT{'0'} && ch <= CharT{'9'};
+    }
+
+    template<std::input_iterator I, std::sentinel_for<I> S>
+    [[nodiscard]] I parse_digits(I it, const S end, const std::uint64_t limit, std::uint64_t& value, bool& overflow)
+    {
+        if constexpr (contiguous_ascii_input<I, S, std::iter_value_t<I>>)
+        {
+            const auto first {std::to_address(it)};
+            const auto result {parse_digits_ascii(first, first + (end - it), limit, value)};
+            overflow = result.overflow;
+            return it + (result.ptr - first);
+        }
+        else
+        {
+            value = 0;
+            overflow = false;
+            for (; it != end && is_digit(*it); ++it)
+            {
+                const auto digit {static_cast<std::uint64_t>(*it - '0')};
+                if (overflow || value > (limit - digit) / 10)
+                {
+                    overflow = true;
+                }
+                else
+                {
+                    value = value * 10 + digit;
+                }
+            }
+            return it;
+        }
+    }
+
+    export
+    template<std::integral T, class CharT>
+        requires(!character<T> && !std::same_as<T, bool>)
+    struct scanner<T, CharT> : scan_base_parser<CharT>
+    {
+        static_assert(sizeof(T) <= sizeof(std::uint64_t), "Integer type is too wide to scan");
+
+        template<class ScanCtx>
+        auto scan(T& val, ScanCtx& ctx) const
+        {
+            using U = std::make_unsigned_t<T>;
+
+            auto it {this->skipws(ctx)};
+            const auto end {ctx.end()};
+
+            bool neg {false};
+            if (it != end && (*it == '-' || *it == '+'))
+            {
+                neg = *it == '-';
+                ++it;
+            }
+
+            if (it == end || !is_digit(*it))
+            {
+                throw scan_pattern_not_matched{"Expected an integer"};
+            }
+
+            if constexpr (std::unsigned_integral<T>)
+            {
+                if (neg)
+                {
+                    throw scan_pattern_not_matched{"Expected an unsigned integer"};
+                }
+            }
+
+            const std::uint64_t limit {neg ? static_cast<std::uint64_t>(U(std::numeric_limits<T>::max()) + 1) : static_cast<std::uint64_t>(std::numeric_limits<T>::max())};
+
+            std::uint64_t value;
+            bool overflow;
+            it = parse_digits(std::move(it), end, limit, value, overflow);
+
+            if (overflow)
+            {
+                throw std::out_of_range{"Integer out of range"};
+            }
+
+            val = neg ? static_cast<T>(U(0) - static_cast<U>(value)) : static_cast<T>(value);
+            return it;
+        }
+    };
+
     export
     template<class CharT, std::size_t N>
-    struct scanner<CharT[N], CharT> : public string_parser<CharT>
+    struct scanner<CharT[N], CharT> : public scan_string_parser<CharT>
     {
         template<class ScanCtx>
         auto scan(CharT(&val)[N], ScanCtx& ctx) const
         {
-            const auto& facet {std::use_facet<std::ctype<CharT>>(ctx.locale())};
+            const auto facet {scan_facet(ctx)};
 
             auto it {ctx.begin()};
             if (this->skipws_)
@@ -375,7 +514,7 @@ namespace lib2
 
             while (it != ctx.end() && ptr != (val + N - 1) && (this->width == 0 || current_width < this->width))
             {
-                if (this->skipws_ && facet.is(std::ctype_base::space, *it))
+                if (this->skipws_ && is_space(facet, *it))
                 {
                     break;
                 }
@@ -394,12 +533,12 @@ namespace lib2
 
     export
     template<class CharT, class Traits, class Allocator>
-    struct scanner<std::basic_string<CharT, Traits, Allocator>, CharT> : public string_parser<CharT>
+    struct scanner<std::basic_string<CharT, Traits, Allocator>, CharT> : public scan_string_parser<CharT>
     {
         template<class ScanCtx>
         auto scan(std::basic_string<CharT, Traits, Allocator>& val, ScanCtx& ctx) const
         {
-            const auto& facet {std::use_facet<std::ctype<CharT>>(ctx.locale())};
+            const auto facet {scan_facet(ctx)};
             val.clear();
 
             auto it {ctx.begin()};
@@ -412,7 +551,7 @@ namespace lib2
 
             while (it != ctx.end() && (this->width == 0 || current_width < this->width))
             {
-                if (this->skipws_ && facet.is(std::ctype_base::space, *it))
+                if (this->skipws_ && is_space(facet, *it))
                 {
                     break;
                 }
@@ -428,14 +567,14 @@ namespace lib2
 
     export
     template<class CharT, class Traits>
-    struct scanner<std::basic_string_view<CharT, Traits>, CharT> : public string_parser<CharT>
+    struct scanner<std::basic_string_view<CharT, Traits>, CharT> : public scan_string_parser<CharT>
     {
         template<class ScanCtx>
         auto scan(std::basic_string_view<CharT, Traits>& val, ScanCtx& ctx) const
         {
             static_assert(std::contiguous_iterator<typename ScanCtx::iterator>, "Scan iterator must be contiguous to scan std::string_view");
 
-            const auto& facet {std::use_facet<std::ctype<CharT>>(ctx.locale())};
+            const auto facet {scan_facet(ctx)};
             val = {};
 
             auto it {ctx.begin()};
@@ -449,7 +588,7 @@ namespace lib2
 
             while (it != ctx.end() && (this->width == 0 || current_width < this->width))
             {
-                if (this->skipws_ && facet.is(std::ctype_base::space, *it))
+                if (this->skipws_ && is_space(facet, *it))
                 {
                     break;
                 }
@@ -463,4 +602,261 @@ namespace lib2
             return it;
         }
     };
+
+    // A step of a compiled scan pattern
+    struct scan_instruction
+    {
+        enum class kind : std::uint8_t
+        {
+            literal,
+            space,
+            arg
+        } type;
+
+        // The characters to match, or an argument's spec
+        std::size_t pos {0};
+        std::size_t size {0};
+
+        // An argument's id, and the index of its scanner among the
+        // pattern's arguments
+        std::size_t idx {0};
+        std::size_t scanner {0};
+    };
+
+    // Splits a scan pattern into literals, runs of space that match any
+    // run of space in the input, and arguments, as do_scan reads it.
+    // Space in the pattern is classified as ASCII.
+    template<class CharT, class Emit>
+    constexpr void compile_scan_pattern(const std::basic_string_view<CharT> fmt, const std::size_t num_args, Emit emit)
+    {
+        using enum scan_instruction::kind;
+
+        basic_scan_parse_context<CharT> parse_ctx {fmt};
+        std::size_t num_scanners {0};
+        std::size_t pos {0};
+
+        while (pos < fmt.size())
+        {
+            if (is_space<CharT>(nullptr, fmt[pos]))
+            {
+                const auto first {pos};
+                while (pos < fmt.size() && is_space<CharT>(nullptr, fmt[pos]))
+                {
+                    ++pos;
+                }
+                emit(scan_instruction{.type=space, .pos=first, .size=pos - first});
+                continue;
+            }
+
+            if (fmt[pos] != CharT{'{'})
+            {
+                const auto first {pos};
+                while (pos < fmt.size() && fmt[pos] != CharT{'{'} && !is_space<CharT>(nullptr, fmt[pos]))
+                {
+                    ++pos;
+                }
+                emit(scan_instruction{.type=literal, .pos=first, .size=pos - first});
+                continue;
+            }
+
+            ++pos;
+            if (pos == fmt.size())
+            {
+                throw scan_parse_error{"Unmatched '{' in format string"};
+            }
+
+            if (fmt[pos] == CharT{'{'})
+            {
+                emit(scan_instruction{.type=literal, .pos=pos, .size=1});
+                ++pos;
+                continue;
+            }
+
+            std::size_t arg_idx {0};
+            if (is_digit(fmt[pos]))
+            {
+                while (pos < fmt.size() && is_digit(fmt[pos]))
+                {
+                    arg_idx = arg_idx * 10 + static_cast<std::size_t>(fmt[pos] - CharT{'0'});
+                    ++pos;
+                }
+                parse_ctx.check_arg_id(arg_idx);
+            }
+            else
+            {
+                arg_idx = parse_ctx.next_arg_id();
+            }
+
+            if (arg_idx >= num_args)
+            {
+                throw scan_parse_error{"Argument out of bounds"};
+            }
+
+            if (pos < fmt.size() && fmt[pos] == CharT{':'})
+            {
+                ++pos;
+            }
+            else if (pos == fmt.size() || fmt[pos] != CharT{'}'})
+            {
+                throw scan_parse_error{"Invalid format string"};
+            }
+
+            const auto end_curly {fmt.find(CharT{'}'}, pos)};
+            if (end_curly == fmt.npos)
+            {
+                throw scan_parse_error{"Unmatched '{' in format string"};
+            }
+
+            emit(scan_instruction{.type=arg, .pos=pos, .size=end_curly - pos, .idx=arg_idx, .scanner=num_scanners++});
+            pos = end_curly + 1;
+        }
+    }
+
+    // A scan pattern compiled into its steps, with the scanner of every
+    // argument parsed from its spec. A bad pattern or spec does not
+    // compile, and scanning runs each step in turn with no arguments to
+    // look up or specs to parse.
+    template<basic_string_literal Fmt, class... Args>
+    class cp_scan_pattern
+    {
+        using char_type = typename decltype(Fmt)::value_type;
+        using enum scan_instruction::kind;
+
+        static constexpr std::basic_string_view<char_type> fmt {Fmt};
+
+        static constexpr std::size_t num_instructions {[] {
+            std::size_t count {0};
+            compile_scan_pattern(fmt, sizeof...(Args), [&](const scan_instruction&) { ++count; });
+            return count;
+        }()};
+
+        static constexpr auto instructions {[] {
+            std::array<scan_instruction, num_instructions> instructions {};
+            std::size_t i {0};
+            compile_scan_pattern(fmt, sizeof...(Args), [&](const scan_instruction& instr) { instructions[i++] = instr; });
+            return instructions;
+        }()};
+
+        static constexpr auto arg_instructions {[] {
+            std::array<scan_instruction, std::ranges::count(instructions, arg, &scan_instruction::type)> args {};
+            std::ranges::copy_if(instructions, args.begin(), [](const auto& instr) { return instr.type == arg; });
+            return args;
+        }()};
+
+        template<std::size_t J>
+        using arg_scanner = scanner<std::tuple_element_t<arg_instructions[J].idx, std::tuple<Args...>>, char_type>;
+
+        static constexpr auto scanners {[]<std::size_t... J>(std::index_sequence<J...>) {
+            const auto parse {[]<std::size_t K>(std::integral_constant<std::size_t, K>) {
+                constexpr auto instr {arg_instructions[K]};
+                arg_scanner<K> s {};
+                basic_scan_parse_context<char_type> parse_ctx {fmt.substr(instr.pos)};
+                if (s.parse(parse_ctx) != parse_ctx.begin() + instr.size)
+                {
+                    throw scan_parse_error{"Invalid scan spec"};
+                }
+                return s;
+            }};
+            return std::tuple<arg_scanner<J>...>{parse(std::integral_constant<std::size_t, J>{})...};
+        }(std::make_index_sequence<arg_instructions.size()>{})};
+
+        template<std::size_t I, class ScanCtx, class ArgTuple>
+        static void scan_step(const std::ctype<char_type>* const facet, const std::locale* const loc, typename ScanCtx::iterator& begin, const typename ScanCtx::sentinel& end, basic_scan_args<ScanCtx>& scan_args, const ArgTuple& args)
+        {
+            constexpr auto instr {instructions[I]};
+
+            if (begin == end)
+            {
+                throw scan_pattern_not_matched{"Unexpected end of file"};
+            }
+
+            if constexpr (instr.type == literal)
+            {
+                constexpr auto expected {fmt.substr(instr.pos, instr.size)};
+                if constexpr (std::contiguous_iterator<typename ScanCtx::iterator> && std::sized_sentinel_for<typename ScanCtx::sentinel, typename ScanCtx::iterator>)
+                {
+                    if (static_cast<std::size_t>(end - begin) >= expected.size() && std::ranges::equal(expected, std::span{std::to_address(begin), expected.size()}))
+                    {
+                        begin += expected.size();
+                        return;
+                    }
+                }
+
+                for (const auto ch : expected)
+                {
+                    if (begin == end)
+                    {
+                        throw scan_pattern_not_matched{"Unexpected end of file"};
+                    }
+
+                    if (*begin != ch)
+                    {
+                        throw_pattern_not_matched(static_cast<char_type>(*begin), ch);
+                    }
+                    ++begin;
+                }
+            }
+            else if constexpr (instr.type == space)
+            {
+                if (!is_space(facet, static_cast<char_type>(*begin)))
+                {
+                    throw_pattern_not_matched(static_cast<char_type>(*begin), fmt[instr.pos]);
+                }
+                begin = skip_space(facet, std::move(begin), end);
+            }
+            else
+            {
+                ScanCtx ctx {begin, end, scan_args, loc};
+                begin = std::get<instr.scanner>(scanners).scan(std::get<instr.idx>(args), ctx);
+            }
+        }
+    public:
+        template<std::input_iterator I, std::sentinel_for<I> S>
+        static I scan(const std::locale* const loc, I begin, const S end, Args&... args)
+        {
+            using ctx_t = basic_scan_context<I, S, char_type>;
+
+            const auto facet {scan_facet<char_type>(loc)};
+
+            // Scanners get a context like do_scan's, but have no other
+            // arguments to reach through it
+            scan_arg_store<ctx_t> arg_store {};
+            basic_scan_args<ctx_t> scan_args {arg_store};
+            const auto arg_refs {std::tie(args...)};
+
+            [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                (scan_step<Is, ctx_t>(facet, loc, begin, end, scan_args, arg_refs), ...);
+            }(std::make_index_sequence<num_instructions>{});
+
+            return begin;
+        }
+    };
+
+    export
+    template<basic_string_literal Fmt, std::input_iterator I, std::sentinel_for<I> S, class... Args>
+    auto scan(const std::locale& loc, I begin, S end, Args&... args)
+    {
+        return cp_scan_pattern<Fmt, Args...>::scan(std::addressof(loc), std::move(begin), std::move(end), args...);
+    }
+
+    export
+    template<basic_string_literal Fmt, std::ranges::input_range R, class... Args>
+    auto scan(const std::locale& loc, R&& r, Args&... args)
+    {
+        return scan<Fmt>(loc, std::ranges::begin(r), std::ranges::end(r), args...);
+    }
+
+    export
+    template<basic_string_literal Fmt, std::input_iterator I, std::sentinel_for<I> S, class... Args>
+    auto scan(I begin, S end, Args&... args)
+    {
+        return cp_scan_pattern<Fmt, Args...>::scan(nullptr, std::move(begin), std::move(end), args...);
+    }
+
+    export
+    template<basic_string_literal Fmt, std::ranges::input_range R, class... Args>
+    auto scan(R&& r, Args&... args)
+    {
+        return scan<Fmt>(std::ranges::begin(r), std::ranges::end(r), args...);
+    }
 }
\ No newline at end of file
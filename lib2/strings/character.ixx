@@ -62,9 +62,41 @@ namespace lib2
     export
     constexpr cstring_sentinel_t cstring_sentinel {};
 
+    export
     [[nodiscard]] constexpr bool is_ascii(const char c) noexcept
     {
-        return c <= 127;
+        return (static_cast<unsigned char>(c) & 0x80) == 0;
+    }
+
+    // Checks eight bytes at a time for a set high bit
+    export
+    [[nodiscard]] constexpr bool is_ascii(const std::string_view str) noexcept
+    {
+        std::size_t i {0};
+        if !consteval
+        {
+            std::uint64_t high_bits {0};
+            for (; i + 8 <= str.size(); i += 8)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, str.data() + i, sizeof(word));
+                high_bits |= word;
+            }
+
+            if ((high_bits & 0x8080808080808080) != 0)
+            {
+                return false;
+            }
+        }
+
+        for (; i < str.size(); ++i)
+        {
+            if (!is_ascii(str[i]))
+            {
+                return false;
+            }
+        }
+        return true;
     }
 
     export
@@ -0,0 +1,983 @@
+module;
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define LIB2_UNICODE_X86
+#if defined(__GNUC__) || defined(__clang__)
+#define LIB2_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define LIB2_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define LIB2_TARGET_SSE41
+#define LIB2_TARGET_AVX2
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define LIB2_UNICODE_NEON
+#endif
+
+module lib2.strings;
+
+import std;
+
+import lib2.platform;
+
+import :unicode;
+
+namespace lib2
+{
+    // Scalar decoding of one sequence, shared by every kernel for the
+    // bytes that are not ASCII. Returns the length consumed, or 0 when the
+    // sequence is invalid or truncated.
+    static std::size_t decode_utf8(const unsigned char* const p, const unsigned char* const end, char32_t& cp) noexcept
+    {
+        const auto b {p[0]};
+        if (b < 0x80)
+        {
+            cp = b;
+            return 1;
+        }
+
+        std::size_t n;
+        char32_t min;
+        if ((b & 0xE0) == 0xC0)
+        {
+            n = 2;
+            min = 0x80;
+            cp = b & 0x1F;
+        }
+        else if ((b & 0xF0) == 0xE0)
+        {
+            n = 3;
+            min = 0x800;
+            cp = b & 0x0F;
+        }
+        else if ((b & 0xF8) == 0xF0)
+        {
+            n = 4;
+            min = 0x10000;
+            cp = b & 0x07;
+        }
+        else
+        {
+            return 0;
+        }
+
+        if (static_cast<std::size_t>(end - p) < n)
+        {
+            return 0;
+        }
+
+        for (std::size_t i {1}; i < n; ++i)
+        {
+            if ((p[i] & 0xC0) != 0x80)
+            {
+                return 0;
+            }
+            cp = (cp << 6) | (p[i] & 0x3F);
+        }
+
+        if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+        {
+            return 0;
+        }
+        return n;
+    }
+
+    static bool validate_utf8_scalar(const unsigned char* p, const unsigned char* const end) noexcept
+    {
+        char32_t cp;
+        while (p != end)
+        {
+            const auto n {decode_utf8(p, end, cp)};
+            if (n == 0)
+            {
+                return false;
+            }
+            p += n;
+        }
+        return true;
+    }
+
+    static std::size_t count_codepoints_scalar(const unsigned char* p, const unsigned char* const end) noexcept
+    {
+        std::size_t count {0};
+        for (; p != end; ++p)
+        {
+            count += (*p & 0xC0) != 0x80;
+        }
+        return count;
+    }
+
+    static std::size_t ascii_prefix_scalar(const unsigned char* const begin, const unsigned char* const end) noexcept
+    {
+        auto p {begin};
+        while (p != end && *p < 0x80)
+        {
+            ++p;
+        }
+        return static_cast<std::size_t>(p - begin);
+    }
+
+    static bool is_surrogate(const char16_t unit) noexcept
+    {
+        return (unit & 0xF800) == 0xD800;
+    }
+
+    static std::size_t non_surrogate_prefix_scalar(const char16_t* const begin, const char16_t* const end) noexcept
+    {
+        auto p {begin};
+        while (p != end && !is_surrogate(*p))
+        {
+            ++p;
+        }
+        return static_cast<std::size_t>(p - begin);
+    }
+
+    // Decodes one code point at p, throwing on invalid input like the
+    // iterator versions do
+    static char16_t* transcode_utf8_to_utf16(const unsigned char*& p, const unsigned char* const end, char16_t* out)
+    {
+        char32_t cp;
+        const auto n {decode_utf8(p, end, cp)};
+        if (n == 0)
+        {
+            throw std::invalid_argument{"Invalid UTF-8"};
+        }
+        p += n;
+
+        if (cp <= 0xFFFF)
+        {
+            *out++ = static_cast<char16_t>(cp);
+        }
+        else
+        {
+            cp -= 0x10000;
+            *out++ = static_cast<char16_t>(0xD800 + (cp >> 10));
+            *out++ = static_cast<char16_t>(0xDC00 + (cp & 0x3FF));
+        }
+        return out;
+    }
+
+    static unsigned char* transcode_utf16_to_utf8(const char16_t*& p, const char16_t* const end, unsigned char* out)
+    {
+        char32_t cp {*p++};
+        if (cp >= 0xD800 && cp <= 0xDBFF)
+        {
+            if (p == end)
+            {
+                throw std::invalid_argument{"Unpaired high surrogate"};
+            }
+
+            const char32_t low {*p};
+            if (low < 0xDC00 || low > 0xDFFF)
+            {
+                throw std::invalid_argument{"Invalid surrogate pair"};
+            }
+            ++p;
+
+            cp = 0x10000 + (((cp - 0xD800) << 10) | (low - 0xDC00));
+        }
+        else if (cp >= 0xDC00 && cp <= 0xDFFF)
+        {
+            throw std::invalid_argument{"Unpaired low surrogate"};
+        }
+
+        if (cp <= 0x7F)
+        {
+            *out++ = static_cast<unsigned char>(cp);
+        }
+        else if (cp <= 0x7FF)
+        {
+            *out++ = static_cast<unsigned char>(0xC0 | (cp >> 6));
+            *out++ = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp <= 0xFFFF)
+        {
+            *out++ = static_cast<unsigned char>(0xE0 | (cp >> 12));
+            *out++ = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+            *out++ = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            *out++ = static_cast<unsigned char>(0xF0 | (cp >> 18));
+            *out++ = static_cast<unsigned char>(0x80 | ((cp >> 12) & 0x3F));
+            *out++ = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+            *out++ = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        }
+        return out;
+    }
+
+    [[maybe_unused]] static std::size_t utf8_to_utf16_scalar(const unsigned char* p, const unsigned char* const end, char16_t* const out)
+    {
+        auto o {out};
+        while (p != end)
+        {
+            o = transcode_utf8_to_utf16(p, end, o);
+        }
+        return static_cast<std::size_t>(o - out);
+    }
+
+    [[maybe_unused]] static std::size_t utf16_to_utf8_scalar(const char16_t* p, const char16_t* const end, unsigned char* const out)
+    {
+        auto o {out};
+        while (p != end)
+        {
+            o = transcode_utf16_to_utf8(p, end, o);
+        }
+        return static_cast<std::size_t>(o - out);
+    }
+
+    // Error classes of a byte pair, looked up by the high and low nibble of
+    // the first byte and the high nibble of the second. A pair is invalid
+    // when the three lookups share a bit. From Keiser and Lemire,
+    // "Validating UTF-8 In Less Than One Instruction Per Byte".
+    namespace utf8_lookup
+    {
+        constexpr std::uint8_t too_short      {1 << 0};
+        constexpr std::uint8_t too_long       {1 << 1};
+        constexpr std::uint8_t overlong_3     {1 << 2};
+        constexpr std::uint8_t too_large      {1 << 3};
+        constexpr std::uint8_t surrogate      {1 << 4};
+        constexpr std::uint8_t overlong_2     {1 << 5};
+        constexpr std::uint8_t too_large_1000 {1 << 6};
+        constexpr std::uint8_t overlong_4     {1 << 6};
+        constexpr std::uint8_t two_conts      {1 << 7};
+        constexpr std::uint8_t carry          {too_short | too_long | two_conts};
+
+        constexpr std::uint8_t byte_1_high[16] {
+            too_long, too_long, too_long, too_long,
+            too_long, too_long, too_long, too_long,
+            two_conts, two_conts, two_conts, two_conts,
+            too_short | overlong_2,
+            too_short,
+            too_short | overlong_3 | surrogate,
+            too_short | too_large | too_large_1000 | overlong_4
+        };
+
+        constexpr std::uint8_t byte_1_low[16] {
+            carry | overlong_3 | overlong_2 | overlong_4,
+            carry | overlong_2,
+            carry,
+            carry,
+            carry | too_large,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000 | surrogate,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000
+        };
+
+        constexpr std::uint8_t byte_2_high[16] {
+            too_short, too_short, too_short, too_short,
+            too_short, too_short, too_short, too_short,
+            too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+            too_long | overlong_2 | two_conts | overlong_3 | too_large,
+            too_long | overlong_2 | two_conts | surrogate | too_large,
+            too_long | overlong_2 | two_conts | surrogate | too_large,
+            too_short, too_short, too_short, too_short
+        };
+
+        // A block ending in these bytes continues into the next one
+        constexpr std::uint8_t incomplete_max[32] {
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+        };
+    }
+
+#ifdef LIB2_UNICODE_X86
+    LIB2_TARGET_SSE41
+    static bool validate_utf8_sse41(const unsigned char* p, const unsigned char* const end) noexcept
+    {
+        using namespace utf8_lookup;
+
+        const auto table_1_high {_mm_loadu_si128(reinterpret_cast<const __m128i*>(byte_1_high))};
+        const auto table_1_low {_mm_loadu_si128(reinterpret_cast<const __m128i*>(byte_1_low))};
+        const auto table_2_high {_mm_loadu_si128(reinterpret_cast<const __m128i*>(byte_2_high))};
+        const auto max {_mm_loadu_si128(reinterpret_cast<const __m128i*>(incomplete_max + 16))};
+        const auto low_nibble {_mm_set1_epi8(0x0F)};
+
+        auto error {_mm_setzero_si128()};
+        auto prev_input {_mm_setzero_si128()};
+        auto prev_incomplete {_mm_setzero_si128()};
+
+        // The tail is checked as a final block padded with ASCII, which
+        // also catches a sequence left incomplete by the last full block
+        alignas(16) unsigned char tail[16] {};
+        for (bool last {false}; !last;)
+        {
+            __m128i input;
+            if (end - p >= 16)
+            {
+                input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                p += 16;
+            }
+            else
+            {
+                std::copy(p, end, tail);
+                input = _mm_load_si128(reinterpret_cast<const __m128i*>(tail));
+                last = true;
+            }
+
+            if (_mm_movemask_epi8(input) == 0)
+            {
+                error = _mm_or_si128(error, prev_incomplete);
+                prev_incomplete = _mm_setzero_si128();
+            }
+            else
+            {
+                const auto prev1 {_mm_alignr_epi8(input, prev_input, 15)};
+                const auto b1h {_mm_shuffle_epi8(table_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble))};
+                const auto b1l {_mm_shuffle_epi8(table_1_low, _mm_and_si128(prev1, low_nibble))};
+                const auto b2h {_mm_shuffle_epi8(table_2_high, _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble))};
+                const auto special {_mm_and_si128(_mm_and_si128(b1h, b1l), b2h)};
+
+                const auto prev2 {_mm_alignr_epi8(input, prev_input, 14)};
+                const auto prev3 {_mm_alignr_epi8(input, prev_input, 13)};
+                const auto third {_mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)))};
+                const auto fourth {_mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)))};
+                const auto must_23 {_mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)))};
+
+                error = _mm_or_si128(error, _mm_xor_si128(must_23, special));
+                prev_incomplete = _mm_subs_epu8(input, max);
+            }
+            prev_input = input;
+        }
+
+        return _mm_testz_si128(error, error);
+    }
+
+    LIB2_TARGET_AVX2
+    static bool validate_utf8_avx2(const unsigned char* p, const unsigned char* const end) noexcept
+    {
+        using namespace utf8_lookup;
+
+        const auto table_1_high {_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(byte_1_high)))};
+        const auto table_1_low {_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(byte_1_low)))};
+        const auto table_2_high {_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(byte_2_high)))};
+        const auto max {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(incomplete_max))};
+        const auto low_nibble {_mm256_set1_epi8(0x0F)};
+
+        auto error {_mm256_setzero_si256()};
+        auto prev_input {_mm256_setzero_si256()};
+        auto prev_incomplete {_mm256_setzero_si256()};
+
+        alignas(32) unsigned char tail[32] {};
+        for (bool last {false}; !last;)
+        {
+            __m256i input;
+            if (end - p >= 32)
+            {
+                input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                p += 32;
+            }
+            else
+            {
+                std::copy(p, end, tail);
+                input = _mm256_load_si256(reinterpret_cast<const __m256i*>(tail));
+                last = true;
+            }
+
+            if (_mm256_movemask_epi8(input) == 0)
+            {
+                error = _mm256_or_si256(error, prev_incomplete);
+                prev_incomplete = _mm256_setzero_si256();
+            }
+            else
+            {
+                // The previous block's upper lane followed by this block's
+                // lower lane, for shifting bytes across the lane boundary
+                const auto carried {_mm256_permute2x128_si256(prev_input, input, 0x21)};
+                const auto prev1 {_mm256_alignr_epi8(input, carried, 15)};
+                const auto b1h {_mm256_shuffle_epi8(table_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble))};
+                const auto b1l {_mm256_shuffle_epi8(table_1_low, _mm256_and_si256(prev1, low_nibble))};
+                const auto b2h {_mm256_shuffle_epi8(table_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble))};
+                const auto special {_mm256_and_si256(_mm256_and_si256(b1h, b1l), b2h)};
+
+                const auto prev2 {_mm256_alignr_epi8(input, carried, 14)};
+                const auto prev3 {_mm256_alignr_epi8(input, carried, 13)};
+                const auto third {_mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)))};
+                const auto fourth {_mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)))};
+                const auto must_23 {_mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)))};
+
+                error = _mm256_or_si256(error, _mm256_xor_si256(must_23, special));
+                prev_incomplete = _mm256_subs_epu8(input, max);
+            }
+            prev_input = input;
+        }
+
+        return _mm256_testz_si256(error, error);
+    }
+
+    // Bytes other than continuation bytes (10xxxxxx), which as signed
+    // bytes are those greater than -65
+    static std::size_t count_codepoints_sse2(const unsigned char* p, const unsigned char* const end) noexcept
+    {
+        const auto threshold {_mm_set1_epi8(-65)};
+        std::size_t count {0};
+
+        while (end - p >= 16)
+        {
+            // 8-bit counters can take 255 blocks before they are summed
+            const auto blocks {std::min<std::ptrdiff_t>((end - p) / 16, 255)};
+            auto counters {_mm_setzero_si128()};
+            for (std::ptrdiff_t i {0}; i < blocks; ++i, p += 16)
+            {
+                const auto input {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))};
+                counters = _mm_sub_epi8(counters, _mm_cmpgt_epi8(input, threshold));
+            }
+
+            const auto sums {_mm_sad_epu8(counters, _mm_setzero_si128())};
+            count += static_cast<std::size_t>(_mm_cvtsi128_si64(sums)) + static_cast<std::size_t>(_mm_extract_epi16(sums, 4));
+        }
+
+        return count + count_codepoints_scalar(p, end);
+    }
+
+    LIB2_TARGET_AVX2
+    static std::size_t count_codepoints_avx2(const unsigned char* p, const unsigned char* const end) noexcept
+    {
+        const auto threshold {_mm256_set1_epi8(-65)};
+        std::size_t count {0};
+
+        while (end - p >= 32)
+        {
+            const auto blocks {std::min<std::ptrdiff_t>((end - p) / 32, 255)};
+            auto counters {_mm256_setzero_si256()};
+            for (std::ptrdiff_t i {0}; i < blocks; ++i, p += 32)
+            {
+                const auto input {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))};
+                counters = _mm256_sub_epi8(counters, _mm256_cmpgt_epi8(input, threshold));
+            }
+
+            const auto sums {_mm256_sad_epu8(counters, _mm256_setzero_si256())};
+            count += static_cast<std::size_t>(_mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) +
+                                              _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3));
+        }
+
+        return count + count_codepoints_scalar(p, end);
+    }
+
+    static std::size_t ascii_prefix_sse2(const unsigned char* const begin, const unsigned char* const end) noexcept
+    {
+        auto p {begin};
+        while (end - p >= 16)
+        {
+            const auto high_bits {_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)))};
+            if (high_bits != 0)
+            {
+                return static_cast<std::size_t>(p - begin) + std::countr_zero(static_cast<unsigned>(high_bits));
+            }
+            p += 16;
+        }
+        return static_cast<std::size_t>(p - begin) + ascii_prefix_scalar(p, end);
+    }
+
+    LIB2_TARGET_AVX2
+    static std::size_t ascii_prefix_avx2(const unsigned char* const begin, const unsigned char* const end) noexcept
+    {
+        auto p {begin};
+        while (end - p >= 32)
+        {
+            const auto high_bits {_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)))};
+            if (high_bits != 0)
+            {
+                return static_cast<std::size_t>(p - begin) + std::countr_zero(static_cast<unsigned>(high_bits));
+            }
+            p += 32;
+        }
+        return static_cast<std::size_t>(p - begin) + ascii_prefix_scalar(p, end);
+    }
+
+    // Units are surrogates when their top five bits are 11011. The byte
+    // mask has two bits per unit.
+    static std::size_t non_surrogate_prefix_sse2(const char16_t* const begin, const char16_t* const end) noexcept
+    {
+        const auto top_bits {_mm_set1_epi16(static_cast<short>(0xF800))};
+        const auto surrogate {_mm_set1_epi16(static_cast<short>(0xD800))};
+
+        auto p {begin};
+        while (end - p >= 8)
+        {
+            const auto input {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))};
+            const auto surrogates {_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(input, top_bits), surrogate))};
+            if (surrogates != 0)
+            {
+                return static_cast<std::size_t>(p - begin) + std::countr_zero(static_cast<unsigned>(surrogates)) / 2;
+            }
+            p += 8;
+        }
+        return static_cast<std::size_t>(p - begin) + non_surrogate_prefix_scalar(p, end);
+    }
+
+    LIB2_TARGET_AVX2
+    static std::size_t non_surrogate_prefix_avx2(const char16_t* const begin, const char16_t* const end) noexcept
+    {
+        const auto top_bits {_mm256_set1_epi16(static_cast<short>(0xF800))};
+        const auto surrogate {_mm256_set1_epi16(static_cast<short>(0xD800))};
+
+        auto p {begin};
+        while (end - p >= 16)
+        {
+            const auto input {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))};
+            const auto surrogates {_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(input, top_bits), surrogate))};
+            if (surrogates != 0)
+            {
+                return static_cast<std::size_t>(p - begin) + std::countr_zero(static_cast<unsigned>(surrogates)) / 2;
+            }
+            p += 16;
+        }
+        return static_cast<std::size_t>(p - begin) + non_surrogate_prefix_scalar(p, end);
+    }
+
+    // Blocks of ASCII are widened 16 bytes at a time. A block with other
+    // bytes is transcoded one code point at a time up to its end.
+    static std::size_t utf8_to_utf16_sse2(const unsigned char* p, const unsigned char* const end, char16_t* const out)
+    {
+        auto o {out};
+        const auto zero {_mm_setzero_si128()};
+
+        while (end - p >= 16)
+        {
+            const auto input {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))};
+            if (_mm_movemask_epi8(input) == 0)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(o), _mm_unpacklo_epi8(input, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 8), _mm_unpackhi_epi8(input, zero));
+                p += 16;
+                o += 16;
+            }
+            else
+            {
+                const auto block_end {p + 16};
+                while (p < block_end)
+                {
+                    o = transcode_utf8_to_utf16(p, end, o);
+                }
+            }
+        }
+
+        while (p != end)
+        {
+            o = transcode_utf8_to_utf16(p, end, o);
+        }
+        return static_cast<std::size_t>(o - out);
+    }
+
+    LIB2_TARGET_AVX2
+    static std::size_t utf8_to_utf16_avx2(const unsigned char* p, const unsigned char* const end, char16_t* const out)
+    {
+        auto o {out};
+
+        while (end - p >= 32)
+        {
+            const auto input {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))};
+            if (_mm256_movemask_epi8(input) == 0)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(o), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(input)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(input, 1)));
+                p += 32;
+                o += 32;
+            }
+            else
+            {
+                const auto block_end {p + 32};
+                while (p < block_end)
+                {
+                    o = transcode_utf8_to_utf16(p, end, o);
+                }
+            }
+        }
+
+        while (p != end)
+        {
+            o = transcode_utf8_to_utf16(p, end, o);
+        }
+        return static_cast<std::size_t>(o - out);
+    }
+
+    // Blocks of units below 0x80 are narrowed 8 at a time
+    static std::size_t utf16_to_utf8_sse2(const char16_t* p, const char16_t* const end, unsigned char* const out)
+    {
+        auto o {out};
+        const auto non_ascii {_mm_set1_epi16(static_cast<short>(0xFF80))};
+        const auto zero {_mm_setzero_si128()};
+
+        while (end - p >= 8)
+        {
+            const auto input {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))};
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(input, non_ascii), zero)) == 0xFFFF)
+            {
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(o), _mm_packus_epi16(input, input));
+                p += 8;
+                o += 8;
+            }
+            else
+            {
+                const auto block_end {p + 8};
+                while (p < block_end)
+                {
+                    o = transcode_utf16_to_utf8(p, end, o);
+                }
+            }
+        }
+
+        while (p != end)
+        {
+            o = transcode_utf16_to_utf8(p, end, o);
+        }
+        return static_cast<std::size_t>(o - out);
+    }
+
+    LIB2_TARGET_AVX2
+    static std::size_t utf16_to_utf8_avx2(const char16_t* p, const char16_t* const end, unsigned char* const out)
+    {
+        auto o {out};
+        const auto non_ascii {_mm256_set1_epi16(static_cast<short>(0xFF80))};
+
+        while (end - p >= 16)
+        {
+            const auto input {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))};
+            if (_mm256_testz_si256(input, non_ascii))
+            {
+                // packus works per lane, so the lanes are brought together
+                // before storing
+                const auto packed {_mm256_permute4x64_epi64(_mm256_packus_epi16(input, input), 0b1000)};
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(o), _mm256_castsi256_si128(packed));
+                p += 16;
+                o += 16;
+            }
+            else
+            {
+                const auto block_end {p + 16};
+                while (p < block_end)
+                {
+                    o = transcode_utf16_to_utf8(p, end, o);
+                }
+            }
+        }
+
+        while (p != end)
+        {
+            o = transcode_utf16_to_utf8(p, end, o);
+        }
+        return static_cast<std::size_t>(o - out);
+    }
+#endif
+
+#ifdef LIB2_UNICODE_NEON
+    static bool validate_utf8_neon(const unsigned char* p, const unsigned char* const end) noexcept
+    {
+        using namespace utf8_lookup;
+
+        const auto table_1_high {vld1q_u8(byte_1_high)};
+        const auto table_1_low {vld1q_u8(byte_1_low)};
+        const auto table_2_high {vld1q_u8(byte_2_high)};
+        const auto max {vld1q_u8(incomplete_max + 16)};
+        const auto low_nibble {vdupq_n_u8(0x0F)};
+
+        auto error {vdupq_n_u8(0)};
+        auto prev_input {vdupq_n_u8(0)};
+        auto prev_incomplete {vdupq_n_u8(0)};
+
+        unsigned char tail[16] {};
+        for (bool last {false}; !last;)
+        {
+            uint8x16_t input;
+            if (end - p >= 16)
+            {
+                input = vld1q_u8(p);
+                p += 16;
+            }
+            else
+            {
+                std::copy(p, end, tail);
+                input = vld1q_u8(tail);
+                last = true;
+            }
+
+            if (vmaxvq_u8(input) < 0x80)
+            {
+                error = vorrq_u8(error, prev_incomplete);
+                prev_incomplete = vdupq_n_u8(0);
+            }
+            else
+            {
+                const auto prev1 {vextq_u8(prev_input, input, 15)};
+                const auto b1h {vqtbl1q_u8(table_1_high, vshrq_n_u8(prev1, 4))};
+                const auto b1l {vqtbl1q_u8(table_1_low, vandq_u8(prev1, low_nibble))};
+                const auto b2h {vqtbl1q_u8(table_2_high, vshrq_n_u8(input, 4))};
+                const auto special {vandq_u8(vandq_u8(b1h, b1l), b2h)};
+
+                const auto prev2 {vextq_u8(prev_input, input, 14)};
+                const auto prev3 {vextq_u8(prev_input, input, 13)};
+                const auto third {vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80))};
+                const auto fourth {vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80))};
+                const auto must_23 {vandq_u8(vorrq_u8(third, fourth), vdupq_n_u8(0x80))};
+
+                error = vorrq_u8(error, veorq_u8(must_23, special));
+                prev_incomplete = vqsubq_u8(input, max);
+            }
+            prev_input = input;
+        }
+
+        return vmaxvq_u8(error) == 0;
+    }
+
+    static std::size_t count_codepoints_neon(const unsigned char* p, const unsigned char* const end) noexcept
+    {
+        const auto threshold {vdupq_n_s8(-65)};
+        std::size_t count {0};
+
+        while (end - p >= 16)
+        {
+            const auto blocks {std::min<std::ptrdiff_t>((end - p) / 16, 255)};
+            auto counters {vdupq_n_u8(0)};
+            for (std::ptrdiff_t i {0}; i < blocks; ++i, p += 16)
+            {
+                const auto input {vreinterpretq_s8_u8(vld1q_u8(p))};
+                counters = vsubq_u8(counters, vcgtq_s8(input, threshold));
+            }
+            count += vaddlvq_u8(counters);
+        }
+
+        return count + count_codepoints_scalar(p, end);
+    }
+
+    // NEON has no movemask, so whole blocks are skipped and the block
+    // that ends the run is finished by the scalar loop
+    static std::size_t ascii_prefix_neon(const unsigned char* const begin, const unsigned char* const end) noexcept
+    {
+        auto p {begin};
+        while (end - p >= 16 && vmaxvq_u8(vld1q_u8(p)) < 0x80)
+        {
+            p += 16;
+        }
+        return static_cast<std::size_t>(p - begin) + ascii_prefix_scalar(p, end);
+    }
+
+    static std::size_t non_surrogate_prefix_neon(const char16_t* const begin, const char16_t* const end) noexcept
+    {
+        const auto top_bits {vdupq_n_u16(0xF800)};
+        const auto surrogate {vdupq_n_u16(0xD800)};
+
+        auto p {begin};
+        while (end - p >= 8)
+        {
+            const auto input {vld1q_u16(reinterpret_cast<const std::uint16_t*>(p))};
+            if (vmaxvq_u16(vceqq_u16(vandq_u16(input, top_bits), surrogate)) != 0)
+            {
+                break;
+            }
+            p += 8;
+        }
+        return static_cast<std::size_t>(p - begin) + non_surrogate_prefix_scalar(p, end);
+    }
+
+    static std::size_t utf8_to_utf16_neon(const unsigned char* p, const unsigned char* const end, char16_t* const out)
+    {
+        auto o {out};
+
+        while (end - p >= 16)
+        {
+            const auto input {vld1q_u8(p)};
+            if (vmaxvq_u8(input) < 0x80)
+            {
+                vst1q_u16(reinterpret_cast<std::uint16_t*>(o), vmovl_u8(vget_low_u8(input)));
+                vst1q_u16(reinterpret_cast<std::uint16_t*>(o + 8), vmovl_u8(vget_high_u8(input)));
+                p += 16;
+                o += 16;
+            }
+            else
+            {
+                const auto block_end {p + 16};
+                while (p < block_end)
+                {
+                    o = transcode_utf8_to_utf16(p, end, o);
+                }
+            }
+        }
+
+        while (p != end)
+        {
+            o = transcode_utf8_to_utf16(p, end, o);
+        }
+        return static_cast<std::size_t>(o - out);
+    }
+
+    static std::size_t utf16_to_utf8_neon(const char16_t* p, const char16_t* const end, unsigned char* const out)
+    {
+        auto o {out};
+
+        while (end - p >= 8)
+        {
+            const auto input {vld1q_u16(reinterpret_cast<const std::uint16_t*>(p))};
+            if (vmaxvq_u16(input) < 0x80)
+            {
+                vst1_u8(o, vmovn_u16(input));
+                p += 8;
+                o += 8;
+            }
+            else
+            {
+                const auto block_end {p + 8};
+                while (p < block_end)
+                {
+                    o = transcode_utf16_to_utf8(p, end, o);
+                }
+            }
+        }
+
+        while (p != end)
+        {
+            o = transcode_utf16_to_utf8(p, end, o);
+        }
+        return static_cast<std::size_t>(o - out);
+    }
+#endif
+
+    using validate_utf8_fn = bool(*)(const unsigned char*, const unsigned char*) noexcept;
+    using count_codepoints_fn = std::size_t(*)(const unsigned char*, const unsigned char*) noexcept;
+    using ascii_prefix_fn = std::size_t(*)(const unsigned char*, const unsigned char*) noexcept;
+    using non_surrogate_prefix_fn = std::size_t(*)(const char16_t*, const char16_t*) noexcept;
+    using utf8_to_utf16_fn = std::size_t(*)(const unsigned char*, const unsigned char*, char16_t*);
+    using utf16_to_utf8_fn = std::size_t(*)(const char16_t*, const char16_t*, unsigned char*);
+
+    // The widest kernel the host runs, chosen on first use. x86-64 always
+    // has SSE2 so only validation, which shuffles, needs a check below AVX2.
+    static validate_utf8_fn select_validate_utf8() noexcept
+    {
+        [[maybe_unused]] const auto& features {host_cpu_features()};
+#if defined(LIB2_UNICODE_X86)
+        if (features.avx2)
+        {
+            return validate_utf8_avx2;
+        }
+        if (features.sse41)
+        {
+            return validate_utf8_sse41;
+        }
+#elif defined(LIB2_UNICODE_NEON)
+        return validate_utf8_neon;
+#endif
+        return validate_utf8_scalar;
+    }
+
+    static count_codepoints_fn select_count_codepoints() noexcept
+    {
+#if defined(LIB2_UNICODE_X86)
+        if (host_cpu_features().avx2)
+        {
+            return count_codepoints_avx2;
+        }
+        return count_codepoints_sse2;
+#elif defined(LIB2_UNICODE_NEON)
+        return count_codepoints_neon;
+#else
+        return count_codepoints_scalar;
+#endif
+    }
+
+    static ascii_prefix_fn select_ascii_prefix() noexcept
+    {
+#if defined(LIB2_UNICODE_X86)
+        if (host_cpu_features().avx2)
+        {
+            return ascii_prefix_avx2;
+        }
+        return ascii_prefix_sse2;
+#elif defined(LIB2_UNICODE_NEON)
+        return ascii_prefix_neon;
+#else
+        return ascii_prefix_scalar;
+#endif
+    }
+
+    static non_surrogate_prefix_fn select_non_surrogate_prefix() noexcept
+    {
+#if defined(LIB2_UNICODE_X86)
+        if (host_cpu_features().avx2)
+        {
+            return non_surrogate_prefix_avx2;
+        }
+        return non_surrogate_prefix_sse2;
+#elif defined(LIB2_UNICODE_NEON)
+        return non_surrogate_prefix_neon;
+#else
+        return non_surrogate_prefix_scalar;
+#endif
+    }
+
+    static utf8_to_utf16_fn select_utf8_to_utf16() noexcept
+    {
+#if defined(LIB2_UNICODE_X86)
+        if (host_cpu_features().avx2)
+        {
+            return utf8_to_utf16_avx2;
+        }
+        return utf8_to_utf16_sse2;
+#elif defined(LIB2_UNICODE_NEON)
+        return utf8_to_utf16_neon;
+#else
+        return utf8_to_utf16_scalar;
+#endif
+    }
+
+    static utf16_to_utf8_fn select_utf16_to_utf8() noexcept
+    {
+#if defined(LIB2_UNICODE_X86)
+        if (host_cpu_features().avx2)
+        {
+            return utf16_to_utf8_avx2;
+        }
+        return utf16_to_utf8_sse2;
+#elif defined(LIB2_UNICODE_NEON)
+        return utf16_to_utf8_neon;
+#else
+        return utf16_to_utf8_scalar;
+#endif
+    }
+
+    bool validate_utf8(const char* const begin, const char* const end) noexcept
+    {
+        static const auto validate {select_validate_utf8()};
+        return validate(reinterpret_cast<const unsigned char*>(begin), reinterpret_cast<const unsigned char*>(end));
+    }
+
+    std::size_t count_codepoints(const char* const begin, const char* const end) noexcept
+    {
+        static const auto count {select_count_codepoints()};
+        return count(reinterpret_cast<const unsigned char*>(begin), reinterpret_cast<const unsigned char*>(end));
+    }
+
+    std::size_t ascii_prefix_length(const char* const begin, const char* const end) noexcept
+    {
+        static const auto prefix {select_ascii_prefix()};
+        return prefix(reinterpret_cast<const unsigned char*>(begin), reinterpret_cast<const unsigned char*>(end));
+    }
+
+    std::size_t non_surrogate_prefix_length(const char16_t* const begin, const char16_t* const end) noexcept
+    {
+        static const auto prefix {select_non_surrogate_prefix()};
+        return prefix(begin, end);
+    }
+
+    std::ranges::in_out_result<const char*, char16_t*> utf8_to_utf16_contiguous(const char* const begin, const char* const end, char16_t* const out)
+    {
+        static const auto transcode {select_utf8_to_utf16()};
+        return {end, out + transcode(reinterpret_cast<const unsigned char*>(begin), reinterpret_cast<const unsigned char*>(end), out)};
+    }
+
+    std::ranges::in_out_result<const char16_t*, char*> utf16_to_utf8_contiguous(const char16_t* const begin, const char16_t* const end, char* const out)
+    {
+        static const auto transcode {select_utf16_to_utf8()};
+        return {end, out + transcode(begin, end, reinterpret_cast<unsigned char*>(out))};
+    }
+}
\ No newline at end of file
@@ -2,13 +2,36 @@ export module lib2.strings:unicode;
 
 import std;
 
+import :character;
+
 namespace lib2
 {
+    // Bulk routines for contiguous input, vectorized for the host CPU.
+    // count_codepoints counts the bytes that are not continuation bytes,
+    // which for valid input is the number of code points.
+    export
+    [[nodiscard]] bool validate_utf8(const char* begin, const char* end) noexcept;
+
+    export
+    [[nodiscard]] std::size_t count_codepoints(const char* begin, const char* end) noexcept;
+
+    // Lengths of the leading run of ASCII bytes, and of UTF-16 units that
+    // are not surrogates, each of which is a code point on its own. The
+    // codepoint views hand out such runs without decoding them.
+    [[nodiscard]] std::size_t ascii_prefix_length(const char* begin, const char* end) noexcept;
+    [[nodiscard]] std::size_t non_surrogate_prefix_length(const char16_t* begin, const char16_t* end) noexcept;
+
     export
     template<std::ranges::view V>
         requires(std::convertible_to<std::remove_cvref_t<std::ranges::range_reference_t<V>>, char8_t>)
     class utf8_codepoint_view : public std::ranges::view_interface<utf8_codepoint_view<V>>
     {
+        // Byte ranges that the bulk routines can read directly
+        static constexpr bool contiguous_bytes {
+            std::contiguous_iterator<std::ranges::iterator_t<V>> &&
+            std::sized_sentinel_for<std::ranges::sentinel_t<V>, std::ranges::iterator_t<V>> &&
+            sizeof(std::ranges::range_value_t<V>) == 1
+        };
     public:
         constexpr explicit utf8_codepoint_view(V base)
             : base_{std::move(base)} {}
@@ -17,6 +40,7 @@ namespace lib2
 
         class iterator
         {
+            friend class utf8_codepoint_view;
         public:
             using value_type        = std::uint32_t;
             using difference_type   = std::ptrdiff_t;
@@ -77,9 +101,19 @@ namespace lib2
             bool done {false};
             bool invalid_ {false};
 
+            // Bytes ahead already known to be ASCII
+            std::ptrdiff_t ascii_run {0};
+
             constexpr void advance()
             {
                 invalid_ = false;
+                if (ascii_run != 0)
+                {
+                    --ascii_run;
+                    codepoint = static_cast<char8_t>(*it_++);
+                    return;
+                }
+
                 if (it_ == end_)
                 {
                     done = true;
@@ -91,6 +125,20 @@ namespace lib2
                 if ((b & 0x80) == 0)
                 {
                     codepoint = b;
+
+                    // When ASCII follows ASCII the whole run is measured at
+                    // once, so that its bytes skip decoding
+                    if constexpr (contiguous_bytes)
+                    {
+                        if !consteval
+                        {
+                            if (it_ != end_ && (static_cast<char8_t>(*it_) & 0x80) == 0)
+                            {
+                                const auto first {reinterpret_cast<const char*>(std::to_address(it_))};
+                                ascii_run = static_cast<std::ptrdiff_t>(ascii_prefix_length(first, first + (end_ - it_)));
+                            }
+                        }
+                    }
                     return;
                 }
 
@@ -160,8 +208,45 @@ namespace lib2
         {
             return {};
         }
+
+        // Counted in bulk when the input is valid. count_codepoints does not
+        // count invalid input the way the iterator decodes it, so that is
+        // counted by iterating, a run of ASCII at a time. The count is kept,
+        // so only the first call reads the input.
+        [[nodiscard]] constexpr std::size_t size()
+            requires(contiguous_bytes)
+        {
+            if (!size_)
+            {
+                size_ = count();
+            }
+            return *size_;
+        }
     private:
         V base_;
+        std::optional<std::size_t> size_;
+
+        constexpr std::size_t count() const
+        {
+            if !consteval
+            {
+                const auto first {reinterpret_cast<const char*>(std::to_address(std::ranges::begin(base_)))};
+                const auto last {first + (std::ranges::end(base_) - std::ranges::begin(base_))};
+                if (validate_utf8(first, last))
+                {
+                    return count_codepoints(first, last);
+                }
+            }
+
+            std::size_t total {0};
+            for (auto it {begin()}; it != end(); ++it)
+            {
+                total += 1 + static_cast<std::size_t>(it.ascii_run);
+                it.it_ += it.ascii_run;
+                it.ascii_run = 0;
+            }
+            return total;
+        }
     };
 
     export
@@ -170,6 +255,11 @@ namespace lib2
                 (std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<V>>, wchar_t> && sizeof(wchar_t) == 2))
     class utf16_codepoint_view : public std::ranges::view_interface<utf16_codepoint_view<V>>
     {
+        // Unit ranges that non_surrogate_prefix_length can read directly
+        static constexpr bool contiguous_units {
+            std::contiguous_iterator<std::ranges::iterator_t<V>> &&
+            std::sized_sentinel_for<std::ranges::sentinel_t<V>, std::ranges::iterator_t<V>>
+        };
     public:
         constexpr explicit utf16_codepoint_view(V base)
             : base_{std::move(base)} {}
@@ -227,9 +317,19 @@ namespace lib2
             bool done{false};
             bool invalid_{false};
 
+            // Units ahead already known not to be surrogates
+            std::ptrdiff_t bmp_run{0};
+
             constexpr void advance()
             {
                 invalid_ = false;
+                if (bmp_run != 0)
+                {
+                    --bmp_run;
+                    codepoint = static_cast<char16_t>(*it_++);
+                    return;
+                }
+
                 if (it_ == end_)
                 {
                     done = true;
@@ -238,10 +338,22 @@ namespace lib2
 
                 const char16_t lead {static_cast<char16_t>(*it_++)};
 
-                // Single-unit BMP code point (not surrogate)
+                // Single-unit BMP code point (not surrogate). When another
+                // follows, the whole run is measured at once.
                 if (lead < 0xD800 || lead > 0xDFFF)
                 {
                     codepoint = lead;
+                    if constexpr (contiguous_units)
+                    {
+                        if !consteval
+                        {
+                            if (it_ != end_ && (static_cast<char16_t>(*it_) & 0xF800) != 0xD800)
+                            {
+                                const auto first {reinterpret_cast<const char16_t*>(std::to_address(it_))};
+                                bmp_run = static_cast<std::ptrdiff_t>(non_surrogate_prefix_length(first, first + (end_ - it_)));
+                            }
+                        }
+                    }
                     return;
                 }
 
@@ -414,10 +526,46 @@ namespace lib2
         }
     }
 
+    // Range overloads of the bulk routines
+    export
+    template<std::ranges::contiguous_range R>
+        requires(std::ranges::sized_range<R> && sizeof(std::ranges::range_value_t<R>) == 1)
+    [[nodiscard]] bool validate_utf8(const R& r) noexcept
+    {
+        const auto data {reinterpret_cast<const char*>(std::ranges::data(r))};
+        return validate_utf8(data, data + std::ranges::size(r));
+    }
+
+    export
+    template<std::ranges::contiguous_range R>
+        requires(std::ranges::sized_range<R> && sizeof(std::ranges::range_value_t<R>) == 1)
+    [[nodiscard]] std::size_t count_codepoints(const R& r) noexcept
+    {
+        const auto data {reinterpret_cast<const char*>(std::ranges::data(r))};
+        return count_codepoints(data, data + std::ranges::size(r));
+    }
+
+    // Used by utf8_to_utf16 and utf16_to_utf8 when both sides are contiguous
+    std::ranges::in_out_result<const char*, char16_t*> utf8_to_utf16_contiguous(const char* begin, const char* end, char16_t* out);
+    std::ranges::in_out_result<const char16_t*, char*> utf16_to_utf8_contiguous(const char16_t* begin, const char16_t* end, char* out);
+
     export
     template<std::input_iterator I, std::sentinel_for<I> S, std::output_iterator<char> O>
     constexpr std::ranges::in_out_result<I, O> utf16_to_utf8(I begin, const S end, O out)
     {
+        if constexpr (std::contiguous_iterator<I> && std::sized_sentinel_for<S, I> &&
+                      std::same_as<std::iter_value_t<I>, char16_t> &&
+                      std::is_pointer_v<O> && sizeof(std::remove_pointer_t<O>) == 1)
+        {
+            if !consteval
+            {
+                const auto first {std::to_address(begin)};
+                const auto dest {reinterpret_cast<char*>(out)};
+                const auto result {utf16_to_utf8_contiguous(first, first + (end - begin), dest)};
+                return {begin + (result.in - first), out + (result.out - dest)};
+            }
+        }
+
         while (begin != end)
         {
             char32_t cp = *begin;
@@ -451,7 +599,7 @@ namespace lib2
                 *out++ = static_cast<char>(0xC0 | (cp >> 6));
                 *out++ = static_cast<char>(0x80 | (cp & 0x3F));
             }
-            else if (cp <= 0xFFF)
+            else if (cp <= 0xFFFF)
             {
                 *out++ = static_cast<char>(0xE0 | (cp >> 12));
                 *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
@@ -482,6 +630,17 @@ namespace lib2
     template<std::input_iterator I, std::sentinel_for<I> S, std::output_iterator<char16_t> O>
     constexpr std::ranges::in_out_result<I, O> utf8_to_utf16(I begin, const S end, O out)
     {
+        if constexpr (std::contiguous_iterator<I> && std::sized_sentinel_for<S, I> &&
+                      sizeof(std::iter_value_t<I>) == 1 && std::same_as<O, char16_t*>)
+        {
+            if !consteval
+            {
+                const auto first {reinterpret_cast<const char*>(std::to_address(begin))};
+                const auto result {utf8_to_utf16_contiguous(first, first + (end - begin), out)};
+                return {begin + (result.in - first), result.out};
+            }
+        }
+
         while (begin != end)
         {
             char8_t c = *begin;
@@ -605,7 +764,7 @@ namespace lib2
             {
                 cp -= 0x10000;
                 *out++ = static_cast<char16_t>(0xD800 + (cp >> 10));
-                *out++ = static_cast<char16_t>(0xD00 + (cp & 0x3FF));
+                *out++ = static_cast<char16_t>(0xDC00 + (cp & 0x3FF));
             }
         }
 
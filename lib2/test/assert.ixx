@@ -8,6 +8,7 @@ import lib2.io;
 import lib2.fmt;
 
 import :assert_exception;
+import :test_result;
 
 namespace lib2::test
 {
@@ -119,10 +120,22 @@ namespace lib2::test
 		}
 	}
 
+	// Throws, unless the running test records its failures
+	static inline void assertion_failed(std::string message, const std::source_location& location)
+	{
+		if (recording_result != nullptr)
+		{
+			recording_result->record({std::move(message), location});
+			return;
+		}
+
+		throw assert_exception{std::move(message)};
+	}
+
 	export
 	void fail(const std::string_view message = {}, const std::source_location& location = std::source_location::current())
 	{
-		throw assert_exception{lib2::format<"({}:{}) failure: {}">(location.file_name(), location.line(), message)};
+		assertion_failed(lib2::format<"({}:{}) failure: {}">(location.file_name(), location.line(), message), location);
 	}
 
 	export
@@ -140,7 +153,7 @@ namespace lib2::test
 	{
 		if(!(actual == expected))
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected))};
+			assertion_failed(lib2::format<"({}:{}) assert_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected)), location);
 		}
 	}
 
@@ -153,7 +166,7 @@ namespace lib2::test
 	{
 		if (!(actual != expected))
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_not_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected))};
+			assertion_failed(lib2::format<"({}:{}) assert_not_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected)), location);
 		}
 	}
 
@@ -163,7 +176,7 @@ namespace lib2::test
 	{
 		if (std::basic_string_view{actual} != std::basic_string_view{expected})
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_cstrings_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected))};
+			assertion_failed(lib2::format<"({}:{}) assert_cstrings_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected)), location);
 		}
 	}
 	
@@ -173,7 +186,7 @@ namespace lib2::test
 	{
 		if (std::basic_string_view{actual} == std::basic_string_view{expected})
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_cstrings_not_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected))};
+			assertion_failed(lib2::format<"({}:{}) assert_cstrings_not_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected)), location);
 		}
 	}
 
@@ -184,7 +197,7 @@ namespace lib2::test
 	{
 		if (!actual)
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_true failed: {}">(location.file_name(), location.line(), message)};
+			assertion_failed(lib2::format<"({}:{}) assert_true failed: {}">(location.file_name(), location.line(), message), location);
 		}
 	}
 
@@ -195,7 +208,7 @@ namespace lib2::test
 	{
 		if (actual)
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_false failed: {}">(location.file_name(), location.line(), message)};
+			assertion_failed(lib2::format<"({}:{}) assert_false failed: {}">(location.file_name(), location.line(), message), location);
 		}
 	}
 
@@ -205,7 +218,7 @@ namespace lib2::test
 	{
 		if (std::addressof(actual) != std::addressof(expected))
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_is failed: {}\n{}">(location.file_name(), location.line(), message, output(std::addressof(actual), std::addressof(expected)))};
+			assertion_failed(lib2::format<"({}:{}) assert_is failed: {}\n{}">(location.file_name(), location.line(), message, output(std::addressof(actual), std::addressof(expected))), location);
 		}
 	}
 
@@ -216,7 +229,7 @@ namespace lib2::test
 	{
 		if (std::addressof(actual) == std::addressof(expected))
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_is_not failed: {}\n{}">(location.file_name(), location.line(), message, output(std::addressof(actual), std::addressof(expected)))};
+			assertion_failed(lib2::format<"({}:{}) assert_is_not failed: {}\n{}">(location.file_name(), location.line(), message, output(std::addressof(actual), std::addressof(expected))), location);
 		}
 	}
 
@@ -226,7 +239,7 @@ namespace lib2::test
 	{
 		if constexpr (!std::same_as<Actual, Expected>)
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_is_type failed: {}\n{}">(location.file_name(), location.line(), message, output(typeid(Actual).name(), typeid(Expected).name()))};
+			assertion_failed(lib2::format<"({}:{}) assert_is_type failed: {}\n{}">(location.file_name(), location.line(), message, output(typeid(Actual).name(), typeid(Expected).name())), location);
 		}
 	}
 
@@ -236,7 +249,7 @@ namespace lib2::test
 	{
 		if constexpr (std::same_as<Actual, Expected>)
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_is_not_type failed: {}\n{}">(location.file_name(), location.line(), message, output(typeid(Actual).name(), typeid(Expected).name()))};
+			assertion_failed(lib2::format<"({}:{}) assert_is_not_type failed: {}\n{}">(location.file_name(), location.line(), message, output(typeid(Actual).name(), typeid(Expected).name())), location);
 		}
 	}
 
@@ -246,7 +259,7 @@ namespace lib2::test
 	{
 		if constexpr (!lib2::specialization_of<Actual, Expected>)
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_is_specialization_of failed: {}\n{}">(location.file_name(), location.line(), message, output(typeid(Actual).name(), typeid(Expected).name()))};
+			assertion_failed(lib2::format<"({}:{}) assert_is_specialization_of failed: {}\n{}">(location.file_name(), location.line(), message, output(typeid(Actual).name(), typeid(Expected).name())), location);
 		}
 	}
 
@@ -256,7 +269,7 @@ namespace lib2::test
 	{
 		if constexpr (lib2::specialization_of<Actual, Expected>)
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_is_not_specialization_of failed: {}\n{}">(location.file_name(), location.line(), message, output(typeid(Actual).name(), typeid(Expected).name()))};
+			assertion_failed(lib2::format<"({}:{}) assert_is_not_specialization_of failed: {}\n{}">(location.file_name(), location.line(), message, output(typeid(Actual).name(), typeid(Expected).name())), location);
 		}
 	}
 
@@ -267,7 +280,7 @@ namespace lib2::test
 		const auto casted {dynamic_cast<const Expected*>(std::addressof(actual))};
 		if (casted == nullptr)
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_is_instance failed: {}\n{}">(location.file_name(), location.line(), message, output(typeid(Actual).name(), typeid(Expected).name()))};
+			assertion_failed(lib2::format<"({}:{}) assert_is_instance failed: {}\n{}">(location.file_name(), location.line(), message, output(typeid(Actual).name(), typeid(Expected).name())), location);
 		}
 	}
 
@@ -278,7 +291,7 @@ namespace lib2::test
 		const auto casted = dynamic_cast<const Expected*>(std::addressof(actual));
 		if (casted != nullptr)
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_is_not_instance failed: {}\n{}">(location.file_name(), location.line(), message, output(typeid(Actual).name(), typeid(Expected).name()))};
+			assertion_failed(lib2::format<"({}:{}) assert_is_not_instance failed: {}\n{}">(location.file_name(), location.line(), message, output(typeid(Actual).name(), typeid(Expected).name())), location);
 		}
 	}
 
@@ -288,7 +301,7 @@ namespace lib2::test
 	{
 		if (std::ranges::find(r, member) == std::ranges::end(r))
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_in failed: {}\n">(location.file_name(), location.line(), message)};
+			assertion_failed(lib2::format<"({}:{}) assert_in failed: {}\n">(location.file_name(), location.line(), message), location);
 		}
 	}
 
@@ -298,7 +311,7 @@ namespace lib2::test
 	{
 		if (std::ranges::find(r, member) != std::end(r))
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_not_in failed: {}\n">(location.file_name(), location.line(), message)};
+			assertion_failed(lib2::format<"({}:{}) assert_not_in failed: {}\n">(location.file_name(), location.line(), message), location);
 		}
 	}
 
@@ -317,7 +330,7 @@ namespace lib2::test
 			return;
 		}
 
-		throw assert_exception{lib2::format<"({}:{}) assert_throws failed: {}\nExpected {} to be thrown, but didn't">(location.file_name(), location.line(), message, typeid(T).name())};
+		assertion_failed(lib2::format<"({}:{}) assert_throws failed: {}\nExpected {} to be thrown, but didn't">(location.file_name(), location.line(), message, typeid(T).name()), location);
 	}
 
 	export
@@ -335,7 +348,7 @@ namespace lib2::test
 		const auto difference {std::abs(actual - expected)};
 		if (difference > delta)
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_almost_equal failed: {}\n{}Difference: {}\n">(location.file_name(), location.line(), message, output(actual, expected), difference)};
+			assertion_failed(lib2::format<"({}:{}) assert_almost_equal failed: {}\n{}Difference: {}\n">(location.file_name(), location.line(), message, output(actual, expected), difference), location);
 		}
 	}
 
@@ -346,7 +359,7 @@ namespace lib2::test
 		const auto difference {std::abs(actual - expected)};
 		if (difference <= delta)
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_not_almost_equal failed: {}\n{}Difference: {}\n">(location.file_name(), location.line(), message, output(actual, expected), difference)};
+			assertion_failed(lib2::format<"({}:{}) assert_not_almost_equal failed: {}\n{}Difference: {}\n">(location.file_name(), location.line(), message, output(actual, expected), difference), location);
 		}
 	}
 
@@ -356,7 +369,7 @@ namespace lib2::test
 	{
 		if (!(actual > expected))
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_greater failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected))};
+			assertion_failed(lib2::format<"({}:{}) assert_greater failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected)), location);
 		}
 	}
 
@@ -366,7 +379,7 @@ namespace lib2::test
 	{
 		if (!(actual >= expected))
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_greater_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected))};
+			assertion_failed(lib2::format<"({}:{}) assert_greater_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected)), location);
 		}
 	}
 
@@ -376,7 +389,7 @@ namespace lib2::test
 	{
 		if (!(actual < expected))
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_less failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected))};
+			assertion_failed(lib2::format<"({}:{}) assert_less failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected)), location);
 		}
 	}
 
@@ -386,7 +399,7 @@ namespace lib2::test
 	{
 		if (!(actual <= expected))
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_less_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected))};
+			assertion_failed(lib2::format<"({}:{}) assert_less_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, expected)), location);
 		}
 	}
 
@@ -404,7 +417,7 @@ namespace lib2::test
 		const auto mismatch {std::ranges::mismatch(actual, end1, expected, end2, std::move(pred), std::move(proj1), std::move(proj2))};
 		if (mismatch.in1 != end1)
 		{
-			throw assert_exception{lib2::format<"({}:{}) assert_ranges_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, mismatch.in1, end1, expected, mismatch.in2, end2))};
+			assertion_failed(lib2::format<"({}:{}) assert_ranges_equal failed: {}\n{}">(location.file_name(), location.line(), message, output(actual, mismatch.in1, end1, expected, mismatch.in2, end2)), location);
 		}
 	}
 
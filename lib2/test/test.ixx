@@ -4,4 +4,5 @@ export import :assert_exception;
 export import :assert;
 export import :test_result;
 export import :test_case;
+export import :test_runner;
 export import :test_suite;
\ No newline at end of file
@@ -13,8 +13,9 @@ namespace lib2::test
 		public:
 			test_case() noexcept = default;
 
-			test_case(std::string str) noexcept
-				: name_{std::move(str)} {}
+			test_case(std::string str, const assertion_mode mode = assertion_mode::throwing) noexcept
+				: name_{std::move(str)}
+				, mode_{mode} {}
 
 			[[nodiscard]] const std::string& name() const noexcept
 			{
@@ -25,43 +26,56 @@ namespace lib2::test
 			virtual void tear_down() {}
 			virtual ~test_case() noexcept = default;
 
+			[[nodiscard]] assertion_mode mode() const noexcept
+			{
+				return mode_;
+			}
+
 			test_result run() noexcept
 			{
 				test_result result;
 
-				try
-				{
-					setup();
-				}
-				catch (const std::exception&)
+				const auto previous {recording_result};
+				recording_result = mode_ == assertion_mode::recording ? &result : nullptr;
+
+				if (capture(result, [this] { setup(); }))
 				{
-					result.failure(std::current_exception());
-					return result;
+					capture(result, [this] { (*this)(); });
+					capture(result, [this] { tear_down(); });
 				}
 
+				recording_result = previous;
+				return result;
+			}
+
+			virtual void operator()() = 0;
+		private:
+			std::string name_;
+			assertion_mode mode_ {assertion_mode::throwing};
+
+			// Runs func, recording what it throws by the type it was caught
+			// as so the result never has to rethrow to classify it
+			template<class F>
+			static bool capture(test_result& result, F func) noexcept
+			{
 				try
 				{
-					operator()();
+					func();
+					return true;
 				}
-				catch (const std::exception&)
+				catch (const assert_exception&)
 				{
-					result.failure(std::current_exception());
+					result.failure(std::current_exception(), test_result::failure_kind::assertion);
 				}
-
-				try
+				catch (const error_exception&)
 				{
-					tear_down();
+					result.failure(std::current_exception(), test_result::failure_kind::error);
 				}
 				catch (const std::exception&)
 				{
-					result.failure(std::current_exception());
+					result.failure(std::current_exception(), test_result::failure_kind::exception);
 				}
-
-				return result;
+				return false;
 			}
-
-			virtual void operator()() = 0;
-		private:
-			std::string name_;
 	};
 }
\ No newline at end of file
@@ -6,15 +6,43 @@ import :assert_exception;
 
 namespace lib2::test
 {
+	// How assertions report a failure. Throwing stops the test at the first
+	// failure; recording adds it to the test's result and carries on, which
+	// suits tests making large numbers of checks.
+	export
+	enum class assertion_mode
+	{
+		throwing,
+		recording
+	};
+
+	export
+	struct assertion_failure
+	{
+		std::string message;
+		std::source_location location;
+	};
+
 	export
 	class test_result
 	{
 		public:
+			// Recorded failures past this many are only counted
+			static constexpr std::size_t max_recorded_failures {100};
+
+			enum class failure_kind
+			{
+				none,
+				assertion,
+				error,
+				exception
+			};
+
 			test_result() noexcept = default;
 
 			[[nodiscard]] bool failed() const noexcept
 			{
-				return static_cast<bool>(ptr);
+				return kind != failure_kind::none || num_failures_ != 0;
 			}
 
 			[[nodiscard]] bool passed() const noexcept
@@ -22,45 +50,98 @@ namespace lib2::test
 				return !failed();
 			}
 
+			// Whether the test threw something other than an assert_exception
 			[[nodiscard]] bool errored() const noexcept
 			{
-				if (ptr) [[unlikely]]
+				return kind == failure_kind::error || kind == failure_kind::exception;
+			}
+
+			[[nodiscard]] explicit operator bool() const noexcept
+			{
+				return passed();
+			}
+
+			[[nodiscard]] std::exception_ptr failure() const noexcept
+			{
+				return ptr;
+			}
+
+			[[nodiscard]] failure_kind thrown_kind() const noexcept
+			{
+				return kind;
+			}
+
+			// Classifies e by rethrowing it. Callers that caught e by type
+			// should pass its kind instead.
+			void failure(std::exception_ptr e) noexcept
+			{
+				auto e_kind {failure_kind::none};
+				if (e)
 				{
 					try
 					{
-						std::rethrow_exception(ptr);
+						std::rethrow_exception(e);
 					}
 					catch (const assert_exception&)
 					{
-						return false;
+						e_kind = failure_kind::assertion;
+					}
+					catch (const error_exception&)
+					{
+						e_kind = failure_kind::error;
 					}
-					catch (const std::exception&)
+					catch (...)
 					{
-						return true;
+						e_kind = failure_kind::exception;
 					}
 				}
+				failure(std::move(e), e_kind);
+			}
 
-				return false;
+			void failure(std::exception_ptr e, const failure_kind e_kind) noexcept
+			{
+				ptr = std::move(e);
+				kind = ptr ? e_kind : failure_kind::none;
 			}
 
-			[[nodiscard]] explicit operator bool() const noexcept
+			void record(assertion_failure f)
 			{
-				return passed();
+				if (failures_.size() < max_recorded_failures)
+				{
+					failures_.push_back(std::move(f));
+				}
+				++num_failures_;
 			}
 
-			[[nodiscard]] std::exception_ptr failure() const noexcept
+			[[nodiscard]] std::span<const assertion_failure> failures() const noexcept
 			{
-				return ptr;
+				return failures_;
 			}
 
-			void failure(std::exception_ptr e) noexcept 
+			// Includes the failures past max_recorded_failures
+			[[nodiscard]] std::size_t num_failures() const noexcept
 			{
-				ptr = e;
+				return num_failures_;
 			}
 
+			// Calls func with each recorded assertion_failure, then with the
+			// thrown exception, if it takes them
 			template<class F>
 			void on(F&& func) const
 			{
+				if constexpr (std::invocable<F&, const assertion_failure&>)
+				{
+					for (const auto& f : failures_)
+					{
+						std::invoke(func, f);
+					}
+				}
+
+				if (kind == failure_kind::none)
+				{
+					return;
+				}
+
 				try
 				{
 					std::rethrow_exception(ptr);
@@ -97,5 +178,12 @@ namespace lib2::test
 			}
 		private:
 			std::exception_ptr ptr;
+			failure_kind kind {failure_kind::none};
+			std::vector<assertion_failure> failures_;
+			std::size_t num_failures_ {0};
 	};
+
+	// The result assertions record into on this thread while a test in
+	// recording mode runs
+	thread_local test_result* recording_result {nullptr};
 }
\ No newline at end of file
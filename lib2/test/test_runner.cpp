@@ -0,0 +1,291 @@
+module lib2.test;
+
+import std;
+
+import :test_runner;
+
+namespace lib2::test
+{
+	using clock = std::chrono::steady_clock;
+
+	constexpr std::size_t no_test {std::numeric_limits<std::size_t>::max()};
+
+	bool matches_pattern(std::string_view name, std::string_view pattern) noexcept
+	{
+		// Greedy matching that backtracks to the last * on a mismatch
+		std::size_t n {0};
+		std::size_t p {0};
+		std::size_t star {std::string_view::npos};
+		std::size_t star_n {0};
+
+		while (n < name.size())
+		{
+			if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n]))
+			{
+				++n;
+				++p;
+			}
+			else if (p < pattern.size() && pattern[p] == '*')
+			{
+				star = p++;
+				star_n = n;
+			}
+			else if (star != std::string_view::npos)
+			{
+				p = star + 1;
+				n = ++star_n;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		while (p < pattern.size() && pattern[p] == '*')
+		{
+			++p;
+		}
+		return p == pattern.size();
+	}
+
+	std::vector<test_case*> select_tests(std::span<test_case* const> tests, const test_run_options& options)
+	{
+		if (options.shard_count == 0 || options.shard_index >= options.shard_count)
+		{
+			throw std::invalid_argument{"Shard index must be less than the shard count"};
+		}
+
+		const auto matches_any {[](const std::string& name, const std::vector<std::string>& patterns) {
+			return std::ranges::any_of(patterns, [&](const std::string& pattern) {
+				return matches_pattern(name, pattern);
+			});
+		}};
+
+		std::vector<test_case*> selected;
+		std::size_t position {0};
+		for (auto* const test : tests)
+		{
+			if ((!options.include.empty() && !matches_any(test->name(), options.include)) ||
+				matches_any(test->name(), options.exclude))
+			{
+				continue;
+			}
+
+			if (position++ % options.shard_count == options.shard_index)
+			{
+				selected.push_back(test);
+			}
+		}
+		return selected;
+	}
+
+	struct work_queue
+	{
+		std::mutex mutex;
+		std::deque<std::size_t> indices;
+	};
+
+	// Shared by the workers and the thread watching them. Workers own a
+	// reference, as a timed out worker may outlive run_tests.
+	struct test_pool
+	{
+		test_pool(std::span<test_case* const> tests, const std::size_t num_queues)
+			: tests{tests.begin(), tests.end()}
+			, runs(tests.size())
+			, claimed{std::make_unique<std::atomic_flag[]>(tests.size())}
+			, queues(num_queues)
+		{
+			for (std::size_t i {0}; i < tests.size(); ++i)
+			{
+				queues[i % num_queues].indices.push_back(i);
+			}
+		}
+
+		// Takes the next test of queue home, or steals the last test of
+		// another queue
+		std::optional<std::size_t> take(const std::size_t home)
+		{
+			{
+				std::scoped_lock lock {queues[home].mutex};
+				if (!queues[home].indices.empty())
+				{
+					const auto index {queues[home].indices.front()};
+					queues[home].indices.pop_front();
+					return index;
+				}
+			}
+
+			for (std::size_t i {1}; i < queues.size(); ++i)
+			{
+				auto& victim {queues[(home + i) % queues.size()]};
+				std::scoped_lock lock {victim.mutex};
+				if (!victim.indices.empty())
+				{
+					const auto index {victim.indices.back()};
+					victim.indices.pop_back();
+					return index;
+				}
+			}
+
+			return std::nullopt;
+		}
+
+		// Records the run of a test, unless it has already been recorded
+		// as timed out
+		bool finish(const std::size_t index, test_run run)
+		{
+			if (claimed[index].test_and_set())
+			{
+				return false;
+			}
+
+			runs[index] = std::move(run);
+			{
+				std::scoped_lock lock {mutex};
+				++num_finished;
+			}
+			finished.notify_all();
+			return true;
+		}
+
+		std::vector<test_case*> tests;
+		std::vector<test_run> runs;
+		std::unique_ptr<std::atomic_flag[]> claimed;
+		std::vector<work_queue> queues;
+
+		std::mutex mutex;
+		std::condition_variable finished;
+		std::size_t num_finished {0};
+	};
+
+	// The test a worker is running and when it started, published together
+	// so the watcher never pairs one test with another's start
+	struct running_test
+	{
+		std::size_t index {no_test};
+		clock::rep started {0};
+	};
+
+	struct worker_state
+	{
+		std::atomic<running_test> current {running_test{}};
+		std::atomic<bool> abandoned {false};
+	};
+
+	static void run_worker(const std::shared_ptr<test_pool> pool, const std::shared_ptr<worker_state> state, const std::size_t home)
+	{
+		while (!state->abandoned)
+		{
+			const auto index {pool->take(home)};
+			if (!index)
+			{
+				break;
+			}
+
+			const auto start {clock::now()};
+			state->current = running_test{*index, start.time_since_epoch().count()};
+
+			auto result {pool->tests[*index]->run()};
+			const auto duration {clock::now() - start};
+
+			state->current = running_test{};
+			pool->finish(*index, {
+				.test = pool->tests[*index],
+				.result = std::move(result),
+				.duration = duration
+			});
+		}
+	}
+
+	test_run_summary run_tests(std::span<test_case* const> tests, const test_run_options& options)
+	{
+		const auto start {clock::now()};
+		if (tests.empty())
+		{
+			return {};
+		}
+
+		auto num_threads {options.num_threads != 0 ? options.num_threads : std::thread::hardware_concurrency()};
+		num_threads = std::clamp<std::size_t>(num_threads, 1, tests.size());
+
+		const auto pool {std::make_shared<test_pool>(tests, num_threads)};
+
+		struct worker
+		{
+			std::thread thread;
+			std::shared_ptr<worker_state> state;
+			std::size_t home;
+		};
+
+		const auto start_worker {[&](const std::size_t home) {
+			auto state {std::make_shared<worker_state>()};
+			return worker{std::thread{run_worker, pool, state, home}, std::move(state), home};
+		}};
+
+		std::vector<worker> workers;
+		workers.reserve(num_threads);
+		for (std::size_t i {0}; i < num_threads; ++i)
+		{
+			workers.push_back(start_worker(i));
+		}
+
+		const auto all_finished {[&] {
+			return pool->num_finished == tests.size();
+		}};
+
+		if (options.timeout == std::chrono::milliseconds::zero())
+		{
+			std::unique_lock lock {pool->mutex};
+			pool->finished.wait(lock, all_finished);
+		}
+		else
+		{
+			const auto poll_interval {std::clamp<std::chrono::milliseconds>(options.timeout / 10, std::chrono::milliseconds{1}, std::chrono::milliseconds{100})};
+
+			std::unique_lock lock {pool->mutex};
+			while (!pool->finished.wait_for(lock, poll_interval, all_finished))
+			{
+				lock.unlock();
+				const auto now {clock::now()};
+				for (auto& w : workers)
+				{
+					const auto [index, started_at] {w.state->current.load()};
+					const clock::time_point started {clock::duration{started_at}};
+					if (index == no_test || now - started < options.timeout)
+					{
+						continue;
+					}
+
+					// The test finished in the meantime, so the worker has
+					// moved on and is left alone
+					if (!pool->finish(index, {
+						.test = pool->tests[index],
+						.result = {},
+						.duration = now - started,
+						.timed_out = true
+					}))
+					{
+						continue;
+					}
+
+					// The test cannot be stopped, so the thread is left to it
+					// and replaced
+					w.state->abandoned = true;
+					w.thread.detach();
+					w = start_worker(w.home);
+				}
+				lock.lock();
+			}
+		}
+
+		for (auto& w : workers)
+		{
+			w.thread.join();
+		}
+
+		return {
+			.runs = std::move(pool->runs),
+			.wall_time = clock::now() - start
+		};
+	}
+}
\ No newline at end of file
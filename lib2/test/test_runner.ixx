@@ -0,0 +1,87 @@
+export module lib2.test:test_runner;
+
+import std;
+
+import :test_case;
+import :test_result;
+
+namespace lib2::test
+{
+	export
+	struct test_run_options
+	{
+		// A test runs when its name matches one of the include patterns, or
+		// there are none, and none of the exclude patterns. Patterns are
+		// globs where * matches any run of characters and ? any one.
+		std::vector<std::string> include;
+		std::vector<std::string> exclude;
+
+		// Of the tests that pass the filters, only every shard_count'th one
+		// runs, starting at shard_index, so separate processes can split a
+		// run between them
+		std::size_t shard_index {0};
+		std::size_t shard_count {1};
+
+		// 0 runs a thread per hardware thread
+		std::size_t num_threads {0};
+
+		// A test still running after this long is reported as timed out
+		// and its thread is abandoned. 0 waits on every test.
+		std::chrono::milliseconds timeout {0};
+	};
+
+	export
+	struct test_run
+	{
+		const test_case* test {nullptr};
+		test_result result;
+		std::chrono::nanoseconds duration {0};
+		bool timed_out {false};
+
+		[[nodiscard]] bool passed() const noexcept
+		{
+			return !timed_out && result.passed();
+		}
+	};
+
+	export
+	struct test_run_summary
+	{
+		// In the order the tests were given
+		std::vector<test_run> runs;
+		std::chrono::nanoseconds wall_time {0};
+
+		[[nodiscard]] std::size_t num_failed() const noexcept
+		{
+			return static_cast<std::size_t>(std::ranges::count_if(runs, [](const test_run& run) {
+				return !run.passed();
+			}));
+		}
+
+		[[nodiscard]] std::size_t num_timed_out() const noexcept
+		{
+			return static_cast<std::size_t>(std::ranges::count(runs, true, &test_run::timed_out));
+		}
+
+		[[nodiscard]] bool passed() const noexcept
+		{
+			return num_failed() == 0;
+		}
+	};
+
+	export
+	[[nodiscard]] bool matches_pattern(std::string_view name, std::string_view pattern) noexcept;
+
+	// The tests picked out by the filters and shard of options, in order.
+	// Throws std::invalid_argument when the shard does not exist.
+	export
+	[[nodiscard]] std::vector<test_case*> select_tests(std::span<test_case* const> tests, const test_run_options& options);
+
+	// Runs every test on a pool of threads. Each thread works through its
+	// own queue of tests and steals from the others once it runs dry.
+	// When a test times out, its thread is left running and a new one
+	// takes its place, so the process should exit soon after rather than
+	// destroy tests that may still be in use.
+	export
+	[[nodiscard]] test_run_summary run_tests(std::span<test_case* const> tests, const test_run_options& options);
+}
\ No newline at end of file
@@ -6,6 +6,7 @@ import lib2.iterator;
 
 import :test_case;
 import :test_result;
+import :test_runner;
 
 namespace lib2::test
 {
@@ -76,6 +77,19 @@ namespace lib2::test
 		{
 			cases.splice(cases.end(), std::move(suite.cases));
 		}
+
+		// Runs the selected tests in this process, see run_tests
+		[[nodiscard]] test_run_summary run(const test_run_options& options = {})
+		{
+			std::vector<test_case*> tests;
+			tests.reserve(cases.size());
+			for (const auto& test : cases)
+			{
+				tests.push_back(test.get());
+			}
+
+			return run_tests(select_tests(tests, options), options);
+		}
 	private:
 		std::string name_;
 		std::list<std::unique_ptr<test_case>> cases;
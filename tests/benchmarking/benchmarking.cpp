@@ -0,0 +1,26 @@
+module lib2.tests.benchmarking;
+
+import std;
+import lib2;
+
+import :complexity;
+import :result_file;
+import :statistics;
+
+namespace lib2::tests::benchmarking
+{
+    lib2::test::test_suite get_tests()
+    {
+        lib2::test::test_suite suite{"benchmarking library tests"};
+        suite.add_test_case<quantile_test>();
+        suite.add_test_case<compute_statistics_test>();
+        suite.add_test_case<csv_results_round_trip_test>();
+        suite.add_test_case<json_results_non_finite_test>();
+        suite.add_test_case<compare_results_test>();
+        suite.add_test_case<benchmark_main_baseline_test>();
+        suite.add_test_case<fit_complexity_test>();
+        suite.add_test_case<benchmark_ranges_test>();
+
+        return std::move(suite);
+    }
+}
\ No newline at end of file
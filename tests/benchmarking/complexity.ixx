@@ -0,0 +1,82 @@
+export module lib2.tests.benchmarking:complexity;
+
+import std;
+import lib2;
+
+namespace lib2::tests::benchmarking
+{
+    export
+    class fit_complexity_test : public lib2::test::test_case
+    {
+    public:
+        fit_complexity_test()
+            : lib2::test::test_case{"fit_complexity"} {}
+
+        void operator()() final
+        {
+            using lib2::benchmarking::complexity;
+
+            const auto ns {lib2::benchmarking::range_multiplier(8, 1 << 16, 4)};
+            const auto fit {[&](const auto time) {
+                std::vector<double> times;
+                for (std::size_t i {0}; i < ns.size(); ++i)
+                {
+                    // A little deterministic noise, as measurements have
+                    const auto noise {i % 2 == 0 ? 1.02 : 0.98};
+                    times.push_back(time(static_cast<double>(ns[i])) * noise);
+                }
+                return lib2::benchmarking::fit_complexity(ns, times);
+            }};
+
+            const auto linear {fit([](const double n) { return 3 * n; })};
+            lib2::test::assert_true(linear.big_o == complexity::o_n, lib2::benchmarking::to_string(linear.big_o));
+            lib2::test::assert_almost_equal(linear.coefficient, 3.0, 0.1);
+            lib2::test::assert_true(linear.rms < 0.05);
+
+            const auto n_log_n {fit([](const double n) { return 0.5 * n * std::log2(n); })};
+            lib2::test::assert_true(n_log_n.big_o == complexity::o_n_log_n, lib2::benchmarking::to_string(n_log_n.big_o));
+            lib2::test::assert_almost_equal(n_log_n.coefficient, 0.5, 0.02);
+
+            const auto quadratic {fit([](const double n) { return 0.01 * n * n; })};
+            lib2::test::assert_true(quadratic.big_o == complexity::o_n_squared, lib2::benchmarking::to_string(quadratic.big_o));
+            lib2::test::assert_almost_equal(quadratic.coefficient, 0.01, 0.001);
+
+            const auto constant {fit([](const double) { return 40.0; })};
+            lib2::test::assert_true(constant.big_o == complexity::o_1, lib2::benchmarking::to_string(constant.big_o));
+
+            const auto empty {lib2::benchmarking::fit_complexity({}, {})};
+            lib2::test::assert_true(empty.big_o == complexity::o_1);
+            lib2::test::assert_equal(empty.coefficient, 0.0);
+        }
+    };
+
+    export
+    class benchmark_ranges_test : public lib2::test::test_case
+    {
+    public:
+        benchmark_ranges_test()
+            : lib2::test::test_case{"benchmark_ranges"} {}
+
+        void operator()() final
+        {
+            using values = std::vector<std::size_t>;
+
+            // Powers of the multiplier from lo, always ending at hi
+            lib2::test::assert_equal(lib2::benchmarking::range_multiplier(1, 512), values{1, 8, 64, 512});
+            lib2::test::assert_equal(lib2::benchmarking::range_multiplier(1, 100), values{1, 8, 64, 100});
+            lib2::test::assert_equal(lib2::benchmarking::range_multiplier(3, 40, 3), values{3, 9, 27, 40});
+            lib2::test::assert_equal(lib2::benchmarking::range_multiplier(0, 4, 2), values{1, 2, 4});
+            lib2::test::assert_equal(lib2::benchmarking::range_multiplier(16, 16), values{16});
+
+            // A multiplier below 2 would never grow
+            lib2::test::assert_equal(lib2::benchmarking::range_multiplier(1, 8, 1), values{1, 2, 4, 8});
+
+            // Every step from lo up to and including hi
+            lib2::test::assert_equal(lib2::benchmarking::dense_range(0, 4), values{0, 1, 2, 3, 4});
+            lib2::test::assert_equal(lib2::benchmarking::dense_range(10, 25, 5), values{10, 15, 20, 25});
+            lib2::test::assert_equal(lib2::benchmarking::dense_range(10, 24, 5), values{10, 15, 20});
+            lib2::test::assert_equal(lib2::benchmarking::dense_range(2, 4, 0), values{2, 3, 4});
+            lib2::test::assert_true(lib2::benchmarking::dense_range(5, 4).empty());
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,226 @@
+export module lib2.tests.benchmarking:result_file;
+
+import std;
+import lib2;
+
+namespace lib2::tests::benchmarking
+{
+    using lib2::benchmarking::fractional_nanoseconds;
+
+    [[nodiscard]] lib2::benchmarking::benchmark_statistics make_statistics(const double mean, const double stddev, const std::size_t num_samples)
+    {
+        return {
+            .num_samples = num_samples,
+            .min         = fractional_nanoseconds{mean - stddev},
+            .median      = fractional_nanoseconds{mean},
+            .p99         = fractional_nanoseconds{mean + 2 * stddev},
+            .mean        = fractional_nanoseconds{mean},
+            .stddev      = fractional_nanoseconds{stddev}
+        };
+    }
+
+    export
+    class csv_results_round_trip_test : public lib2::test::test_case
+    {
+    public:
+        csv_results_round_trip_test()
+            : lib2::test::test_case{"csv_results_round_trip"} {}
+
+        void operator()() final
+        {
+            auto counted {make_statistics(12.5, 0.25, 40)};
+            counted.num_outliers = 3;
+            counted.batch_size = 8;
+            counted.events.cycles = 40.5;
+            counted.events.instructions = 120;
+            counted.bytes_per_iteration = 64;
+            counted.items_per_iteration = 2;
+            counted.complexity_n = 1024;
+
+            const std::vector<lib2::benchmarking::suite_statistics> suites {
+                {"plain", {{"first", counted}, {"second", make_statistics(1.5, 0, 1)}}},
+                {"needs, \"quotes\"", {{"line\nbreak", make_statistics(1000, 12.75, 100)}}}
+            };
+
+            lib2::ostringstream ss;
+            lib2::benchmarking::write_csv(ss, suites);
+            const auto parsed {lib2::benchmarking::parse_csv_results(ss.view())};
+
+            lib2::test::assert_equal(parsed.size(), suites.size());
+            for (std::size_t s {0}; s < suites.size(); ++s)
+            {
+                lib2::test::assert_equal(parsed[s].name, suites[s].name);
+                lib2::test::assert_equal(parsed[s].results.size(), suites[s].results.size());
+                for (std::size_t b {0}; b < suites[s].results.size(); ++b)
+                {
+                    const auto& [name, expected] {suites[s].results[b]};
+                    const auto& [parsed_name, actual] {parsed[s].results[b]};
+                    lib2::test::assert_equal(parsed_name, name);
+                    lib2::test::assert_equal(actual.num_samples, expected.num_samples, name);
+                    lib2::test::assert_equal(actual.num_outliers, expected.num_outliers, name);
+                    lib2::test::assert_equal(actual.batch_size, expected.batch_size, name);
+                    lib2::test::assert_equal(actual.min.count(), expected.min.count(), name);
+                    lib2::test::assert_equal(actual.median.count(), expected.median.count(), name);
+                    lib2::test::assert_equal(actual.p99.count(), expected.p99.count(), name);
+                    lib2::test::assert_equal(actual.mean.count(), expected.mean.count(), name);
+                    lib2::test::assert_equal(actual.stddev.count(), expected.stddev.count(), name);
+                    lib2::test::assert_true(actual.events.cycles == expected.events.cycles, name);
+                    lib2::test::assert_true(actual.events.instructions == expected.events.instructions, name);
+                    lib2::test::assert_false(actual.events.llc_misses.has_value(), name);
+                    lib2::test::assert_equal(actual.bytes_per_iteration, expected.bytes_per_iteration, name);
+                    lib2::test::assert_equal(actual.items_per_iteration, expected.items_per_iteration, name);
+                    lib2::test::assert_equal(actual.complexity_n, expected.complexity_n, name);
+                }
+            }
+
+            lib2::test::assert_throws<std::invalid_argument>([] {
+                [[maybe_unused]] const auto results {lib2::benchmarking::parse_csv_results("suite,name\nx,y\n")};
+            });
+
+            // Written before the bytes, items and n columns
+            const auto old {lib2::benchmarking::parse_csv_results(
+                "suite,name,samples,outliers,batch_size,min_ns,median_ns,p99_ns,mean_ns,stddev_ns,cycles,instructions,branch_misses,l1d_misses,llc_misses\n"
+                "old,bench,10,1,4,1.5,2,3.5,2.25,0.5,,,,,\n"
+            )};
+            lib2::test::assert_equal(old.size(), std::size_t{1});
+            lib2::test::assert_equal(old[0].results.size(), std::size_t{1});
+            const auto& [old_name, old_stats] {old[0].results[0]};
+            lib2::test::assert_equal(old_name, std::string{"bench"});
+            lib2::test::assert_equal(old_stats.num_samples, std::size_t{10});
+            lib2::test::assert_equal(old_stats.mean.count(), 2.25);
+            lib2::test::assert_equal(old_stats.complexity_n, std::size_t{0});
+
+            // Old rows under a new header, and the other way around
+            lib2::test::assert_throws<std::invalid_argument>([&] {
+                const auto text {ss.str()};
+                [[maybe_unused]] const auto results {lib2::benchmarking::parse_csv_results(text.substr(0, text.find('\n') + 1) + "old,bench,10,1,4,1.5,2,3.5,2.25,0.5,,,,,\n")};
+            });
+            lib2::test::assert_throws<std::invalid_argument>([] {
+                [[maybe_unused]] const auto results {lib2::benchmarking::parse_csv_results(
+                    "suite,name,samples,outliers,batch_size,min_ns,median_ns,p99_ns,mean_ns,stddev_ns,cycles,instructions,branch_misses,l1d_misses,llc_misses\n"
+                    "old,bench,10,1,4,1.5,2,3.5,2.25,0.5,,,,,,0,0,0\n"
+                )};
+            });
+        }
+    };
+
+    export
+    class json_results_non_finite_test : public lib2::test::test_case
+    {
+    public:
+        json_results_non_finite_test()
+            : lib2::test::test_case{"json_results_non_finite"} {}
+
+        void operator()() final
+        {
+            auto stats {make_statistics(std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(), 1)};
+            stats.events.cycles = -std::numeric_limits<double>::infinity();
+
+            const std::vector<lib2::benchmarking::suite_statistics> suites {
+                {"suite", {{"bench", stats}}}
+            };
+
+            lib2::ostringstream ss;
+            lib2::benchmarking::write_json(ss, suites);
+            const auto json {ss.view()};
+
+            // JSON has no literal for either
+            lib2::test::assert_true(json.find("nan") == std::string_view::npos, json);
+            lib2::test::assert_true(json.find("inf") == std::string_view::npos, json);
+            lib2::test::assert_true(json.find("\"mean_ns\": null") != std::string_view::npos, json);
+            lib2::test::assert_true(json.find("\"stddev_ns\": null") != std::string_view::npos, json);
+            lib2::test::assert_true(json.find("\"cycles\": null") != std::string_view::npos, json);
+        }
+    };
+
+    export
+    class compare_results_test : public lib2::test::test_case
+    {
+    public:
+        compare_results_test()
+            : lib2::test::test_case{"compare_results"} {}
+
+        void operator()() final
+        {
+            const std::vector<lib2::benchmarking::suite_statistics> baseline {
+                {"suite", {
+                    {"slower", make_statistics(100, 1, 100)},
+                    {"faster", make_statistics(100, 1, 100)},
+                    {"same", make_statistics(100, 1, 100)},
+                    {"noisy", make_statistics(100, 50, 4)},
+                    {"removed", make_statistics(100, 1, 100)}
+                }}
+            };
+            const std::vector<lib2::benchmarking::suite_statistics> current {
+                {"suite", {
+                    {"slower", make_statistics(120, 1, 100)},
+                    {"faster", make_statistics(80, 1, 100)},
+                    {"same", make_statistics(100.5, 1, 100)},
+                    {"noisy", make_statistics(130, 50, 4)},
+                    {"added", make_statistics(100, 1, 100)}
+                }}
+            };
+
+            const auto comparisons {lib2::benchmarking::compare_results(baseline, current)};
+            lib2::test::assert_equal(comparisons.size(), std::size_t{4});
+
+            const auto find {[&](const std::string_view name) -> const lib2::benchmarking::benchmark_comparison& {
+                return *std::ranges::find(comparisons, name, &lib2::benchmarking::benchmark_comparison::name);
+            }};
+
+            const auto& slower {find("slower")};
+            lib2::test::assert_almost_equal(slower.change, 0.2, 1e-9);
+            lib2::test::assert_true(slower.regression);
+            lib2::test::assert_false(slower.improvement);
+
+            const auto& faster {find("faster")};
+            lib2::test::assert_almost_equal(faster.change, -0.2, 1e-9);
+            lib2::test::assert_false(faster.regression);
+            lib2::test::assert_true(faster.improvement);
+
+            // Significant, but below min_relative_change
+            const auto& same {find("same")};
+            lib2::test::assert_false(same.regression);
+            lib2::test::assert_false(same.improvement);
+
+            // Large, but within the noise
+            const auto& noisy {find("noisy")};
+            lib2::test::assert_true(noisy.change_low < 0);
+            lib2::test::assert_false(noisy.regression);
+            lib2::test::assert_false(noisy.improvement);
+
+            lib2::ostringstream ss;
+            lib2::benchmarking::print_comparison(ss, comparisons);
+            lib2::test::assert_true(ss.view().find("suite/slower") != std::string_view::npos, ss.view());
+            lib2::test::assert_true(ss.view().find("regression") != std::string_view::npos, ss.view());
+            lib2::test::assert_true(ss.view().find("improvement") != std::string_view::npos, ss.view());
+        }
+    };
+
+    export
+    class benchmark_main_baseline_test : public lib2::test::test_case
+    {
+    public:
+        benchmark_main_baseline_test()
+            : lib2::test::test_case{"benchmark_main_baseline"} {}
+
+        void operator()() final
+        {
+            const auto filename {std::filesystem::temp_directory_path() / "lib2_malformed_baseline.csv"};
+            std::filesystem::remove(filename);
+            {
+                lib2::ofstream file {filename};
+                lib2::format_to<"suite,name\nx,y\n">(file);
+            }
+
+            // Fails before running anything
+            const lib2::benchmarking::benchmark_runner runner;
+            const auto baseline_arg {"--baseline=" + filename.string()};
+            const std::array<const char*, 2> args {"benchmarks", baseline_arg.c_str()};
+            lib2::test::assert_equal(lib2::benchmarking::benchmark_main(runner, static_cast<int>(args.size()), args.data()), 2);
+
+            std::filesystem::remove(filename);
+            lib2::test::assert_equal(lib2::benchmarking::benchmark_main(runner, static_cast<int>(args.size()), args.data()), 2);
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+export module lib2.tests.benchmarking:statistics;
+
+import std;
+import lib2;
+
+namespace lib2::tests::benchmarking
+{
+    export
+    class quantile_test : public lib2::test::test_case
+    {
+    public:
+        quantile_test()
+            : lib2::test::test_case{"quantile"} {}
+
+        void operator()() final
+        {
+            using lib2::benchmarking::quantile;
+
+            const std::vector<double> values {1, 2, 3, 4, 5};
+            lib2::test::assert_equal(quantile<double>(values, 0), 1.0);
+            lib2::test::assert_equal(quantile<double>(values, 0.5), 3.0);
+            lib2::test::assert_equal(quantile<double>(values, 1), 5.0);
+
+            // Between samples the quantile is interpolated
+            lib2::test::assert_almost_equal(quantile<double>(values, 0.1), 1.4, 1e-12);
+            lib2::test::assert_almost_equal(quantile<double>(values, 0.99), 4.96, 1e-12);
+
+            const std::vector<double> single {7};
+            lib2::test::assert_equal(quantile<double>(single, 0.99), 7.0);
+
+            // Durations use the same definition
+            using namespace std::chrono_literals;
+            const std::vector<std::chrono::nanoseconds> durations {10ns, 20ns, 40ns};
+            lib2::test::assert_equal(quantile<std::chrono::nanoseconds>(durations, 0.5), 20.0);
+            lib2::test::assert_equal(quantile<std::chrono::nanoseconds>(durations, 0.75), 30.0);
+        }
+    };
+
+    export
+    class compute_statistics_test : public lib2::test::test_case
+    {
+    public:
+        compute_statistics_test()
+            : lib2::test::test_case{"compute_statistics"} {}
+
+        void operator()() final
+        {
+            using lib2::benchmarking::compute_statistics;
+
+            const auto none {compute_statistics({}, 8, 1.5)};
+            lib2::test::assert_equal(none.num_samples, std::size_t{0});
+            lib2::test::assert_equal(none.batch_size, std::size_t{8});
+
+            const auto one {compute_statistics({5}, 1, 1.5)};
+            lib2::test::assert_equal(one.num_samples, std::size_t{1});
+            lib2::test::assert_equal(one.num_outliers, std::size_t{0});
+            lib2::test::assert_equal(one.min.count(), 5.0);
+            lib2::test::assert_equal(one.median.count(), 5.0);
+            lib2::test::assert_equal(one.p99.count(), 5.0);
+            lib2::test::assert_equal(one.mean.count(), 5.0);
+            lib2::test::assert_equal(one.stddev.count(), 0.0);
+
+            const auto two {compute_statistics({3, 1}, 1, 1.5)};
+            lib2::test::assert_equal(two.num_samples, std::size_t{2});
+            lib2::test::assert_equal(two.min.count(), 1.0);
+            lib2::test::assert_equal(two.median.count(), 2.0);
+            lib2::test::assert_almost_equal(two.p99.count(), 2.98, 1e-12);
+            lib2::test::assert_equal(two.mean.count(), 2.0);
+            lib2::test::assert_almost_equal(two.stddev.count(), std::sqrt(2.0), 1e-12);
+
+            // Quartiles 2 and 4, so the upper fence is at 7
+            const auto slow {compute_statistics({4, 100, 1, 3, 2}, 1, 1.5)};
+            lib2::test::assert_equal(slow.num_samples, std::size_t{4});
+            lib2::test::assert_equal(slow.num_outliers, std::size_t{1});
+            lib2::test::assert_equal(slow.num_iterations(), std::size_t{5});
+            lib2::test::assert_equal(slow.median.count(), 2.5);
+            lib2::test::assert_equal(slow.mean.count(), 2.5);
+            lib2::test::assert_almost_equal(slow.stddev.count(), std::sqrt(5.0 / 3.0), 1e-12);
+
+            // Quartiles 100.25 and 102.75, so the lower fence is at 96.5
+            const auto fast {compute_statistics({100, 10, 101, 102, 103, 104}, 1, 1.5)};
+            lib2::test::assert_equal(fast.num_outliers, std::size_t{1});
+            lib2::test::assert_equal(fast.min.count(), 100.0);
+
+            // A fence of 0 keeps everything
+            const auto kept {compute_statistics({4, 100, 1, 3, 2}, 1, 0)};
+            lib2::test::assert_equal(kept.num_samples, std::size_t{5});
+            lib2::test::assert_equal(kept.num_outliers, std::size_t{0});
+            lib2::test::assert_equal(kept.mean.count(), 22.0);
+        }
+    };
+}
\ No newline at end of file
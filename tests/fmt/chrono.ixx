@@ -27,4 +27,122 @@ namespace lib2::tests::fmt
             lib2::test::assert_equal(str, "15:05:21 (54321s)"); 
         }
     };
+
+    export
+    class duration_spec_fmt_test : public lib2::test::test_case
+    {
+    public:
+        duration_spec_fmt_test()
+            : lib2::test::test_case{"duration_spec_fmt"} {}
+
+        void operator()() final
+        {
+            auto str {lib2::format<"{:%T}">(std::chrono::milliseconds{3723456})};
+            lib2::test::assert_equal(str, "01:02:03.456");
+
+            str = lib2::format<"{:%R|%H%%%M%n%S}">(std::chrono::seconds{3723});
+            lib2::test::assert_equal(str, "01:02|01%02\n03");
+
+            str = lib2::format("{:%H:%M:%S}", std::chrono::microseconds{1});
+            lib2::test::assert_equal(str, "00:00:00.000001");
+
+            str = lib2::format<"{:%C %y %Y %D %F %e}">(std::chrono::year_month_day{std::chrono::year{2023}, std::chrono::month{11}, std::chrono::day{4}});
+            lib2::test::assert_equal(str, "20 23 2023 11/04/23 2023-11-04  4");
+        }
+    };
+
+    export
+    class duration_auto_fmt_test : public lib2::test::test_case
+    {
+    public:
+        duration_auto_fmt_test()
+            : lib2::test::test_case{"duration_auto_fmt"} {}
+
+        void operator()() final
+        {
+            auto str {lib2::format<"{}">(std::chrono::seconds{45})};
+            lib2::test::assert_equal(str, "45s");
+
+            str = lib2::format<"{} after {}">(std::chrono::milliseconds{250}, 3);
+            lib2::test::assert_equal(str, "250ms after 3");
+
+            str = lib2::format<"{:auto}">(std::chrono::nanoseconds{1234});
+            lib2::test::assert_equal(str, "1234ns");
+
+            str = lib2::format<"{:auto}">(std::chrono::nanoseconds{12345});
+            lib2::test::assert_equal(str, "12.35us");
+
+            str = lib2::format<"{:auto}">(std::chrono::nanoseconds{5000});
+            lib2::test::assert_equal(str, "5us");
+
+            str = lib2::format<"{:auto}">(std::chrono::nanoseconds{0});
+            lib2::test::assert_equal(str, "0ns");
+
+            str = lib2::format<"{:.1auto}">(std::chrono::duration<double, std::micro>{12345.0});
+            lib2::test::assert_equal(str, "12.3ms");
+
+            str = lib2::format<"[{:>8auto}|{:<6}]">(std::chrono::nanoseconds{12345}, std::chrono::seconds{3});
+            lib2::test::assert_equal(str, "[ 12.35us|3s    ]");
+        }
+    };
+
+    export
+    class sys_time_fmt_test : public lib2::test::test_case
+    {
+    public:
+        sys_time_fmt_test()
+            : lib2::test::test_case{"sys_time_fmt"} {}
+
+        void operator()() final
+        {
+            const std::chrono::sys_seconds time {std::chrono::seconds{1'700'000'000}};
+
+            auto str {lib2::format<"{}">(time)};
+            lib2::test::assert_equal(str, "2023-11-14 22:13:20");
+
+            str = lib2::format<"{:%FT%TZ}">(time + std::chrono::milliseconds{7});
+            lib2::test::assert_equal(str, "2023-11-14T22:13:20.007Z");
+
+            str = lib2::format<"{:%Y%m%d %H%M%S %z %Ez %Z %j %u %w %a}">(time);
+            lib2::test::assert_equal(str, "20231114 221320 +0000 +00:00 UTC 318 2 2 Tue");
+
+            str = lib2::format("{:>25%F %T}", time);
+            lib2::test::assert_equal(str, "      2023-11-14 22:13:20");
+
+            lib2::test::assert_throws<lib2::format_error>([] {
+                static_cast<void>(lib2::format("{:%Q}", std::chrono::sys_seconds{}));
+            });
+        }
+    };
+
+    export
+    class sys_time_cache_fmt_test : public lib2::test::test_case
+    {
+    public:
+        sys_time_cache_fmt_test()
+            : lib2::test::test_case{"sys_time_cache_fmt"} {}
+
+        void operator()() final
+        {
+            // The date and time of each second are cached, so formatting
+            // within a second, across seconds and with another spec must
+            // each give what formatting from scratch does
+            const std::chrono::sys_time<std::chrono::microseconds> time {std::chrono::seconds{1'700'000'000}};
+
+            auto str {lib2::format<"[{:%F %T}]">(time + std::chrono::microseconds{1})};
+            lib2::test::assert_equal(str, "[2023-11-14 22:13:20.000001]");
+
+            str = lib2::format<"[{:%F %T}]">(time + std::chrono::microseconds{999'999});
+            lib2::test::assert_equal(str, "[2023-11-14 22:13:20.999999]");
+
+            str = lib2::format<"[{:%F %T}]">(time + std::chrono::seconds{1});
+            lib2::test::assert_equal(str, "[2023-11-14 22:13:21.000000]");
+
+            str = lib2::format<"[{:%T %F}]">(time + std::chrono::seconds{1});
+            lib2::test::assert_equal(str, "[22:13:21.000000 2023-11-14]");
+
+            str = lib2::format("[{:%F %T}]", time - std::chrono::days{1});
+            lib2::test::assert_equal(str, "[2023-11-13 22:13:20.000000]");
+        }
+    };
 }
\ No newline at end of file
@@ -24,6 +24,47 @@ namespace lib2::tests::fmt
         }
     };
 
+    // Values across the whole exponent range, including the boundaries
+    // where the shortest and fixed conversions change layout or fall back
+    export
+    template<std::floating_point T>
+    class floating_wide_test : public lib2::test::test_case
+    {
+        using bits_type = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+    public:
+        using lib2::test::test_case::test_case;
+
+        void operator()() final
+        {
+            std::vector<T> values {
+                T{0}, -T{0}, T{1}, T{0.5}, T{0.125}, T{0.3}, T{1e7}, T{1e16}, T{9007199254740993.0},
+                std::numeric_limits<T>::min(), std::numeric_limits<T>::max(),
+                std::numeric_limits<T>::denorm_min(), std::numeric_limits<T>::lowest(),
+                std::numeric_limits<T>::epsilon(), std::numeric_limits<T>::infinity(),
+                -std::numeric_limits<T>::infinity(), std::numeric_limits<T>::quiet_NaN()
+            };
+
+            std::mt19937_64 gen {42};
+            for (int i {0}; i < 100000; ++i)
+            {
+                const auto v {std::bit_cast<T>(static_cast<bits_type>(gen()))};
+                if (!std::isnan(v))
+                {
+                    values.push_back(v);
+                }
+            }
+
+            for (const auto v : values)
+            {
+                lib2::test::assert_equal(lib2::format<"{}">(v), std::format("{}", v));
+                lib2::test::assert_equal(lib2::format<"{:>32}">(v), std::format("{:>32}", v));
+                lib2::test::assert_equal(lib2::format<"{:.3f}">(v), std::format("{:.3f}", v));
+                lib2::test::assert_equal(lib2::format<"{:.17f}">(v), std::format("{:.17f}", v));
+                lib2::test::assert_equal(lib2::format<"{:+.0f}">(v), std::format("{:+.0f}", v));
+            }
+        }
+    };
+
     export
     class floating_type_test : public lib2::test::test_case
     {
@@ -8,6 +8,8 @@ import :string;
 import :integral;
 import :floating;
 import :chrono;
+import :ranges;
+import :runtime;
 
 namespace lib2::tests::fmt
 {
@@ -18,7 +20,10 @@ namespace lib2::tests::fmt
         
         suite.add_test_case<string_fmt_test>();
         suite.add_test_case<string_unicode_fmt_test>();
+        suite.add_test_case<string_gather_fmt_test>();
+        suite.add_test_case<string_builder_fmt_test>();
         suite.add_test_case<string_debug_fmt_test>();
+        suite.add_test_case<string_precision_fmt_test>();
         
         suite.add_test_case<integral_test<std::uint8_t>>("fmt_uint8");
         suite.add_test_case<integral_test<std::int8_t>>("fmt_int8");
@@ -28,14 +33,30 @@ namespace lib2::tests::fmt
         suite.add_test_case<integral_test<std::int32_t>>("fmt_int32");
         suite.add_test_case<integral_test<std::uint64_t>>("fmt_uint64");
         suite.add_test_case<integral_test<std::int64_t>>("fmt_int64");
+        suite.add_test_case<integral_wide_test<std::uint32_t>>("fmt_uint32_wide");
+        suite.add_test_case<integral_wide_test<std::int32_t>>("fmt_int32_wide");
+        suite.add_test_case<integral_wide_test<std::uint64_t>>("fmt_uint64_wide");
+        suite.add_test_case<integral_wide_test<std::int64_t>>("fmt_int64_wide");
         suite.add_test_case<integral_base_test>();
+        suite.add_test_case<fused_fmt_test>();
 
         suite.add_test_case<floating_test<float>>("fmt_float");
         suite.add_test_case<floating_test<double>>("fmt_double");
         suite.add_test_case<floating_test<long double>>("fmt_long_double");
+        suite.add_test_case<floating_wide_test<float>>("fmt_float_wide");
+        suite.add_test_case<floating_wide_test<double>>("fmt_double_wide");
         suite.add_test_case<floating_type_test>();
 
         suite.add_test_case<duration_fmt_test>();
+        suite.add_test_case<duration_spec_fmt_test>();
+        suite.add_test_case<duration_auto_fmt_test>();
+        suite.add_test_case<sys_time_fmt_test>();
+        suite.add_test_case<sys_time_cache_fmt_test>();
+
+        suite.add_test_case<range_fmt_test>();
+        suite.add_test_case<range_padded_fmt_test>();
+
+        suite.add_test_case<runtime_fmt_test>();
 
         return std::move(suite);
     }
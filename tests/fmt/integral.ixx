@@ -35,6 +35,49 @@ namespace lib2::tests::fmt
         }
     };
 
+    // Values around every power of ten and the limits, where the digit
+    // count and the 8/16 digit blocks change
+    export
+    template<std::integral T>
+    class integral_wide_test : public lib2::test::test_case
+    {
+    public:
+        using lib2::test::test_case::test_case;
+
+        void operator()() final
+        {
+            std::vector<T> values {std::numeric_limits<T>::min(), std::numeric_limits<T>::max()};
+            for (std::uintmax_t power {1}; power <= static_cast<std::uintmax_t>(std::numeric_limits<T>::max()); power *= 10)
+            {
+                for (const auto v : {power - 1, power, power + 1})
+                {
+                    if (v <= static_cast<std::uintmax_t>(std::numeric_limits<T>::max()))
+                    {
+                        values.push_back(static_cast<T>(v));
+                        if constexpr (std::signed_integral<T>)
+                        {
+                            values.push_back(static_cast<T>(-static_cast<T>(v)));
+                        }
+                    }
+                }
+
+                if (power > std::numeric_limits<std::uintmax_t>::max() / 10)
+                {
+                    break;
+                }
+            }
+
+            for (const auto v : values)
+            {
+                lib2::test::assert_equal(lib2::format<"{}">(v), std::to_string(v));
+                if (v != std::numeric_limits<T>::min())
+                {
+                    lib2::test::assert_equal(lib2::format<"{:>24}">(v), std::format("{:>24}", v));
+                }
+            }
+        }
+    };
+
     export
     class integral_base_test : public lib2::test::test_case
     {
@@ -78,4 +121,35 @@ namespace lib2::tests::fmt
             }
         }
     };
+
+    // Default formatted integers, chars, bools, pointers and floats are
+    // written with one produce when the stream has room for the worst case
+    export
+    class fused_fmt_test : public lib2::test::test_case
+    {
+    public:
+        fused_fmt_test()
+            : lib2::test::test_case{"fused_fmt"} {}
+
+        void operator()() final
+        {
+            const int* const ptr {reinterpret_cast<const int*>(0x1234)};
+            const void* const vptr {ptr};
+
+            const auto str1 {lib2::format<"Hello {}{}\n">(std::numeric_limits<std::int64_t>::min(), '!')};
+            lib2::test::assert_equal(str1, std::format("Hello {}{}\n", std::numeric_limits<std::int64_t>::min(), '!'));
+
+            const auto str2 {lib2::format<"{} {} {} {} {}">(true, false, vptr, nullptr, 0.1)};
+            lib2::test::assert_equal(str2, std::format("{} {} {} nullptr {}", true, false, vptr, 0.1));
+
+            const auto str3 {lib2::format<"{1}-{0}-{1}">(std::uint8_t{255}, -1.5f)};
+            lib2::test::assert_equal(str3, std::format("{1}-{0}-{1}", std::uint8_t{255}, -1.5f));
+
+            // Not enough room for the worst case, so every piece is checked
+            std::byte buf[8];
+            lib2::ospanstream out {buf};
+            lib2::format_to<"{}:{}">(out, 12, 34);
+            lib2::test::assert_equal(std::string_view{reinterpret_cast<const char*>(buf), 5}, "12:34");
+        }
+    };
 }
\ No newline at end of file
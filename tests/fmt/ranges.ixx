@@ -0,0 +1,65 @@
+export module lib2.tests.fmt:ranges;
+
+import std;
+import lib2;
+
+namespace lib2::tests::fmt
+{
+    export
+    class range_fmt_test : public lib2::test::test_case
+    {
+    public:
+        range_fmt_test()
+            : lib2::test::test_case{"range_fmt"} {}
+
+        void operator()() final
+        {
+            const std::vector<int> values {1, 2, 3};
+
+            lib2::test::assert_equal(lib2::format<"{}">(values), "[1, 2, 3]");
+            lib2::test::assert_equal(lib2::format<"{:n}">(values), "1, 2, 3");
+            lib2::test::assert_equal(lib2::format("{}", values), "[1, 2, 3]");
+
+            std::vector<int> many(100'000);
+            std::ranges::iota(many, 0);
+
+            std::string expected {"["};
+            for (const auto i : many)
+            {
+                expected += std::to_string(i);
+                expected += ", ";
+            }
+            expected.resize(expected.size() - 2);
+            expected += ']';
+
+            lib2::test::assert_equal(lib2::format<"{}">(many), expected);
+        }
+    };
+
+    export
+    class range_padded_fmt_test : public lib2::test::test_case
+    {
+    public:
+        range_padded_fmt_test()
+            : lib2::test::test_case{"range_padded_fmt"} {}
+
+        void operator()() final
+        {
+            const std::vector<int> values {1, 2, 3};
+
+            lib2::test::assert_equal(lib2::format<"{:>12}">(values), "   [1, 2, 3]");
+            lib2::test::assert_equal(lib2::format<"{:<12}">(values), "[1, 2, 3]   ");
+            lib2::test::assert_equal(lib2::format<"{:*^13}">(values), "**[1, 2, 3]**");
+            lib2::test::assert_equal(lib2::format<"{:>4}">(values), "[1, 2, 3]");
+            lib2::test::assert_equal(lib2::format("{:>{}}", values, 12), "   [1, 2, 3]");
+
+            // Width is counted in code points, not bytes
+            const std::vector<std::string> words {"\xC3\xA9t\xC3\xA9", "a"};
+            lib2::test::assert_equal(lib2::format<"{:>11}">(words), "   [\xC3\xA9t\xC3\xA9, a]");
+
+            const std::tuple<int, int> pair {1, 2};
+            lib2::test::assert_equal(lib2::format<"{:>8}">(pair), "  (1, 2)");
+            lib2::test::assert_equal(lib2::format<"{:m}">(pair), "1: 2");
+        }
+    };
+}
\ No newline at end of file
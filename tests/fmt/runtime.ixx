@@ -0,0 +1,65 @@
+export module lib2.tests.fmt:runtime;
+
+import std;
+import lib2;
+
+namespace lib2::tests::fmt
+{
+    export
+    class runtime_fmt_test : public lib2::test::test_case
+    {
+    public:
+        runtime_fmt_test()
+            : lib2::test::test_case{"runtime_fmt"} {}
+
+        void operator()() final
+        {
+            // Formatted more than once to go through the cached parse
+            for (int i {0}; i < 3; ++i)
+            {
+                std::string fmt {"alert {}: {:>6} over {:.2f} ({:#x})"};
+                auto str {lib2::vformat(fmt, lib2::make_format_args("cpu", 97, 90.0, 255))};
+                lib2::test::assert_equal(str, "alert cpu:     97 over 90.00 (0xff)");
+
+                // Same text, other types
+                str = lib2::vformat(fmt, lib2::make_format_args(1, "x", 2.5f, 97u));
+                lib2::test::assert_equal(str, "alert 1:      x over 2.50 (0x61)");
+
+                // Same buffer, other text
+                fmt = "value {1}={0:<5}| {{}} {2}";
+                str = lib2::vformat(fmt, lib2::make_format_args(42, "k", true));
+                lib2::test::assert_equal(str, "value k=42   | {} true");
+
+                str = lib2::vformat("{:>{}}|{:%H:%M}|{}", lib2::make_format_args("ab", 4, std::chrono::minutes{61}, std::chrono::seconds{45}));
+                lib2::test::assert_equal(str, "  ab|01:01|45s");
+
+                str = lib2::format("{:*^{}} {}", "mid", 7, std::chrono::milliseconds{5});
+                lib2::test::assert_equal(str, "**mid** 5ms");
+            }
+
+            // More strings than the cache holds, twice, to go through eviction
+            for (int pass {0}; pass < 2; ++pass)
+            {
+                for (int i {0}; i < 600; ++i)
+                {
+                    const auto fmt {lib2::format("{}:{{:>{}}}|", i, i % 7 + 1)};
+                    const auto str {lib2::vformat(fmt, lib2::make_format_args(i % 10))};
+                    lib2::test::assert_equal(str, lib2::format("{}:{:>{}}|", i, i % 10, i % 7 + 1));
+                }
+            }
+
+            for (int i {0}; i < 2; ++i)
+            {
+                lib2::test::assert_throws<lib2::format_error>([] {
+                    const std::string fmt {"{} {"};
+                    [[maybe_unused]] const auto str {lib2::vformat(fmt, lib2::make_format_args(1))};
+                });
+
+                lib2::test::assert_throws<lib2::format_error>([] {
+                    const std::string fmt {"{} {}"};
+                    [[maybe_unused]] const auto str {lib2::vformat(fmt, lib2::make_format_args(1))};
+                });
+            }
+        }
+    };
+}
\ No newline at end of file
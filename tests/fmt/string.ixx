@@ -29,6 +29,86 @@ namespace lib2::tests::fmt
         }
     };
 
+    export
+    class string_gather_fmt_test : public lib2::test::test_case
+    {
+    public:
+        string_gather_fmt_test()
+            : lib2::test::test_case{"string_gather_fmt"} {}
+
+        void operator()() final
+        {
+            const std::string_view name {"lib2"};
+            const std::string greeting {"Hello"};
+
+            const auto str1 {lib2::format<"{}, {}! {}\n">(greeting, name, "Bye")};
+            lib2::test::assert_equal(str1, "Hello, lib2! Bye\n");
+
+            const auto str2 {lib2::format<"{{{}}} This literal is long enough that it will be written through writev {}">(name, greeting)};
+            lib2::test::assert_equal(str2, "{lib2} This literal is long enough that it will be written through writev Hello");
+
+            lib2::ostringstream ss;
+            const std::string_view parts[] {"ab", "", "cde"};
+            const std::span<const std::byte> fragments[] {
+                std::as_bytes(std::span{parts[0]}),
+                std::as_bytes(std::span{parts[1]}),
+                std::as_bytes(std::span{parts[2]})
+            };
+            ss.writev(fragments);
+            lib2::test::assert_equal(ss.view(), "abcde");
+        }
+    };
+
+    export
+    class string_builder_fmt_test : public lib2::test::test_case
+    {
+    public:
+        string_builder_fmt_test()
+            : lib2::test::test_case{"string_builder_fmt"} {}
+
+        void operator()() final
+        {
+            // format goes through a string_builder, format_to into an
+            // ostringstream does not
+            const auto expected {[](const auto&... args) {
+                lib2::ostringstream ss;
+                lib2::format_to<"{} {:>5} {}|">(ss, args...);
+                return std::move(ss).str();
+            }};
+
+            // Fits the inline buffer
+            lib2::test::assert_equal(lib2::format<"{} {:>5} {}|">("ab", 42, 1.5), expected("ab", 42, 1.5));
+            lib2::test::assert_equal(lib2::format("{} {:>5} {}|", "ab", 42, 1.5), expected("ab", 42, 1.5));
+            lib2::test::assert_equal(lib2::vformat("{} {:>5} {}|", lib2::make_format_args("ab", 42, 1.5)), expected("ab", 42, 1.5));
+
+            // Outgrows it
+            const std::string long_str(2000, 'x');
+            lib2::test::assert_equal(lib2::format<"{} {:>5} {}|">(long_str, 42, 1.5), expected(long_str, 42, 1.5));
+            lib2::test::assert_equal(lib2::format("{} {:>5} {}|", long_str, 42, 1.5), expected(long_str, 42, 1.5));
+
+            // Expected to outgrow it, so written straight into the string
+            const auto long_literal {lib2::format<"{}"
+                "0123456789012345678901234567890123456789012345678901234567890123456789"
+                "0123456789012345678901234567890123456789012345678901234567890123456789"
+                "0123456789012345678901234567890123456789012345678901234567890123456789"
+                "0123456789012345678901234567890123456789012345678901234567890123456789"
+                "0123456789012345678901234567890123456789012345678901234567890123456789"
+                "0123456789012345678901234567890123456789012345678901234567890123456789"
+                "0123456789012345678901234567890123456789012345678901234567890123456789"
+                "0123456789012345678901234567890123456789012345678901234567890123456789"
+                "{}">(1, 2)};
+            std::string digits;
+            for (int i {0}; i < 56; ++i)
+            {
+                digits += "0123456789";
+            }
+            lib2::test::assert_equal(long_literal, "1" + digits + "2");
+
+            const auto with_alloc {lib2::format<"{} {:>5} {}|">(std::allocator_arg, std::allocator<char>{}, long_str, 42, 1.5)};
+            lib2::test::assert_equal(with_alloc, expected(long_str, 42, 1.5));
+        }
+    };
+
     export
     class string_unicode_fmt_test : public lib2::test::test_case
     {
@@ -84,4 +164,43 @@ namespace lib2::tests::fmt
             lib2::test::assert_equal(str, "\"Hello \\u1f600 world!\"");
         }
     };
+
+    export
+    class string_precision_fmt_test : public lib2::test::test_case
+    {
+    public:
+        string_precision_fmt_test()
+            : lib2::test::test_case{"string_precision_fmt"} {}
+
+        void operator()() final
+        {
+            std::string str {lib2::format<"{:.5}">(std::string_view{"Hello, world!"})};
+            lib2::test::assert_equal(str, "Hello");
+
+            str = lib2::format<"{:*^9.5}">(std::string_view{"Hello, world!"});
+            lib2::test::assert_equal(str, "**Hello**");
+
+            str = lib2::format<"{:.20}">(std::string_view{"Hello"});
+            lib2::test::assert_equal(str, "Hello");
+
+            str = lib2::format<"{:.7}|">(std::string_view{"Hello 😀 world!"});
+            lib2::test::assert_equal(str, "Hello 😀|");
+
+            str = lib2::format("{:<9.7}|", std::string_view{"Hello 😀 world!"});
+            lib2::test::assert_equal(str, "Hello 😀  |");
+
+            // ASCII up to the precision, but not after it
+            str = lib2::format<"{:.6}|">(std::string_view{"Hello 😀 world!"});
+            lib2::test::assert_equal(str, "Hello |");
+
+            str = lib2::format<"{:.20}|">(std::string_view{"Hello 😀"});
+            lib2::test::assert_equal(str, "Hello 😀|");
+
+            str = lib2::format<"{:>10?}">(std::string_view{"a\tb"});
+            lib2::test::assert_equal(str, "    \"a\\tb\"");
+
+            str = lib2::format<"{:<12.3?}|">(std::string_view{"Hi 😀"});
+            lib2::test::assert_equal(str, "\"Hi \"       |");
+        }
+    };
 }
\ No newline at end of file
@@ -29,6 +29,27 @@ namespace lib2::tests::io
         static constexpr auto wwrite_test_name {L"wwrite_test.txt"};
     };
 
+    // Fixed-size ostream whose room is all known up front
+    class span_ostream final : public lib2::ostream
+    {
+    public:
+        explicit span_ostream(const std::span<std::byte> buf) noexcept
+        {
+            this->setp(buf.data(), buf.data() + buf.size());
+        }
+
+        [[nodiscard]] std::string_view view() const noexcept
+        {
+            return {reinterpret_cast<const char*>(this->pbeg()), this->amount_written()};
+        }
+    };
+
+    [[nodiscard]] std::string read_file(const char* const filename)
+    {
+        std::ifstream file {filename, std::ios::binary};
+        return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
     export
     class ofstream_default_constructor_test : public fstream_test
     {
@@ -70,4 +91,249 @@ namespace lib2::tests::io
             file.flush();
         }
     };
+
+    export
+    class ofstream_writev_test : public fstream_test
+    {
+    public:
+        ofstream_writev_test()
+            : fstream_test{"ofstream_writev"} {}
+
+        void operator()() final
+        {
+            constexpr auto filename {"writev_test.txt"};
+
+            // More fragments than one writev batch, with more in them than
+            // the buffer holds
+            std::vector<std::string> strings;
+            for (int i {0}; i < 40; ++i)
+            {
+                strings.emplace_back(static_cast<std::size_t>(i), static_cast<char>('a' + i % 26));
+            }
+
+            std::vector<std::span<const std::byte>> fragments;
+            for (const auto& str : strings)
+            {
+                fragments.emplace_back(reinterpret_cast<const std::byte*>(str.data()), str.size());
+            }
+
+            std::string expected {"head"};
+            for (const auto& str : strings)
+            {
+                expected += str;
+            }
+            expected += "tail";
+            expected += "end";
+
+            {
+                lib2::ofstream file {filename};
+                file.setbuf(nullptr, 64);
+
+                // Pending in the buffer, so it goes out ahead of the fragments
+                file.write(reinterpret_cast<const std::byte*>("head"), 4);
+                file.writev(fragments);
+
+                // Small enough to be buffered
+                const std::array<std::span<const std::byte>, 2> small {
+                    std::span{reinterpret_cast<const std::byte*>("tail"), 4},
+                    std::span{reinterpret_cast<const std::byte*>("end"), 3}
+                };
+                file.writev(small);
+            }
+
+            lib2::test::assert_equal(read_file(filename), expected);
+            std::filesystem::remove(filename);
+        }
+    };
+
+    export
+    class ifstream_read_direct_test : public fstream_test
+    {
+    public:
+        ifstream_read_direct_test()
+            : fstream_test{"ifstream_read_direct"} {}
+
+        void operator()() final
+        {
+            constexpr auto filename {"read_direct_test.txt"};
+            std::string contents;
+            for (int i {0}; i < 64; ++i)
+            {
+                contents.push_back(static_cast<char>('0' + i));
+            }
+            {
+                lib2::ofstream file {filename};
+                file.write(reinterpret_cast<const std::byte*>(contents.data()), contents.size());
+            }
+
+            {
+                lib2::ifstream file {filename};
+                file.setbuf(nullptr, 16);
+
+                // Larger than the buffer, with room in the ostream: read
+                // straight into it, with what follows going to the buffer
+                std::array<std::byte, 48> direct_buf;
+                span_ostream direct {direct_buf};
+                lib2::test::assert_equal(file.read(direct, 40), std::size_t{40});
+                lib2::test::assert_equal(direct.view(), std::string_view{contents}.substr(0, 40));
+
+                lib2::ostringstream rest;
+                lib2::test::assert_equal(file.read(rest, 100), std::size_t{24});
+                lib2::test::assert_equal(rest.view(), std::string_view{contents}.substr(40));
+
+                lib2::test::assert_equal(file.read(rest, 1), std::size_t{0});
+            }
+
+            std::filesystem::remove(filename);
+        }
+    };
+
+    export
+    class async_ofstream_write_test : public fstream_test
+    {
+    public:
+        async_ofstream_write_test()
+            : fstream_test{"async_ofstream_write"} {}
+
+        void operator()() final
+        {
+            constexpr auto filename {"async_write_test.txt"};
+            std::string expected;
+
+            // Opened exclusively unless truncating
+            std::filesystem::remove(filename);
+            {
+                lib2::async_ofstream file;
+                file.setbuf(4096);
+                file.open(filename);
+
+                // Enough small buffers to have many writes in flight
+                for (int i {0}; i < 2000; ++i)
+                {
+                    const auto line {"line " + std::to_string(i) + " of the async test\n"};
+                    file.write(reinterpret_cast<const std::byte*>(line.data()), line.size());
+                    expected += line;
+
+                    if (i % 500 == 0)
+                    {
+                        file.fill(std::byte{'-'}, 10000);
+                        expected.append(10000, '-');
+                    }
+                }
+
+                file.flush();
+                lib2::test::assert_equal(read_file(filename), expected);
+
+                const std::string_view tail {"tail\n"};
+                file.write(reinterpret_cast<const std::byte*>(tail.data()), tail.size());
+                expected += tail;
+            }
+
+            lib2::test::assert_equal(read_file(filename), expected);
+            std::filesystem::remove(filename);
+        }
+    };
+
+    export
+    class async_ofstream_setbuf_test : public fstream_test
+    {
+    public:
+        async_ofstream_setbuf_test()
+            : fstream_test{"async_ofstream_setbuf"} {}
+
+        void operator()() final
+        {
+            constexpr auto filename {"async_setbuf_test.txt"};
+            std::string expected;
+
+            std::filesystem::remove(filename);
+            {
+                lib2::async_ofstream file;
+                file.open(filename);
+
+                // Growing the buffer leaves the smaller ones behind; more
+                // rounds than there are fixed buffer slots
+                for (std::size_t i {0}; i < 200; ++i)
+                {
+                    file.setbuf(1024 + i * 64);
+                    for (int j {0}; j < 50; ++j)
+                    {
+                        const auto line {"buffer " + std::to_string(i) + " line " + std::to_string(j) + "\n"};
+                        file.write(reinterpret_cast<const std::byte*>(line.data()), line.size());
+                        expected += line;
+                    }
+                }
+            }
+
+            lib2::test::assert_equal(read_file(filename), expected);
+            std::filesystem::remove(filename);
+        }
+    };
+
+    export
+    class mmap_istream_read_test : public fstream_test
+    {
+    public:
+        mmap_istream_read_test()
+            : fstream_test{"mmap_istream_read"} {}
+
+        void operator()() final
+        {
+            std::ifstream expected_file {read_test_name, std::ios::binary};
+            const std::string expected {std::istreambuf_iterator<char>{expected_file}, std::istreambuf_iterator<char>{}};
+
+            lib2::mmap_istream file {read_test_name, lib2::mmap_hint::sequential | lib2::mmap_hint::willneed};
+            lib2::test::assert_equal(file.size(), expected.size());
+
+            std::string contents;
+            file.consume([&](const auto beg, const auto end) {
+                contents.append(reinterpret_cast<const char*>(beg), end - beg);
+                return end;
+            });
+            lib2::test::assert_equal(contents, expected);
+            lib2::test::assert_false(file.get());
+
+            file.seek(0, lib2::seek_mode::set);
+            lib2::test::assert_equal(*file.get(), std::byte(expected.front()));
+        }
+    };
+
+    export
+    class mmap_istream_window_test : public fstream_test
+    {
+    public:
+        mmap_istream_window_test()
+            : fstream_test{"mmap_istream_window"} {}
+
+        void operator()() final
+        {
+            std::ifstream expected_file {read_test_name, std::ios::binary};
+            const std::string expected {std::istreambuf_iterator<char>{expected_file}, std::istreambuf_iterator<char>{}};
+
+            lib2::mmap_istream file {read_test_name, lib2::mmap_hint::none, 1};
+            lib2::ostringstream ss;
+            lib2::test::assert_equal(file.read(ss, expected.size() + 1), expected.size());
+            lib2::test::assert_equal(ss.view(), expected);
+
+            file.seek(-1, lib2::seek_mode::end);
+            lib2::test::assert_equal(*file.bump(), std::byte(expected.back()));
+            lib2::test::assert_false(file.get());
+        }
+    };
+
+    export
+    class mmap_istream_empty_test : public fstream_test
+    {
+    public:
+        mmap_istream_empty_test()
+            : fstream_test{"mmap_istream_empty"} {}
+
+        void operator()() final
+        {
+            lib2::mmap_istream file {read_test_empty_name};
+            lib2::test::assert_true(file.is_open());
+            lib2::test::assert_equal(file.size(), std::uint64_t{0});
+            lib2::test::assert_false(file.get());
+        }
+    };
 }
\ No newline at end of file
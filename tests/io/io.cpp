@@ -5,9 +5,11 @@ import std;
 import lib2;
 
 import :stringstream;
+import :string_builder;
 import :ostream;
 import :istream;
 import :fstream;
+import :syncstream;
 
 namespace lib2::tests::io
 {
@@ -19,6 +21,12 @@ namespace lib2::tests::io
         suite.add_test_case<stringstream_constructor_test>();
         suite.add_test_case<stringstream_read_test>();
         suite.add_test_case<stringstream_write_test>();
+        suite.add_test_case<ostringstream_clear_test>();
+
+        suite.add_test_case<string_builder_inline_test>();
+        suite.add_test_case<string_builder_growth_test>();
+        suite.add_test_case<string_builder_clear_test>();
+        suite.add_test_case<string_builder_move_test>();
 
         suite.add_test_case<ostream_char_test>();
         suite.add_test_case<ostream_string_literal_test>();
@@ -35,6 +43,17 @@ namespace lib2::tests::io
         suite.add_test_case<ofstream_default_constructor_test>();
         suite.add_test_case<ofstream_open_test>();
         suite.add_test_case<ofstream_write_test>();
+        suite.add_test_case<ofstream_writev_test>();
+        suite.add_test_case<ifstream_read_direct_test>();
+        suite.add_test_case<async_ofstream_write_test>();
+        suite.add_test_case<async_ofstream_setbuf_test>();
+
+        suite.add_test_case<mmap_istream_read_test>();
+        suite.add_test_case<mmap_istream_window_test>();
+        suite.add_test_case<mmap_istream_empty_test>();
+
+        suite.add_test_case<sync_ostream_threads_test>();
+        suite.add_test_case<sync_ostream_local_test>();
 
         return std::move(suite);
     }
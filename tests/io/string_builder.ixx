@@ -0,0 +1,113 @@
+export module lib2.tests.io:string_builder;
+
+import std;
+
+import lib2;
+
+namespace lib2::tests::io
+{
+    export
+    class string_builder_inline_test : public lib2::test::test_case
+    {
+    public:
+        string_builder_inline_test()
+            : lib2::test::test_case{"string_builder_inline"} {}
+
+        void operator()() final
+        {
+            lib2::basic_string_builder<16> sb;
+            lib2::test::assert_true(sb.empty());
+            lib2::test::assert_equal(sb.capacity(), 16uz);
+
+            sb.write(std::string_view{"0123456789"});
+            sb.fill('x', 6);
+            lib2::test::assert_equal(sb.view(), "0123456789xxxxxx");
+            lib2::test::assert_equal(sb.capacity(), 16uz);
+
+            // One past the inline buffer moves it to the heap
+            sb.put('!');
+            lib2::test::assert_equal(sb.view(), "0123456789xxxxxx!");
+            lib2::test::assert_greater(sb.capacity(), 16uz);
+            lib2::test::assert_equal(sb.str(), std::string{"0123456789xxxxxx!"});
+        }
+    };
+
+    export
+    class string_builder_growth_test : public lib2::test::test_case
+    {
+    public:
+        string_builder_growth_test()
+            : lib2::test::test_case{"string_builder_growth"} {}
+
+        void operator()() final
+        {
+            lib2::test::assert_equal(lib2::growth_policy{}.next_capacity(100, 101), 200uz);
+            lib2::test::assert_equal(lib2::growth_policy{}.next_capacity(100, 500), 500uz);
+            lib2::test::assert_equal((lib2::growth_policy{3, 2}.next_capacity(100, 101)), 150uz);
+
+            lib2::basic_string_builder<8> sb {lib2::growth_policy{3, 2}};
+            sb.write(std::string_view{"12345678"});
+            sb.put('9');
+            lib2::test::assert_equal(sb.capacity(), 12uz);
+
+            std::string expected {"123456789"};
+            for (auto i {0}; i < 1000; ++i)
+            {
+                lib2::format_to<"{},">(sb, i);
+                expected += std::to_string(i) + ',';
+            }
+            lib2::test::assert_equal(sb.view(), expected);
+        }
+    };
+
+    export
+    class string_builder_clear_test : public lib2::test::test_case
+    {
+    public:
+        string_builder_clear_test()
+            : lib2::test::test_case{"string_builder_clear"} {}
+
+        void operator()() final
+        {
+            lib2::string_builder sb;
+            sb.reserve(4096);
+            lib2::test::assert_equal(sb.capacity(), 4096uz);
+
+            const auto* const data {sb.data()};
+            for (auto i {0}; i < 10; ++i)
+            {
+                sb.clear();
+                sb.fill('a', 4000);
+                lib2::test::assert_equal(sb.size(), 4000uz);
+                lib2::test::assert_equal(sb.data(), data);
+            }
+            lib2::test::assert_equal(sb.capacity(), 4096uz);
+        }
+    };
+
+    export
+    class string_builder_move_test : public lib2::test::test_case
+    {
+    public:
+        string_builder_move_test()
+            : lib2::test::test_case{"string_builder_move"} {}
+
+        void operator()() final
+        {
+            lib2::basic_string_builder<8> small;
+            small.write(std::string_view{"inline"});
+            const lib2::basic_string_builder<8> small_moved {std::move(small)};
+            lib2::test::assert_equal(small_moved.view(), "inline");
+            lib2::test::assert_true(small.empty());
+
+            lib2::basic_string_builder<8> large;
+            large.write(std::string_view{"on the heap"});
+            const auto* const data {large.data()};
+            const lib2::basic_string_builder<8> large_moved {std::move(large)};
+            lib2::test::assert_equal(large_moved.view(), "on the heap");
+            lib2::test::assert_equal(large_moved.data(), data);
+            lib2::test::assert_true(large.empty());
+            lib2::test::assert_equal(large.capacity(), 8uz);
+        }
+    };
+}
\ No newline at end of file
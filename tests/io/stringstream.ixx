@@ -119,4 +119,26 @@ namespace lib2::tests::io
             lib2::test::assert_equal(ss.view(), "Hello This is hopefully a long message");
         }
     };
+
+    export
+    class ostringstream_clear_test : public lib2::test::test_case
+    {
+    public:
+        ostringstream_clear_test()
+            : lib2::test::test_case{"ostringstream_clear"} {}
+
+        void operator()() final
+        {
+            lib2::ostringstream ss;
+            ss.write(std::string_view{"A message long enough to be on the heap"});
+
+            const auto* const data {ss.view().data()};
+            ss.clear();
+            lib2::test::assert_true(ss.view().empty());
+
+            ss.write(std::string_view{"Reused"});
+            lib2::test::assert_equal(ss.view(), "Reused");
+            lib2::test::assert_equal(ss.view().data(), data);
+        }
+    };
 }
\ No newline at end of file
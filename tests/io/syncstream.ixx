@@ -0,0 +1,139 @@
+export module lib2.tests.io:syncstream;
+
+import std;
+import lib2;
+
+namespace lib2::tests::io
+{
+    export
+    class sync_ostream_threads_test : public lib2::test::test_case
+    {
+    public:
+        sync_ostream_threads_test()
+            : lib2::test::test_case{"sync_ostream_threads"} {}
+
+        void operator()() final
+        {
+            constexpr std::size_t num_threads {4};
+            constexpr std::size_t num_lines {1000};
+
+            lib2::ostringstream sink;
+            {
+                lib2::sync_ostream out {sink};
+                {
+                    std::vector<std::jthread> threads;
+                    for (std::size_t t {0}; t < num_threads; ++t)
+                    {
+                        threads.emplace_back([&out, t] {
+                            for (std::size_t i {0}; i < num_lines; ++i)
+                            {
+                                lib2::format_to<"thread {} line {}\n">(out, t, i);
+                            }
+                        });
+                    }
+                }
+                out.flush();
+            }
+
+            std::array<std::size_t, num_threads> next_line {};
+            std::size_t total_lines {0};
+            for (const auto line : std::views::split(sink.view(), '\n'))
+            {
+                const std::string_view str {line.begin(), line.end()};
+                if (str.empty())
+                {
+                    continue;
+                }
+
+                std::size_t t;
+                std::size_t i;
+                const auto matched {std::sscanf(std::string{str}.c_str(), "thread %zu line %zu", &t, &i)};
+                lib2::test::assert_equal(matched, 2, str);
+                lib2::test::assert_true(t < num_threads, str);
+
+                // Each thread's records must arrive whole and in order
+                lib2::test::assert_equal(i, next_line[t], str);
+                ++next_line[t];
+                ++total_lines;
+            }
+
+            lib2::test::assert_equal(total_lines, num_threads * num_lines);
+        }
+    };
+
+    export
+    class sync_ostream_local_test : public lib2::test::test_case
+    {
+        // Counts flushes of the underlying ostringstream
+        class counting_ostream final : public lib2::ostream
+        {
+        public:
+            lib2::ostringstream buf;
+            std::size_t flushes {0};
+
+            void write(const std::byte* const s, const size_type count) override
+            {
+                buf.write(s, count);
+            }
+
+            void flush() override
+            {
+                ++flushes;
+            }
+        };
+    public:
+        sync_ostream_local_test()
+            : lib2::test::test_case{"sync_ostream_local"} {}
+
+        void operator()() final
+        {
+            counting_ostream sink;
+            {
+                lib2::sync_ostream out {sink};
+                auto& local {out.local()};
+                for (const char c : std::string_view{"abc"})
+                {
+                    local.put(static_cast<std::byte>(c));
+                }
+
+                // Not committed until the newline
+                lib2::test::assert_true(sink.buf.view().empty());
+                lib2::format_to<"{}\n">(local, 1);
+                lib2::test::assert_equal(sink.buf.view(), "abc1\n");
+
+                local.put(std::byte{'2'});
+                local.put(std::byte{'\n'});
+                lib2::test::assert_equal(sink.buf.view(), "abc1\n2\n");
+
+                lib2::format_to<"x\n">(local);
+                lib2::test::assert_equal(sink.buf.view(), "abc1\n2\nx\n");
+
+                // Longer than one record
+                const std::string line(3000, 'x');
+                lib2::format_to<"{}\n">(local, line);
+                lib2::test::assert_equal(sink.buf.view().size(), 9 + line.size() + 1);
+
+                // Newlines put through the ostream interface are found once
+                // the record fills up
+                lib2::ostream& base {local};
+                const auto before {sink.buf.view().size()};
+                for (std::size_t i {0}; i < 1000; ++i)
+                {
+                    base.put(std::byte{'y'});
+                    base.put(std::byte{'\n'});
+                }
+                lib2::test::assert_true(sink.buf.view().size() > before);
+                lib2::test::assert_true(sink.buf.view().ends_with("y\n"));
+                local.commit();
+                lib2::test::assert_equal(sink.buf.view().size(), before + 2000);
+
+                lib2::test::assert_equal(sink.flushes, 0);
+
+                lib2::format_to<"tail">(out);
+                out.flush();
+                lib2::test::assert_equal(sink.flushes, 1);
+                lib2::test::assert_true(sink.buf.view().ends_with("xx\ntail"));
+            }
+        }
+    };
+}
\ No newline at end of file
@@ -4,60 +4,157 @@ import lib2;
 
 import lib2.tests.type_traits;
 import lib2.tests.compact_optional;
+import lib2.tests.memory;
 import lib2.tests.strings;
 import lib2.tests.io;
 import lib2.tests.fmt;
+import lib2.tests.scan;
 import lib2.tests.meta;
+import lib2.tests.log;
+import lib2.tests.benchmarking;
+import lib2.tests.test;
 
 constexpr std::string_view usage() noexcept
 {
-    return "usage: [-l] [<test_name>]\n"
-    "-l: Lists test names\n"
-    "<test_name>: Name of test to run\n";
+    return "usage: [-l] [<test_name>] [options]\n"
+    "-l: Lists the names of the selected tests\n"
+    "<test_name>: Name of a single test to run\n"
+    "Without a test name, the selected tests all run in this process:\n"
+    "--filter <glob>: Runs tests matching any filter, may repeat\n"
+    "--exclude <glob>: Skips tests matching any exclusion, may repeat\n"
+    "--shard <i>/<n>: Runs the i'th of n shards of the selected tests\n"
+    "--jobs <n>: Number of threads, defaults to the hardware threads\n"
+    "--timeout <ms>: Fails tests that run for longer\n"
+    "--durations: Lists every test by time taken\n";
+}
+
+template<class T>
+static bool parse_number(const std::string_view str, T& value) noexcept
+{
+    const auto [ptr, ec] {std::from_chars(str.data(), str.data() + str.size(), value)};
+    return ec == std::errc{} && ptr == str.data() + str.size();
+}
+
+static void print_failure(const lib2::test::test_case& test, const lib2::test::test_result& result)
+{
+    lib2::format_to<"{}:\n">(lib2::cerr, test.name());
+    result.on(lib2::overloaded{
+        [&](const lib2::test::assertion_failure& f) {
+            lib2::format_to<" {}\n">(lib2::cerr, f.message);
+        },
+        [&](const lib2::test::assert_exception& e) {
+            lib2::format_to<" {}\n">(lib2::cerr, e);
+        },
+        [&](const lib2::test::error_exception& e) {
+            lib2::format_to<" {}\n">(lib2::cerr, e);
+        },
+        [&](const std::exception& e) {
+            lib2::format_to<"  Uncaught exception ({}): {}\n">(lib2::cerr, typeid(e).name(), e);
+        }
+    });
+
+    if (result.num_failures() > result.failures().size())
+    {
+        lib2::format_to<" ...and {} more failures\n">(lib2::cerr, result.num_failures() - result.failures().size());
+    }
+}
+
+static double to_milliseconds(const std::chrono::nanoseconds duration) noexcept
+{
+    return std::chrono::duration<double, std::milli>{duration}.count();
 }
 
 int main(const int argc, char* const argv[])
 {
     std::string_view test_name;
     bool list {false};
+    bool durations {false};
+    lib2::test::test_run_options options;
 
     for (auto i {1}; i < argc; ++i)
     {
         const std::string_view arg {argv[i]};
+        const auto has_value {i + 1 < argc};
+
+        bool valid {true};
         if (arg == "-l")
         {
             list = true;
-            break;
         }
-        else if (test_name.empty())
+        else if (arg == "--durations")
+        {
+            durations = true;
+        }
+        else if (arg == "--filter" && has_value)
+        {
+            options.include.emplace_back(argv[++i]);
+        }
+        else if (arg == "--exclude" && has_value)
+        {
+            options.exclude.emplace_back(argv[++i]);
+        }
+        else if (arg == "--shard" && has_value)
+        {
+            const std::string_view shard {argv[++i]};
+            const auto slash {shard.find('/')};
+            valid = slash != std::string_view::npos &&
+                    parse_number(shard.substr(0, slash), options.shard_index) &&
+                    parse_number(shard.substr(slash + 1), options.shard_count) &&
+                    options.shard_index < options.shard_count;
+        }
+        else if (arg == "--jobs" && has_value)
+        {
+            valid = parse_number(argv[++i], options.num_threads);
+        }
+        else if (arg == "--timeout" && has_value)
+        {
+            std::chrono::milliseconds::rep timeout {};
+            valid = parse_number(argv[++i], timeout) && timeout >= 0;
+            options.timeout = std::chrono::milliseconds{timeout};
+        }
+        else if (test_name.empty() && !arg.starts_with("--"))
         {
             test_name = arg;
-            break;
         }
-    }
+        else
+        {
+            valid = false;
+        }
 
-    if (!list && test_name.empty())
-    {
-        lib2::format_to<"{}\nMust give a test name\n">(lib2::cerr, usage());
-        return 1;
+        if (!valid)
+        {
+            lib2::format_to<"{}\nInvalid argument: {}\n">(lib2::cerr, usage(), arg);
+            return 1;
+        }
     }
 
     lib2::test::test_suite tests;
     tests.add_test_suite(lib2::tests::type_traits::get_tests());
     tests.add_test_suite(lib2::tests::compact_optional::get_tests());
+    tests.add_test_suite(lib2::tests::memory::get_tests());
     tests.add_test_suite(lib2::tests::strings::get_tests());
     tests.add_test_suite(lib2::tests::io::get_tests());
     tests.add_test_suite(lib2::tests::fmt::get_tests());
+    tests.add_test_suite(lib2::tests::scan::get_tests());
     tests.add_test_suite(lib2::tests::meta::get_tests());
+    tests.add_test_suite(lib2::tests::log::get_tests());
+    tests.add_test_suite(lib2::tests::benchmarking::get_tests());
+    tests.add_test_suite(lib2::tests::test::get_tests());
 
     if (list)
     {
-        for (const auto& test : tests)
+        std::vector<lib2::test::test_case*> all;
+        for (auto& test : tests)
+        {
+            all.push_back(&test);
+        }
+
+        for (const auto* test : lib2::test::select_tests(all, options))
         {
-            lib2::print<"{}\n">(test.name());
+            lib2::print<"{}\n">(test->name());
         }
     }
-    else
+    else if (!test_name.empty())
     {
         bool found {false};
         for (auto& test : tests)
@@ -67,18 +164,7 @@ int main(const int argc, char* const argv[])
                 const auto result {test.run()};
                 if (result.failed())
                 {
-                    lib2::format_to<"{}:\n">(lib2::cerr, test.name());
-                    result.on(lib2::overloaded{
-                        [&](const lib2::test::assert_exception& e) {
-                            lib2::format_to<" {}\n">(lib2::cerr, e);
-                        },
-                        [&](const lib2::test::error_exception& e) {
-                            lib2::format_to<" {}\n">(lib2::cerr, e);
-                        },
-                        [&](const std::exception& e) {
-                            lib2::format_to<"  Uncaught exception ({}): {}\n">(lib2::cerr, typeid(e).name(), e);
-                        }
-                    });
+                    print_failure(test, result);
                     return 1;
                 }
                 found = true;
@@ -92,4 +178,45 @@ int main(const int argc, char* const argv[])
             return 1;
         }
     }
+    else
+    {
+        auto summary {tests.run(options)};
+
+        for (const auto& run : summary.runs)
+        {
+            if (run.timed_out)
+            {
+                lib2::format_to<"{}:\n Timed out after {:.1f}ms\n">(lib2::cerr, run.test->name(), to_milliseconds(run.duration));
+            }
+            else if (run.result.failed())
+            {
+                print_failure(*run.test, run.result);
+            }
+        }
+
+        if (durations)
+        {
+            std::ranges::sort(summary.runs, std::ranges::greater{}, &lib2::test::test_run::duration);
+            for (const auto& run : summary.runs)
+            {
+                lib2::print<"{:>10.3f}ms {}\n">(to_milliseconds(run.duration), run.test->name());
+            }
+        }
+
+        const auto num_failed {summary.num_failed()};
+        lib2::print<"{} tests, {} passed, {} failed ({} timed out) in {:.1f}ms\n">(
+            summary.runs.size(), summary.runs.size() - num_failed, num_failed, summary.num_timed_out(), to_milliseconds(summary.wall_time)
+        );
+
+        if (summary.num_timed_out() != 0)
+        {
+            // Timed out tests are still running on abandoned threads, so
+            // the test cases cannot be destroyed
+            lib2::cout.flush();
+            lib2::cerr.flush();
+            std::quick_exit(1);
+        }
+
+        return summary.passed() ? 0 : 1;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,22 @@
+module lib2.tests.log;
+
+import std;
+import lib2;
+
+import :logger;
+
+namespace lib2::tests::log
+{
+    lib2::test::test_suite get_tests()
+    {
+        lib2::test::test_suite suite{"log library tests"};
+        suite.add_test_case<async_logger_format_test>();
+        suite.add_test_case<async_logger_strings_test>();
+        suite.add_test_case<async_logger_wrap_test>();
+        suite.add_test_case<async_logger_threads_test>();
+        suite.add_test_case<async_logger_sequential_test>();
+        suite.add_test_case<async_logger_idle_test>();
+
+        return std::move(suite);
+    }
+}
\ No newline at end of file
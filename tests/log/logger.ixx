@@ -0,0 +1,200 @@
+export module lib2.tests.log:logger;
+
+import std;
+import lib2;
+
+namespace lib2::tests::log
+{
+    export
+    class async_logger_format_test final : public lib2::test::test_case
+    {
+    public:
+        async_logger_format_test()
+            : lib2::test::test_case{"async_logger_format"} {}
+
+        void operator()() final
+        {
+            lib2::ostringstream sink;
+            lib2::async_logger logger {sink};
+
+            logger.log<"{} + {} = {}\n">(1, 2, 3);
+            logger.log<"{:>5}|{:<5}|\n">(42, 'x');
+            logger.log<"{:.2f}\n">(1.5);
+            logger.flush();
+
+            lib2::test::assert_equal(sink.view(), "1 + 2 = 3\n   42|x    |\n1.50\n");
+        }
+    };
+
+    export
+    class async_logger_strings_test final : public lib2::test::test_case
+    {
+    public:
+        async_logger_strings_test()
+            : lib2::test::test_case{"async_logger_strings"} {}
+
+        void operator()() final
+        {
+            lib2::ostringstream sink;
+            lib2::async_logger logger {sink};
+
+            // The logger must copy the characters, not the pointers
+            {
+                std::string str {"a string that is too long for the small buffer"};
+                const char* const ptr {"pointer"};
+                logger.log<"{} {} {} {}\n">(str, std::string_view{str}.substr(2, 6), ptr, "literal");
+                str.assign(str.size(), '!');
+            }
+            logger.flush();
+
+            lib2::test::assert_equal(sink.view(), "a string that is too long for the small buffer string pointer literal\n");
+        }
+    };
+
+    export
+    class async_logger_wrap_test final : public lib2::test::test_case
+    {
+    public:
+        async_logger_wrap_test()
+            : lib2::test::test_case{"async_logger_wrap"} {}
+
+        void operator()() final
+        {
+            constexpr std::size_t num_lines {10000};
+
+            lib2::ostringstream sink;
+            std::string expected;
+            {
+                // Small enough that the queue wraps and fills many times
+                lib2::async_logger logger {sink, 4096};
+                const std::string padding(100, '-');
+                for (std::size_t i {0}; i < num_lines; ++i)
+                {
+                    logger.log<"{} {}\n">(i, padding);
+                    expected += lib2::format<"{} {}\n">(i, padding);
+                }
+            }
+
+            lib2::test::assert_equal(sink.view(), expected);
+        }
+    };
+
+    export
+    class async_logger_threads_test final : public lib2::test::test_case
+    {
+    public:
+        async_logger_threads_test()
+            : lib2::test::test_case{"async_logger_threads"} {}
+
+        void operator()() final
+        {
+            constexpr std::size_t num_threads {4};
+            constexpr std::size_t num_lines {1000};
+
+            lib2::ostringstream sink;
+            {
+                lib2::async_logger logger {sink, 4096};
+                std::vector<std::jthread> threads;
+                for (std::size_t t {0}; t < num_threads; ++t)
+                {
+                    threads.emplace_back([&logger, t] {
+                        for (std::size_t i {0}; i < num_lines; ++i)
+                        {
+                            logger.log<"thread {} line {}\n">(t, i);
+                        }
+                    });
+                }
+            }
+
+            std::array<std::size_t, num_threads> next_line {};
+            std::size_t total_lines {0};
+            for (const auto line : std::views::split(sink.view(), '\n'))
+            {
+                const std::string_view str {line.begin(), line.end()};
+                if (str.empty())
+                {
+                    continue;
+                }
+
+                std::size_t t;
+                std::size_t i;
+                const auto matched {std::sscanf(std::string{str}.c_str(), "thread %zu line %zu", &t, &i)};
+                lib2::test::assert_equal(matched, 2, str);
+                lib2::test::assert_true(t < num_threads, str);
+                lib2::test::assert_equal(i, next_line[t], str);
+                ++next_line[t];
+                ++total_lines;
+            }
+
+            lib2::test::assert_equal(total_lines, num_threads * num_lines);
+        }
+    };
+
+    export
+    class async_logger_sequential_test final : public lib2::test::test_case
+    {
+    public:
+        async_logger_sequential_test()
+            : lib2::test::test_case{"async_logger_sequential"} {}
+
+        void operator()() final
+        {
+            // Each logger's queue is dropped by this thread when it
+            // registers with the next one
+            for (int i {0}; i < 16; ++i)
+            {
+                lib2::ostringstream sink;
+                {
+                    lib2::async_logger logger {sink};
+                    logger.log<"logger {}\n">(i);
+                }
+                lib2::test::assert_equal(sink.view(), lib2::format("logger {}\n", i));
+            }
+        }
+    };
+
+    export
+    class async_logger_idle_test final : public lib2::test::test_case
+    {
+    public:
+        async_logger_idle_test()
+            : lib2::test::test_case{"async_logger_idle"} {}
+
+        void operator()() final
+        {
+            // The backend flushes the sink whenever it runs out of work
+            class flush_counting_ostream final : public lib2::ostringstream
+            {
+            public:
+                std::atomic<int> flushes {0};
+
+                void flush() override
+                {
+                    flushes.fetch_add(1, std::memory_order_release);
+                }
+            };
+
+            flush_counting_ostream sink;
+            lib2::async_logger logger {sink};
+
+            logger.log<"first\n">();
+            logger.flush();
+
+            // Long enough for the backend to stop polling and block; a
+            // record logged now has to wake it up without a flush()
+            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+            const auto flushes {sink.flushes.load(std::memory_order_acquire)};
+            logger.log<"second\n">();
+
+            const auto deadline {std::chrono::steady_clock::now() + std::chrono::seconds{10}};
+            while (sink.flushes.load(std::memory_order_acquire) == flushes && std::chrono::steady_clock::now() < deadline)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+            lib2::test::assert_true(sink.flushes.load(std::memory_order_acquire) != flushes);
+
+            logger.flush();
+            lib2::test::assert_equal(sink.view(), "first\nsecond\n");
+        }
+    };
+}
\ No newline at end of file
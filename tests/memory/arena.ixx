@@ -0,0 +1,257 @@
+export module lib2.tests.memory:arena;
+
+import std;
+import lib2;
+
+namespace lib2::tests::memory
+{
+    // Counts what reaches upstream, to check what the arenas keep to
+    // themselves
+    class counting_resource final : public std::pmr::memory_resource
+    {
+    public:
+        std::size_t allocations {0};
+        std::size_t deallocations {0};
+    private:
+        void* do_allocate(const std::size_t bytes, const std::size_t alignment) override
+        {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* const p, const std::size_t bytes, const std::size_t alignment) override
+        {
+            ++deallocations;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    export
+    class monotonic_arena_reset_test final : public lib2::test::test_case
+    {
+    public:
+        monotonic_arena_reset_test()
+            : lib2::test::test_case{"monotonic_arena_reset"} {}
+
+        void operator()()
+        {
+            counting_resource upstream;
+            {
+                lib2::monotonic_arena arena {256, &upstream};
+
+                // Once reset has kept a block big enough for a round, later
+                // rounds do not go upstream at all
+                std::size_t last_round {0};
+                for (auto round {0}; round < 4; ++round)
+                {
+                    const auto before {upstream.allocations};
+                    std::vector<lib2::arena_string> strings;
+                    for (std::size_t i {0}; i < 100; ++i)
+                    {
+                        strings.emplace_back(i, 'x', &arena);
+                    }
+                    last_round = upstream.allocations - before;
+
+                    strings.clear();
+                    arena.reset();
+                }
+                lib2::test::assert_equal(last_round, 0uz);
+
+                // Freeing the newest allocation hands its space back
+                auto* const p1 {arena.allocate(32)};
+                arena.deallocate(p1, 32);
+                lib2::test::assert_equal(arena.allocate(32), p1);
+            }
+            lib2::test::assert_equal(upstream.allocations, upstream.deallocations);
+        }
+    };
+
+    export
+    class monotonic_arena_alignment_test final : public lib2::test::test_case
+    {
+    public:
+        monotonic_arena_alignment_test()
+            : lib2::test::test_case{"monotonic_arena_alignment"} {}
+
+        void operator()()
+        {
+            counting_resource upstream;
+            alignas(64) std::byte buffer[128];
+            lib2::monotonic_arena arena {buffer, &upstream};
+
+            lib2::test::assert_equal(arena.allocate(1, 1), static_cast<void*>(buffer));
+            for (const std::size_t alignment : {2uz, 8uz, 16uz, 64uz, 256uz})
+            {
+                const auto p {arena.allocate(40, alignment)};
+                lib2::test::assert_equal(reinterpret_cast<std::uintptr_t>(p) % alignment, 0uz);
+            }
+            lib2::test::assert_greater(upstream.allocations, 0uz);
+
+            // Back to the buffer, with nothing left upstream
+            arena.release();
+            lib2::test::assert_equal(upstream.allocations, upstream.deallocations);
+            lib2::test::assert_equal(arena.allocate(1, 1), static_cast<void*>(buffer));
+        }
+    };
+
+    export
+    class fixed_pool_test final : public lib2::test::test_case
+    {
+    public:
+        fixed_pool_test()
+            : lib2::test::test_case{"fixed_pool"} {}
+
+        void operator()()
+        {
+            counting_resource upstream;
+            {
+                lib2::fixed_pool pool {24, 16, &upstream};
+                lib2::test::assert_equal(pool.block_size() % alignof(std::max_align_t), 0uz);
+
+                std::vector<void*> blocks;
+                for (auto i {0}; i < 100; ++i)
+                {
+                    blocks.push_back(pool.allocate(20));
+                }
+                lib2::test::assert_equal(std::set<void*>{blocks.begin(), blocks.end()}.size(), blocks.size());
+                lib2::test::assert_equal(upstream.allocations, 7uz);
+
+                for (auto* const block : blocks)
+                {
+                    pool.deallocate(block, 20);
+                }
+
+                // Freed blocks are reused before any new chunk
+                auto* const again {pool.allocate(8)};
+                lib2::test::assert_in(again, blocks);
+                pool.deallocate(again, 8);
+
+                // Too large for a block
+                auto* const large {pool.allocate(1000)};
+                lib2::test::assert_equal(upstream.allocations, 8uz);
+                pool.deallocate(large, 1000);
+            }
+            lib2::test::assert_equal(upstream.allocations, upstream.deallocations);
+        }
+    };
+
+    export
+    class thread_caching_pool_test final : public lib2::test::test_case
+    {
+    public:
+        thread_caching_pool_test()
+            : lib2::test::test_case{"thread_caching_pool"} {}
+
+        void operator()()
+        {
+            lib2::thread_caching_pool pool;
+
+            // Each thread fills its blocks with its own id, so blocks handed
+            // to two threads at once would show up as overwritten
+            std::atomic<std::size_t> corrupted {0};
+            std::vector<std::jthread> threads;
+            for (char id {1}; id <= 4; ++id)
+            {
+                threads.emplace_back([&, id] {
+                    std::vector<lib2::arena_string> strings;
+                    for (std::size_t i {0}; i < 2000; ++i)
+                    {
+                        strings.emplace_back(i % 300, id, lib2::arena_allocator<char>{&pool});
+                        if (i % 3 == 0)
+                        {
+                            strings.erase(strings.begin() + static_cast<std::ptrdiff_t>(strings.size() / 2));
+                        }
+                    }
+
+                    for (const auto& str : strings)
+                    {
+                        if (std::ranges::count(str, id) != static_cast<std::ptrdiff_t>(str.size()))
+                        {
+                            ++corrupted;
+                        }
+                    }
+                });
+            }
+            threads.clear();
+
+            lib2::test::assert_equal(corrupted.load(), 0uz);
+
+            // Freed on another thread than the one it came from
+            lib2::arena_string str (1000, 'a', &pool);
+            std::jthread{[&] {
+                str = lib2::arena_string{&pool};
+            }}.join();
+            lib2::test::assert_true(str.empty());
+        }
+    };
+
+    export
+    class arena_allocator_strings_test final : public lib2::test::test_case
+    {
+    public:
+        arena_allocator_strings_test()
+            : lib2::test::test_case{"arena_allocator_strings"} {}
+
+        void operator()()
+        {
+            lib2::monotonic_arena arena;
+            const lib2::arena_allocator<char> alloc {&arena};
+
+            lib2::basic_ostringstream<lib2::arena_allocator<char>> out {alloc};
+            for (auto i {0}; i < 100; ++i)
+            {
+                out.write("0123456789");
+            }
+            // A copy of the contents is allocated like them
+            const auto snapshot {out.str()};
+            lib2::test::assert_equal(snapshot.size(), 1000uz);
+            lib2::test::assert_equal(snapshot.get_allocator().resource(), static_cast<std::pmr::memory_resource*>(&arena));
+
+            const auto written {std::move(out).str()};
+            lib2::test::assert_equal(written.size(), 1000uz);
+            lib2::test::assert_equal(written.get_allocator().resource(), static_cast<std::pmr::memory_resource*>(&arena));
+
+            // Unlike polymorphic_allocator, copies stay in the arena
+            const auto copy {written};
+            lib2::test::assert_equal(copy.get_allocator().resource(), static_cast<std::pmr::memory_resource*>(&arena));
+
+            lib2::basic_stringstream<lib2::arena_allocator<char>> io {alloc};
+            io.write("xyz", 3);
+            lib2::test::assert_equal(io.str().get_allocator().resource(), static_cast<std::pmr::memory_resource*>(&arena));
+
+            lib2::basic_istringstream<lib2::arena_allocator<char>> in {std::string_view{"abc"}, alloc};
+            lib2::test::assert_equal(in.view(), std::string_view{"abc"});
+
+            const lib2::basic_lazy_string<char, std::char_traits<char>, lib2::arena_allocator<char>> lazy {written};
+            const auto lazy_copy {lazy};
+            lib2::test::assert_equal(lazy_copy.view(), std::string_view{written});
+        }
+    };
+
+    export
+    class arena_format_test final : public lib2::test::test_case
+    {
+    public:
+        arena_format_test()
+            : lib2::test::test_case{"arena_format"} {}
+
+        void operator()()
+        {
+            lib2::monotonic_arena arena;
+            const lib2::arena_allocator<char> alloc {&arena};
+
+            const auto str {lib2::format<"{} and {:>5}">(std::allocator_arg, alloc, 42, "abc")};
+            lib2::test::assert_equal(str, std::string_view{"42 and   abc"});
+            lib2::test::assert_equal(str.get_allocator().resource(), static_cast<std::pmr::memory_resource*>(&arena));
+
+            const auto runtime {lib2::format(std::allocator_arg, alloc, "{}-{}", 1, 2.5)};
+            lib2::test::assert_equal(runtime, std::string_view{"1-2.5"});
+            lib2::test::assert_equal(runtime.get_allocator().resource(), static_cast<std::pmr::memory_resource*>(&arena));
+        }
+    };
+}
\ No newline at end of file
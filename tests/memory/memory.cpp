@@ -0,0 +1,22 @@
+module lib2.tests.memory;
+
+import std;
+import lib2;
+
+import :arena;
+
+namespace lib2::tests::memory
+{
+    lib2::test::test_suite get_tests()
+    {
+        lib2::test::test_suite suite{"memory library tests"};
+        suite.add_test_case<monotonic_arena_reset_test>();
+        suite.add_test_case<monotonic_arena_alignment_test>();
+        suite.add_test_case<fixed_pool_test>();
+        suite.add_test_case<thread_caching_pool_test>();
+        suite.add_test_case<arena_allocator_strings_test>();
+        suite.add_test_case<arena_format_test>();
+
+        return std::move(suite);
+    }
+}
\ No newline at end of file
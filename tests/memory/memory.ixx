@@ -0,0 +1,9 @@
+export module lib2.tests.memory;
+
+import lib2;
+
+namespace lib2::tests::memory
+{
+    export
+    lib2::test::test_suite get_tests();
+}
\ No newline at end of file
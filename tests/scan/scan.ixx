@@ -1,5 +1,7 @@
 export module lib2.tests.scan;
 
+import std;
+
 import lib2.test;
 import lib2.scan;
 
@@ -250,6 +252,162 @@ namespace lib2::tests::scan
         }
     };
 
+    export
+    class scan_int_test : public lib2::test::test_case
+    {
+    public:
+        scan_int_test()
+            : lib2::test::test_case{"scan_int_test"} {}
+
+        void operator()() final
+        {
+            constexpr std::string_view input {"  -123 +45,18446744073709551615 0000000000000000000000042"};
+            int a;
+            long long b;
+            std::uint64_t c;
+            std::uint8_t d;
+            const auto result {lib2::scan(input, "{} {},{} {}", a, b, c, d)};
+
+            lib2::test::assert_equal(result, input.end());
+            lib2::test::assert_equal(a, -123);
+            lib2::test::assert_equal(b, 45);
+            lib2::test::assert_equal(c, std::numeric_limits<std::uint64_t>::max());
+            lib2::test::assert_equal(d, 42);
+        }
+    };
+
+    // Values around the block sizes of the digit parser and the type limits
+    export
+    template<std::integral T>
+    class scan_int_range_test : public lib2::test::test_case
+    {
+    public:
+        using lib2::test::test_case::test_case;
+
+        void operator()() final
+        {
+            std::vector<T> values {0, 1, std::numeric_limits<T>::min(), std::numeric_limits<T>::max()};
+            for (std::uint64_t power {10}; power <= static_cast<std::uint64_t>(std::numeric_limits<T>::max()); power *= 10)
+            {
+                values.push_back(static_cast<T>(power - 1));
+                values.push_back(static_cast<T>(power));
+                if constexpr (std::signed_integral<T>)
+                {
+                    values.push_back(static_cast<T>(-static_cast<T>(power)));
+                }
+
+                if (power > std::numeric_limits<std::uint64_t>::max() / 10)
+                {
+                    break;
+                }
+            }
+
+            for (const auto v : values)
+            {
+                const auto input {std::to_string(v) + "x"};
+                T result;
+                const auto it {lib2::scan(input, "{}", result)};
+
+                lib2::test::assert_equal(result, v);
+                lib2::test::assert_equal(*it, 'x');
+            }
+        }
+    };
+
+    export
+    class scan_int_error_test : public lib2::test::test_case
+    {
+    public:
+        scan_int_error_test()
+            : lib2::test::test_case{"scan_int_error_test"} {}
+
+        void operator()() final
+        {
+            lib2::test::assert_throws<std::out_of_range>([] {
+                std::int32_t v;
+                const auto result {lib2::scan(std::string_view{"2147483648"}, "{}", v)};
+            });
+
+            lib2::test::assert_throws<std::out_of_range>([] {
+                std::uint64_t v;
+                const auto result {lib2::scan(std::string_view{"18446744073709551616"}, "{}", v)};
+            });
+
+            lib2::test::assert_throws<lib2::scan_pattern_not_matched>([] {
+                unsigned int v;
+                const auto result {lib2::scan(std::string_view{"-1"}, "{}", v)};
+            });
+
+            lib2::test::assert_throws<lib2::scan_pattern_not_matched>([] {
+                int v;
+                const auto result {lib2::scan(std::string_view{" abc"}, "{}", v)};
+            });
+        }
+    };
+
+    export
+    class scan_compiled_test : public lib2::test::test_case
+    {
+    public:
+        scan_compiled_test()
+            : lib2::test::test_case{"scan_compiled_test"} {}
+
+        void operator()() final
+        {
+            constexpr std::string_view input {"12:ab -7 \t x{y"};
+            int a;
+            std::string b;
+            long c;
+            char d;
+            const auto result {lib2::scan<"{}:{} {} {}{{y">(input, a, b, c, d)};
+
+            lib2::test::assert_equal(result, input.end());
+            lib2::test::assert_equal(a, 12);
+            lib2::test::assert_equal(b, "ab");
+            lib2::test::assert_equal(c, -7L);
+            lib2::test::assert_equal(d, 'x');
+
+            int e;
+            int f;
+            lib2::scan<"{1}-{0}">(std::string_view{"3-4"}, e, f);
+            lib2::test::assert_equal(e, 4);
+            lib2::test::assert_equal(f, 3);
+
+            constexpr std::string_view fixed {"abcd|e"};
+            std::string_view view;
+            const auto it {lib2::scan<"{:3c}d|">(fixed, view)};
+            lib2::test::assert_equal(view, "abc");
+            lib2::test::assert_equal(*it, 'e');
+        }
+    };
+
+    export
+    class scan_compiled_error_test : public lib2::test::test_case
+    {
+    public:
+        scan_compiled_error_test()
+            : lib2::test::test_case{"scan_compiled_error_test"} {}
+
+        void operator()() final
+        {
+            lib2::test::assert_throws<lib2::scan_pattern_not_matched>([] {
+                int v;
+                const auto result {lib2::scan<"{}x">(std::string_view{"5y"}, v)};
+            });
+
+            lib2::test::assert_throws<lib2::scan_pattern_not_matched>([] {
+                int v;
+                int w;
+                const auto result {lib2::scan<"{} {}">(std::string_view{"5"}, v, w)};
+            });
+
+            lib2::test::assert_throws<lib2::scan_pattern_not_matched>([] {
+                int v;
+                const auto result {lib2::scan<"Hello {}">(std::string_view{"Hello5"}, v)};
+            });
+        }
+    };
+
     export
     lib2::test::test_suite get_tests()
     {
@@ -268,6 +426,16 @@ namespace lib2::tests::scan
         suite.add_test_case<scan_string_view_test>();
         suite.add_test_case<scan_string_view_width_test>();
         suite.add_test_case<scan_string_view_noskipws_test>();
+        suite.add_test_case<scan_int_test>();
+        suite.add_test_case<scan_int_range_test<std::int8_t>>("scan_int8_test");
+        suite.add_test_case<scan_int_range_test<std::uint16_t>>("scan_uint16_test");
+        suite.add_test_case<scan_int_range_test<std::int32_t>>("scan_int32_test");
+        suite.add_test_case<scan_int_range_test<std::uint32_t>>("scan_uint32_test");
+        suite.add_test_case<scan_int_range_test<std::int64_t>>("scan_int64_test");
+        suite.add_test_case<scan_int_range_test<std::uint64_t>>("scan_uint64_test");
+        suite.add_test_case<scan_int_error_test>();
+        suite.add_test_case<scan_compiled_test>();
+        suite.add_test_case<scan_compiled_error_test>();
 
         return std::move(suite);
     }
@@ -227,4 +227,29 @@ namespace lib2::tests::strings
             }
         }
     };
+
+    export
+    class is_ascii_string final : public lib2::test::test_case
+    {
+    public:
+        is_ascii_string()
+            : lib2::test::test_case{"is_ascii_string"} {}
+
+        void operator()()
+        {
+            lib2::test::assert_true(lib2::is_ascii(std::string_view{}));
+
+            // A non-ASCII byte at every position, both in the word loop and
+            // in the tail
+            std::string str(21, 'a');
+            lib2::test::assert_true(lib2::is_ascii(str));
+            for (std::size_t i {0}; i < str.size(); ++i)
+            {
+                str[i] = '\xC3';
+                lib2::test::assert_false(lib2::is_ascii(str));
+                str[i] = '\x7F';
+            }
+            lib2::test::assert_true(lib2::is_ascii(str));
+        }
+    };
 }
\ No newline at end of file
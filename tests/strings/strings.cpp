@@ -5,6 +5,7 @@ import lib2;
 
 import :lazy_string;
 import :character;
+import :unicode;
 
 namespace lib2::tests::strings
 {
@@ -31,6 +32,14 @@ namespace lib2::tests::strings
         suite.add_test_case<ispunct_ascii>();
         suite.add_test_case<tolower_ascii>();
         suite.add_test_case<toupper_ascii>();
+        suite.add_test_case<is_ascii_string>();
+
+        suite.add_test_case<validate_utf8_test>();
+        suite.add_test_case<count_codepoints_test>();
+        suite.add_test_case<utf8_codepoint_view_test>();
+        suite.add_test_case<utf16_codepoint_view_test>();
+        suite.add_test_case<utf_transcode_test>();
+        suite.add_test_case<utf_transcode_error_test>();
 
         return std::move(suite);
     }
@@ -0,0 +1,276 @@
+export module lib2.tests.strings:unicode;
+
+import std;
+import lib2;
+
+namespace lib2::tests::strings
+{
+    // Strings with ASCII in front so that each sequence is seen at every
+    // position of a 32-byte block
+    template<class F>
+    void for_each_offset(const std::string_view str, F f)
+    {
+        for (std::size_t offset {0}; offset < 40; ++offset)
+        {
+            std::string padded(offset, 'a');
+            padded += str;
+            f(padded);
+        }
+    }
+
+    export
+    class validate_utf8_test final : public lib2::test::test_case
+    {
+    public:
+        // Checks every case at every alignment, so failures are recorded to
+        // show all the offsets that go wrong rather than only the first
+        validate_utf8_test()
+            : lib2::test::test_case{"validate_utf8", lib2::test::assertion_mode::recording} {}
+
+        void operator()()
+        {
+            constexpr std::pair<std::string_view, bool> cases[] {
+                {"", true},
+                {"h\xC3\xA9llo", true},
+                {"\xE2\x82\xAC", true},
+                {"\xEF\xBF\xBF", true},
+                {"\xF0\x9F\x98\x80", true},
+                {"\xF4\x8F\xBF\xBF", true},
+                {"\x80", false},
+                {"\xC0\xAF", false},
+                {"\xE0\x80\xAF", false},
+                {"\xF0\x80\x80\xAF", false},
+                {"\xED\xA0\x80", false},
+                {"\xF4\x90\x80\x80", false},
+                {"\xF8\x88\x80\x80\x80", false},
+                {"\xE2\x82", false},
+                {"\xC3", false},
+                {"\xC3\xA9\xA9", false}
+            };
+
+            for (const auto& [str, valid] : cases)
+            {
+                for_each_offset(str, [&](const std::string& padded) {
+                    lib2::test::assert_equal(lib2::validate_utf8(padded), valid);
+
+                    auto followed {padded};
+                    followed.append(40, 'b');
+                    lib2::test::assert_equal(lib2::validate_utf8(followed), valid);
+                });
+            }
+        }
+    };
+
+    export
+    class count_codepoints_test final : public lib2::test::test_case
+    {
+    public:
+        count_codepoints_test()
+            : lib2::test::test_case{"count_codepoints"} {}
+
+        void operator()()
+        {
+            lib2::test::assert_equal(lib2::count_codepoints(std::string_view{}), 0uz);
+            lib2::test::assert_equal(lib2::count_codepoints(std::string_view{"a\xE2\x82\xAC\xF0\x9F\x98\x80\xC3\xA9"}), 4uz);
+
+            std::string str;
+            for (std::size_t i {0}; i < 5000; ++i)
+            {
+                str += "\xE2\x82\xAC" "a";
+            }
+            lib2::test::assert_equal(lib2::count_codepoints(str), 10000uz);
+        }
+    };
+
+    export
+    class utf8_codepoint_view_test final : public lib2::test::test_case
+    {
+    public:
+        utf8_codepoint_view_test()
+            : lib2::test::test_case{"utf8_codepoint_view", lib2::test::assertion_mode::recording} {}
+
+        void operator()()
+        {
+            // Runs of ASCII longer than a block, broken by every length of
+            // sequence, and an invalid byte
+            constexpr std::string_view valid {
+                "ASCII that runs for longer than a block h\xC3\xA9llo, "
+                "then twenty more \xE2\x82\xAC\xF0\x9F\x98\x80 and seventeen more"
+            };
+            constexpr std::string_view invalid {"before the bad byte \xFF after the bad byte, to the end"};
+
+            for (const auto str : {valid, invalid})
+            {
+                for_each_offset(str, [&](const std::string& padded) {
+                    // The same bytes through a range that is not contiguous,
+                    // which decodes a byte at a time
+                    const std::list<char> bytes {padded.begin(), padded.end()};
+
+                    std::vector<std::pair<std::uint32_t, bool>> expected;
+                    const lib2::utf8_codepoint_view bytewise {std::views::all(bytes)};
+                    for (auto it {bytewise.begin()}; it != bytewise.end(); ++it)
+                    {
+                        expected.emplace_back(*it, it.invalid());
+                    }
+
+                    std::vector<std::pair<std::uint32_t, bool>> actual;
+                    lib2::utf8_codepoint_view view {std::string_view{padded}};
+                    for (auto it {view.begin()}; it != view.end(); ++it)
+                    {
+                        actual.emplace_back(*it, it.invalid());
+                    }
+
+                    lib2::test::assert_true(actual == expected);
+                    lib2::test::assert_equal(view.size(), expected.size());
+
+                    // Kept from the first call
+                    lib2::test::assert_equal(view.size(), expected.size());
+                });
+            }
+
+            const lib2::utf8_codepoint_view euro {std::string_view{"\xE2\x82\xAC"}};
+            lib2::test::assert_equal(*euro.begin(), std::uint32_t{0x20AC});
+            lib2::test::assert_equal(std::ranges::distance(euro), std::ptrdiff_t{1});
+        }
+    };
+
+    export
+    class utf16_codepoint_view_test final : public lib2::test::test_case
+    {
+    public:
+        utf16_codepoint_view_test()
+            : lib2::test::test_case{"utf16_codepoint_view", lib2::test::assertion_mode::recording} {}
+
+        void operator()()
+        {
+            // Runs of single units longer than a block, broken by a pair
+            // and by unpaired high and low surrogates
+            constexpr std::u16string_view cases[] {
+                u"Units that are not surrogates, h\u00E9llo \u20AC, then a pair \U0001F600 and more units",
+                u"an unpaired high surrogate \xD800 in the middle of a long run of units",
+                u"an unpaired low surrogate \xDC00 in the middle of a long run of units",
+                u"a high surrogate at the end \xD83D"
+            };
+
+            for (const auto str : cases)
+            {
+                for (std::size_t offset {0}; offset < 20; ++offset)
+                {
+                    std::u16string padded(offset, u'a');
+                    padded += str;
+
+                    // The same units through a range that is not contiguous,
+                    // which decodes a unit at a time
+                    const std::list<char16_t> units {padded.begin(), padded.end()};
+
+                    std::vector<std::pair<std::uint32_t, bool>> expected;
+                    const lib2::utf16_codepoint_view unitwise {std::views::all(units)};
+                    for (auto it {unitwise.begin()}; it != unitwise.end(); ++it)
+                    {
+                        expected.emplace_back(*it, it.invalid());
+                    }
+
+                    std::vector<std::pair<std::uint32_t, bool>> actual;
+                    const lib2::utf16_codepoint_view view {std::u16string_view{padded}};
+                    for (auto it {view.begin()}; it != view.end(); ++it)
+                    {
+                        actual.emplace_back(*it, it.invalid());
+                    }
+
+                    lib2::test::assert_true(actual == expected);
+                }
+            }
+
+            const lib2::utf16_codepoint_view pair {std::u16string_view{u"a\U0001F600b"}};
+            std::vector<std::uint32_t> codepoints;
+            for (auto it {pair.begin()}; it != pair.end(); ++it)
+            {
+                codepoints.push_back(*it);
+            }
+            lib2::test::assert_true(codepoints == std::vector<std::uint32_t>{'a', 0x1F600, 'b'});
+        }
+    };
+
+    export
+    class utf_transcode_test final : public lib2::test::test_case
+    {
+    public:
+        utf_transcode_test()
+            : lib2::test::test_case{"utf_transcode"} {}
+
+        void operator()()
+        {
+            std::mt19937 rng {42};
+            std::uniform_int_distribution<std::uint32_t> cp_dist {0, 0x10FFFF};
+
+            for (std::size_t n {0}; n < 200; ++n)
+            {
+                // Mostly ASCII with other code points mixed in, so both the
+                // block fast path and the fallback run
+                std::u16string utf16;
+                for (std::size_t i {0}; i < n; ++i)
+                {
+                    auto cp {cp_dist(rng)};
+                    if (rng() % 2 == 0)
+                    {
+                        cp &= 0x7F;
+                    }
+                    else if (cp >= 0xD800 && cp <= 0xDFFF)
+                    {
+                        cp = 0xFFFD;
+                    }
+
+                    if (cp <= 0xFFFF)
+                    {
+                        utf16 += static_cast<char16_t>(cp);
+                    }
+                    else
+                    {
+                        cp -= 0x10000;
+                        utf16 += static_cast<char16_t>(0xD800 + (cp >> 10));
+                        utf16 += static_cast<char16_t>(0xDC00 + (cp & 0x3FF));
+                    }
+                }
+
+                // A back_inserter takes the per-code point path
+                std::string expected;
+                lib2::utf16_to_utf8(utf16, std::back_inserter(expected));
+                lib2::test::assert_true(lib2::validate_utf8(expected));
+
+                std::string utf8(utf16.size() * 3, '\0');
+                const auto to_utf8 {lib2::utf16_to_utf8(utf16.data(), utf16.data() + utf16.size(), utf8.data())};
+                utf8.resize(static_cast<std::size_t>(to_utf8.out - utf8.data()));
+                lib2::test::assert_equal(utf8, expected);
+
+                std::u16string round_trip(utf8.size(), u'\0');
+                const auto to_utf16 {lib2::utf8_to_utf16(utf8, round_trip.data())};
+                round_trip.resize(static_cast<std::size_t>(to_utf16.out - round_trip.data()));
+                lib2::test::assert_true(round_trip == utf16);
+            }
+        }
+    };
+
+    export
+    class utf_transcode_error_test final : public lib2::test::test_case
+    {
+    public:
+        utf_transcode_error_test()
+            : lib2::test::test_case{"utf_transcode_error"} {}
+
+        void operator()()
+        {
+            for_each_offset("\xE2\x82", [](const std::string& str) {
+                lib2::test::assert_throws<std::invalid_argument>([&] {
+                    std::u16string out(str.size(), u'\0');
+                    lib2::utf8_to_utf16(str, out.data());
+                });
+            });
+
+            lib2::test::assert_throws<std::invalid_argument>([] {
+                const std::u16string str {u"abcdefgh\xDC00"};
+                std::string out(str.size() * 3, '\0');
+                lib2::utf16_to_utf8(str, out.data());
+            });
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+module lib2.tests.test;
+
+import std;
+import lib2;
+
+import :test_result;
+import :test_runner;
+
+namespace lib2::tests::test
+{
+    lib2::test::test_suite get_tests()
+    {
+        lib2::test::test_suite suite{"test library tests"};
+        suite.add_test_case<recording_mode_test>();
+        suite.add_test_case<max_recorded_failures_test>();
+        suite.add_test_case<failure_kind_test>();
+        suite.add_test_case<matches_pattern_test>();
+        suite.add_test_case<select_tests_test>();
+        suite.add_test_case<run_tests_timeout_test>();
+
+        return std::move(suite);
+    }
+}
\ No newline at end of file
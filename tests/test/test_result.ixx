@@ -0,0 +1,156 @@
+export module lib2.tests.test:test_result;
+
+import std;
+import lib2;
+
+namespace lib2::tests::test
+{
+    // Runs func as a test in the given assertion mode, so that tests can
+    // fail on purpose and the result be checked
+    class scripted_test final : public lib2::test::test_case
+    {
+    public:
+        scripted_test(const lib2::test::assertion_mode mode, std::function<void()> func)
+            : lib2::test::test_case{"scripted", mode}
+            , func{std::move(func)} {}
+
+        void operator()() final
+        {
+            func();
+        }
+    private:
+        std::function<void()> func;
+    };
+
+    export
+    class recording_mode_test : public lib2::test::test_case
+    {
+    public:
+        recording_mode_test()
+            : lib2::test::test_case{"recording_mode"} {}
+
+        void operator()() final
+        {
+            using kind = lib2::test::test_result::failure_kind;
+
+            bool finished {false};
+            scripted_test recording {lib2::test::assertion_mode::recording, [&] {
+                lib2::test::assert_equal(1, 2, "first");
+                lib2::test::assert_true(false, "second");
+                lib2::test::assert_equal(3, 3, "passes");
+                lib2::test::fail("third");
+                finished = true;
+            }};
+
+            const auto result {recording.run()};
+            lib2::test::assert_true(finished, "a recording test keeps going after a failure");
+            lib2::test::assert_true(result.failed());
+            lib2::test::assert_false(result.errored());
+            lib2::test::assert_true(result.thrown_kind() == kind::none);
+            lib2::test::assert_equal(result.num_failures(), std::size_t{3});
+            lib2::test::assert_equal(result.failures().size(), std::size_t{3});
+            lib2::test::assert_true(result.failures()[0].message.find("first") != std::string::npos, result.failures()[0].message);
+            lib2::test::assert_true(result.failures()[2].message.find("third") != std::string::npos, result.failures()[2].message);
+
+            // The same checks in throwing mode stop at the first failure
+            finished = false;
+            scripted_test throwing {lib2::test::assertion_mode::throwing, [&] {
+                lib2::test::assert_equal(1, 2, "first");
+                finished = true;
+            }};
+
+            const auto thrown {throwing.run()};
+            lib2::test::assert_false(finished);
+            lib2::test::assert_true(thrown.failed());
+            lib2::test::assert_true(thrown.thrown_kind() == kind::assertion);
+            lib2::test::assert_equal(thrown.num_failures(), std::size_t{0});
+
+            // An exception still ends a recording test, on top of what it
+            // recorded
+            scripted_test recording_error {lib2::test::assertion_mode::recording, [] {
+                lib2::test::fail("recorded");
+                lib2::test::error("thrown");
+            }};
+
+            const auto both {recording_error.run()};
+            lib2::test::assert_equal(both.num_failures(), std::size_t{1});
+            lib2::test::assert_true(both.thrown_kind() == kind::error);
+        }
+    };
+
+    export
+    class max_recorded_failures_test : public lib2::test::test_case
+    {
+    public:
+        max_recorded_failures_test()
+            : lib2::test::test_case{"max_recorded_failures"} {}
+
+        void operator()() final
+        {
+            constexpr auto max {lib2::test::test_result::max_recorded_failures};
+
+            scripted_test recording {lib2::test::assertion_mode::recording, [] {
+                for (std::size_t i {0}; i < max + 50; ++i)
+                {
+                    lib2::test::assert_equal(i, max + 50);
+                }
+            }};
+
+            const auto result {recording.run()};
+            lib2::test::assert_equal(result.failures().size(), max);
+            lib2::test::assert_equal(result.num_failures(), max + 50);
+            lib2::test::assert_true(result.failed());
+        }
+    };
+
+    export
+    class failure_kind_test : public lib2::test::test_case
+    {
+    public:
+        failure_kind_test()
+            : lib2::test::test_case{"failure_kind"} {}
+
+        void operator()() final
+        {
+            using kind = lib2::test::test_result::failure_kind;
+
+            const auto run {[](std::function<void()> func) {
+                return scripted_test{lib2::test::assertion_mode::throwing, std::move(func)}.run();
+            }};
+
+            const auto passed {run([] {})};
+            lib2::test::assert_true(passed.passed());
+            lib2::test::assert_false(passed.errored());
+            lib2::test::assert_true(passed.thrown_kind() == kind::none);
+
+            const auto asserted {run([] { throw lib2::test::assert_exception{"assert"}; })};
+            lib2::test::assert_true(asserted.failed());
+            lib2::test::assert_false(asserted.errored());
+            lib2::test::assert_true(asserted.thrown_kind() == kind::assertion);
+
+            const auto errored {run([] { lib2::test::error("error"); })};
+            lib2::test::assert_true(errored.failed());
+            lib2::test::assert_true(errored.errored());
+            lib2::test::assert_true(errored.thrown_kind() == kind::error);
+
+            const auto threw {run([] { throw std::out_of_range{"exception"}; })};
+            lib2::test::assert_true(threw.failed());
+            lib2::test::assert_true(threw.errored());
+            lib2::test::assert_true(threw.thrown_kind() == kind::exception);
+
+            // The exception is kept for reporting
+            std::string message;
+            threw.on(lib2::overloaded{
+                [&](const std::exception& e) { message = e.what(); }
+            });
+            lib2::test::assert_equal(message, std::string{"exception"});
+
+            // Classifying a caught exception by rethrowing it agrees
+            lib2::test::test_result rethrown;
+            rethrown.failure(std::make_exception_ptr(lib2::test::error_exception{"error"}));
+            lib2::test::assert_true(rethrown.thrown_kind() == kind::error);
+            rethrown.failure(nullptr);
+            lib2::test::assert_true(rethrown.passed());
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+export module lib2.tests.test:test_runner;
+
+import std;
+import lib2;
+
+namespace lib2::tests::test
+{
+    // Test cases for the runner to run, which do nothing but call func
+    class func_test final : public lib2::test::test_case
+    {
+    public:
+        func_test(std::string name, std::function<void()> func = {})
+            : lib2::test::test_case{std::move(name)}
+            , func{std::move(func)} {}
+
+        void operator()() final
+        {
+            if (func)
+            {
+                func();
+            }
+        }
+    private:
+        std::function<void()> func;
+    };
+
+    [[nodiscard]] std::vector<std::string> names_of(const std::span<lib2::test::test_case* const> tests)
+    {
+        std::vector<std::string> names;
+        for (const auto* const test : tests)
+        {
+            names.push_back(test->name());
+        }
+        return names;
+    }
+
+    export
+    class matches_pattern_test : public lib2::test::test_case
+    {
+    public:
+        matches_pattern_test()
+            : lib2::test::test_case{"matches_pattern"} {}
+
+        void operator()() final
+        {
+            using lib2::test::matches_pattern;
+
+            lib2::test::assert_true(matches_pattern("", ""));
+            lib2::test::assert_false(matches_pattern("a", ""));
+            lib2::test::assert_true(matches_pattern("io_read", "io_read"));
+            lib2::test::assert_false(matches_pattern("io_read", "io_rea"));
+
+            // ? matches exactly one character
+            lib2::test::assert_true(matches_pattern("test", "t?st"));
+            lib2::test::assert_false(matches_pattern("tst", "t?st"));
+            lib2::test::assert_false(matches_pattern("teest", "t?st"));
+
+            // A trailing * matches anything, including nothing
+            lib2::test::assert_true(matches_pattern("io_", "io_*"));
+            lib2::test::assert_true(matches_pattern("io_read", "io_*"));
+            lib2::test::assert_true(matches_pattern("io_read", "io_**"));
+            lib2::test::assert_false(matches_pattern("io", "io_*"));
+            lib2::test::assert_true(matches_pattern("", "*"));
+
+            // The first place a * could end is not always the right one
+            lib2::test::assert_true(matches_pattern("abcbd", "a*bd"));
+            lib2::test::assert_true(matches_pattern("axxbyybzc", "a*b*c"));
+            lib2::test::assert_true(matches_pattern("fmt_format_fmt", "*fmt"));
+            lib2::test::assert_true(matches_pattern("aaab", "*a?b"));
+            lib2::test::assert_false(matches_pattern("abcbe", "a*bd"));
+            lib2::test::assert_false(matches_pattern("ab", "*a*b*c"));
+        }
+    };
+
+    export
+    class select_tests_test : public lib2::test::test_case
+    {
+    public:
+        select_tests_test()
+            : lib2::test::test_case{"select_tests"} {}
+
+        void operator()() final
+        {
+            std::vector<std::unique_ptr<func_test>> owned;
+            std::vector<lib2::test::test_case*> tests;
+            for (const auto name : {"io_read", "io_write", "fmt_int", "fmt_float", "fmt_string", "log_threads"})
+            {
+                tests.push_back(owned.emplace_back(std::make_unique<func_test>(name)).get());
+            }
+
+            using names = std::vector<std::string>;
+
+            lib2::test::assert_equal(names_of(lib2::test::select_tests(tests, {})), names_of(tests));
+
+            lib2::test::assert_equal(names_of(lib2::test::select_tests(tests, {.include = {"fmt_*", "log_*"}})),
+                names{"fmt_int", "fmt_float", "fmt_string", "log_threads"});
+
+            // Exclusions win over inclusions
+            lib2::test::assert_equal(names_of(lib2::test::select_tests(tests, {.include = {"fmt_*"}, .exclude = {"*_float"}})),
+                names{"fmt_int", "fmt_string"});
+            lib2::test::assert_equal(names_of(lib2::test::select_tests(tests, {.exclude = {"io_*", "*s"}})),
+                names{"fmt_int", "fmt_float", "fmt_string"});
+
+            // Shards deal out what is left after filtering in turn
+            const auto shard {[&](const std::size_t i) {
+                return names_of(lib2::test::select_tests(tests, {.exclude = {"log_*"}, .shard_index = i, .shard_count = 3}));
+            }};
+            lib2::test::assert_equal(shard(0), names{"io_read", "fmt_float"});
+            lib2::test::assert_equal(shard(1), names{"io_write", "fmt_string"});
+            lib2::test::assert_equal(shard(2), names{"fmt_int"});
+
+            lib2::test::assert_throws<std::invalid_argument>([&] {
+                [[maybe_unused]] const auto selected {lib2::test::select_tests(tests, {.shard_index = 2, .shard_count = 2})};
+            });
+            lib2::test::assert_throws<std::invalid_argument>([&] {
+                [[maybe_unused]] const auto selected {lib2::test::select_tests(tests, {.shard_count = 0})};
+            });
+        }
+    };
+
+    export
+    class run_tests_timeout_test : public lib2::test::test_case
+    {
+    public:
+        run_tests_timeout_test()
+            : lib2::test::test_case{"run_tests_timeout"} {}
+
+        void operator()() final
+        {
+            release = false;
+
+            const std::array<lib2::test::test_case*, 3> tests {&blocking, &quick, &failing};
+            const auto summary {lib2::test::run_tests(tests, {.num_threads = 2, .timeout = std::chrono::milliseconds{50}})};
+            release = true;
+
+            lib2::test::assert_equal(summary.runs.size(), tests.size());
+            lib2::test::assert_true(summary.runs[0].timed_out);
+            lib2::test::assert_true(summary.runs[0].duration >= std::chrono::milliseconds{50});
+            lib2::test::assert_true(summary.runs[1].passed());
+            lib2::test::assert_false(summary.runs[2].timed_out);
+            lib2::test::assert_false(summary.runs[2].passed());
+            lib2::test::assert_equal(summary.num_timed_out(), std::size_t{1});
+            lib2::test::assert_equal(summary.num_failed(), std::size_t{2});
+        }
+    private:
+        // Members, as the abandoned thread may still be in the blocking
+        // test after run_tests returns
+        std::atomic<bool> release {false};
+
+        func_test blocking {"blocking", [this] {
+            while (!release)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+        }};
+        func_test quick {"quick"};
+        func_test failing {"failing", [] { lib2::test::fail("on purpose"); }};
+    };
+}
\ No newline at end of file